@@ -0,0 +1,92 @@
+//*****************************************************************************
+//
+// angle.c - Routines for computing with the angles of the arc primitives.
+//
+//*****************************************************************************
+
+#include "debug.h"
+#include "grlib.h"
+
+//*****************************************************************************
+//
+//! \addtogroup primitives_api
+//! @{
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// The sine of the first quarter of a turn, in 64 steps, in units of
+// GR_SIN_ONE.
+//
+//*****************************************************************************
+static const unsigned short g_pusSinTable[65] =
+{
+        0,   804,  1608,  2411,  3212,  4011,  4808,  5602,
+     6393,  7180,  7962,  8740,  9512, 10279, 11039, 11793,
+    12540, 13279, 14010, 14733, 15447, 16151, 16846, 17531,
+    18205, 18868, 19520, 20160, 20788, 21403, 22006, 22595,
+    23170, 23732, 24279, 24812, 25330, 25833, 26320, 26791,
+    27246, 27684, 28106, 28511, 28899, 29269, 29622, 29957,
+    30274, 30572, 30853, 31114, 31357, 31581, 31786, 31972,
+    32138, 32286, 32413, 32522, 32610, 32679, 32729, 32758,
+    32768
+};
+
+//*****************************************************************************
+//
+//! Computes the sine of an angle.
+//!
+//! \param lAngle is the angle, in units of GR_ANGLE_360 to the turn.  Any
+//! number of turns may be added to it.
+//!
+//! This function computes the sine of an angle from a table of the first
+//! quarter of a turn, interpolating between its entries.  Since the angles
+//! grow clockwise on the screen, where the Y axis points down, the point at a
+//! distance \e r and an angle \e a from a center is at (\e r * GrAngleCos(\e a),
+//! \e r * GrAngleSin(\e a)) from it, divided by GR_SIN_ONE.
+//!
+//! \return Returns the sine of the angle, in units of GR_SIN_ONE.
+//
+//*****************************************************************************
+long
+GrAngleSin(long lAngle)
+{
+    unsigned long ulAngle, ulIdx, ulFrac;
+    long lSin;
+
+    //
+    // Reduce the angle to the first quarter of the turn.
+    //
+    ulAngle = (unsigned long)lAngle & (GR_ANGLE_90 - 1);
+
+    if((unsigned long)lAngle & GR_ANGLE_90)
+    {
+        ulAngle = GR_ANGLE_90 - ulAngle;
+    }
+
+    //
+    // Interpolate between the two entries of the table around the angle.
+    //
+    ulIdx = ulAngle >> 8;
+    ulFrac = ulAngle & 0xff;
+
+    lSin = g_pusSinTable[ulIdx];
+
+    if(ulFrac)
+    {
+        lSin += ((g_pusSinTable[ulIdx + 1] - lSin) * (long)ulFrac) >> 8;
+    }
+
+    //
+    // The sine is negative in the second half of the turn.
+    //
+    return(((unsigned long)lAngle & GR_ANGLE_180) ? -lSin : lSin);
+}
+
+//*****************************************************************************
+//
+// Close the Doxygen group.
+//! @}
+//
+//*****************************************************************************
@@ -0,0 +1,547 @@
+//*****************************************************************************
+//
+// antialias.c - Routines for drawing anti-aliased lines, circles and arcs.
+//
+//*****************************************************************************
+
+#include "debug.h"
+#include "grlib.h"
+
+//*****************************************************************************
+//
+//! \addtogroup primitives_api
+//! @{
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// This structure holds the sector an anti-aliased arc is restricted to.
+//
+//*****************************************************************************
+typedef struct
+{
+    //
+    // The cosine and sine of the start angle and of the end angle.
+    //
+    long lStartCos;
+    long lStartSin;
+    long lEndCos;
+    long lEndSin;
+
+    //
+    // Non-zero if the sector is wider than half a turn.
+    //
+    long lWide;
+}
+tAASector;
+
+//*****************************************************************************
+//
+//! Blends the foreground color into a pixel.
+//!
+//! \param pContext is a pointer to the drawing context to use.
+//! \param lX is the X coordinate of the pixel.
+//! \param lY is the Y coordinate of the pixel.
+//! \param ulAlpha is the coverage of the pixel, from 0 to
+//! \b #GR_ALPHA_OPAQUE.
+//!
+//! This function blends the foreground color into a pixel within the clipping
+//! region, with the blend function of the display if it has one, or else by
+//! reading the pixel back and drawing the blended color.  A display that can
+//! do neither, or a context whose 24-bit RGB foreground color is unknown, gets
+//! the pixel drawn when it is at least half covered.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrAAPixelDraw(const tContext *pContext, long lX, long lY,
+              unsigned long ulAlpha)
+{
+    unsigned long ulPixel, ulBlend;
+    long lShift;
+
+    if((lX < pContext->sClipRegion.sXMin) ||
+       (lX > pContext->sClipRegion.sXMax) ||
+       (lY < pContext->sClipRegion.sYMin) ||
+       (lY > pContext->sClipRegion.sYMax) || !ulAlpha)
+    {
+        return;
+    }
+
+    //
+    // The foreground color must have been set with GrContextForegroundSet()
+    // to be blended.
+    //
+    ASSERT(pContext->ulForegroundRGB != GR_RGB_UNKNOWN);
+
+    if((ulAlpha >= GR_ALPHA_OPAQUE) ||
+       (pContext->ulForegroundRGB == GR_RGB_UNKNOWN))
+    {
+        if(ulAlpha > (GR_ALPHA_OPAQUE / 2))
+        {
+            DpyPixelDraw(pContext->pDisplay, lX, lY, pContext->ulForeground);
+        }
+    }
+    else if(pContext->pDisplay->pfnPixelBlend)
+    {
+        DpyPixelBlend(pContext->pDisplay, lX, lY, pContext->ulForegroundRGB,
+                      ulAlpha);
+    }
+    else if(pContext->pDisplay->pfnPixelRead)
+    {
+        ulPixel = DpyPixelRead(pContext->pDisplay, lX, lY);
+        ulBlend = 0;
+
+        for(lShift = ClrRedShift; lShift >= 0; lShift -= 8)
+        {
+            ulBlend |= (((((pContext->ulForegroundRGB >> lShift) & 0xff) *
+                          ulAlpha) +
+                         (((ulPixel >> lShift) & 0xff) *
+                          (GR_ALPHA_OPAQUE - ulAlpha)) +
+                         (GR_ALPHA_OPAQUE / 2)) / GR_ALPHA_OPAQUE) << lShift;
+        }
+
+        DpyPixelDraw(pContext->pDisplay, lX, lY,
+                     DpyColorTranslate(pContext->pDisplay, ulBlend));
+    }
+    else if(ulAlpha > (GR_ALPHA_OPAQUE / 2))
+    {
+        DpyPixelDraw(pContext->pDisplay, lX, lY, pContext->ulForeground);
+    }
+}
+
+//*****************************************************************************
+//
+//! Draws an anti-aliased line.
+//!
+//! \param pContext is a pointer to the drawing context to use.
+//! \param lX1 is the X coordinate of the start of the line.
+//! \param lY1 is the Y coordinate of the start of the line.
+//! \param lX2 is the X coordinate of the end of the line.
+//! \param lY2 is the Y coordinate of the end of the line.
+//!
+//! This function draws a line with Wu's algorithm: at each step along its
+//! major axis, the line covers two pixels across its minor axis, and the
+//! foreground color is blended into each of them in proportion to how close
+//! the line passes to it.  Horizontal, vertical and diagonal lines cover
+//! their pixels fully, and are drawn as with GrLineDraw().
+//!
+//! The foreground color must have been set with GrContextForegroundSet(),
+//! since a color set with GrContextForegroundSetTranslated() cannot be
+//! blended.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+GrLineDrawAA(const tContext *pContext, long lX1, long lY1, long lX2,
+             long lY2)
+{
+    unsigned long ulErrorAcc, ulErrorPrev, ulErrorAdj, ulWeight;
+    long lDeltaX, lDeltaY, lXDir, lTemp;
+
+    //
+    // Check the arguments.
+    //
+    ASSERT(pContext);
+
+    //
+    // Lines that cover their pixels fully need no blending.
+    //
+    lDeltaX = (lX2 > lX1) ? (lX2 - lX1) : (lX1 - lX2);
+    lDeltaY = (lY2 > lY1) ? (lY2 - lY1) : (lY1 - lY2);
+
+    if(!lDeltaX || !lDeltaY || (lDeltaX == lDeltaY))
+    {
+        GrLineDraw(pContext, lX1, lY1, lX2, lY2);
+        return;
+    }
+
+    //
+    // Return without drawing anything if the line, with the pixels next to
+    // it, is entirely out of the clipping region.
+    //
+    if((((lX1 < lX2) ? lX1 : lX2) - 1 > pContext->sClipRegion.sXMax) ||
+       (((lX1 > lX2) ? lX1 : lX2) + 1 < pContext->sClipRegion.sXMin) ||
+       (((lY1 < lY2) ? lY1 : lY2) - 1 > pContext->sClipRegion.sYMax) ||
+       (((lY1 > lY2) ? lY1 : lY2) + 1 < pContext->sClipRegion.sYMin))
+    {
+        return;
+    }
+
+    //
+    // Draw the line from top to bottom.
+    //
+    if(lY1 > lY2)
+    {
+        lTemp = lX1;
+        lX1 = lX2;
+        lX2 = lTemp;
+        lTemp = lY1;
+        lY1 = lY2;
+        lY2 = lTemp;
+    }
+
+    lXDir = (lX2 > lX1) ? 1 : -1;
+
+    //
+    // The end points are on the line, and fully covered.
+    //
+    GrAAPixelDraw(pContext, lX1, lY1, GR_ALPHA_OPAQUE);
+    GrAAPixelDraw(pContext, lX2, lY2, GR_ALPHA_OPAQUE);
+
+    //
+    // The error accumulator holds the distance, in 1/65536th of a pixel,
+    // between the line and the pixel last stepped to across the minor axis.
+    // When it wraps around, the line has moved on to the next pixel.
+    //
+    ulErrorAcc = 0;
+
+    if(lDeltaY > lDeltaX)
+    {
+        //
+        // The line is Y-major: step one row at a time, and cover the pixel
+        // the line is in and the one after it across the row.
+        //
+        ulErrorAdj = ((unsigned long)lDeltaX << 16) / lDeltaY;
+
+        while(--lDeltaY)
+        {
+            ulErrorPrev = ulErrorAcc;
+            ulErrorAcc = (ulErrorAcc + ulErrorAdj) & 0xffff;
+
+            if(ulErrorAcc <= ulErrorPrev)
+            {
+                lX1 += lXDir;
+            }
+
+            lY1++;
+
+            ulWeight = ulErrorAcc >> 8;
+            GrAAPixelDraw(pContext, lX1, lY1, GR_ALPHA_OPAQUE - ulWeight);
+            GrAAPixelDraw(pContext, lX1 + lXDir, lY1, ulWeight);
+        }
+    }
+    else
+    {
+        //
+        // The line is X-major: step one column at a time, and cover the pixel
+        // the line is in and the one below it.
+        //
+        ulErrorAdj = ((unsigned long)lDeltaY << 16) / lDeltaX;
+
+        while(--lDeltaX)
+        {
+            ulErrorPrev = ulErrorAcc;
+            ulErrorAcc = (ulErrorAcc + ulErrorAdj) & 0xffff;
+
+            if(ulErrorAcc <= ulErrorPrev)
+            {
+                lY1++;
+            }
+
+            lX1 += lXDir;
+
+            ulWeight = ulErrorAcc >> 8;
+            GrAAPixelDraw(pContext, lX1, lY1, GR_ALPHA_OPAQUE - ulWeight);
+            GrAAPixelDraw(pContext, lX1, lY1 + 1, ulWeight);
+        }
+    }
+}
+
+//*****************************************************************************
+//
+//! Draws a pixel of an anti-aliased circle, in each octant.
+//!
+//! \param pContext is a pointer to the drawing context to use.
+//! \param lX is the X coordinate of the center of the circle.
+//! \param lY is the Y coordinate of the center of the circle.
+//! \param lA is the offset of the pixel along the minor axis of the octant.
+//! \param lB is the offset of the pixel along the major axis of the octant.
+//! \param ulAlpha is the coverage of the pixel.
+//! \param psSector is a pointer to the sector the pixels are restricted to, or
+//! zero for the whole circle.
+//!
+//! This function blends the pixel at the given offsets from the center, and
+//! its mirror images in the other octants, each only once when some of them
+//! are the same pixel.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrAACirclePixelsDraw(const tContext *pContext, long lX, long lY, long lA,
+                     long lB, unsigned long ulAlpha,
+                     const tAASector *psSector)
+{
+    long plDX[8], plDY[8];
+    long lIdx, lCount, lStart, lEnd, lTemp;
+
+    //
+    // List the distinct mirror images of the pixel.
+    //
+    lCount = 0;
+
+    for(lIdx = 0; lIdx < 2; lIdx++)
+    {
+        plDX[lCount] = lA;
+        plDY[lCount++] = lB;
+
+        if(lB)
+        {
+            plDX[lCount] = lA;
+            plDY[lCount++] = -lB;
+        }
+
+        if(lA)
+        {
+            plDX[lCount] = -lA;
+            plDY[lCount++] = lB;
+
+            if(lB)
+            {
+                plDX[lCount] = -lA;
+                plDY[lCount++] = -lB;
+            }
+        }
+
+        if(lA == lB)
+        {
+            break;
+        }
+
+        lTemp = lA;
+        lA = lB;
+        lB = lTemp;
+    }
+
+    for(lIdx = 0; lIdx < lCount; lIdx++)
+    {
+        //
+        // Skip the pixels out of the sector.  A pixel is clockwise from the
+        // start of the sector when the cross product of their directions is
+        // positive, and likewise for the end of the sector and the pixel.
+        //
+        if(psSector)
+        {
+            lStart = (psSector->lStartCos * plDY[lIdx] -
+                      psSector->lStartSin * plDX[lIdx]) >= 0;
+            lEnd = (plDX[lIdx] * psSector->lEndSin -
+                    plDY[lIdx] * psSector->lEndCos) >= 0;
+
+            if(psSector->lWide ? !(lStart || lEnd) : !(lStart && lEnd))
+            {
+                continue;
+            }
+        }
+
+        GrAAPixelDraw(pContext, lX + plDX[lIdx], lY + plDY[lIdx], ulAlpha);
+    }
+}
+
+//*****************************************************************************
+//
+//! Computes an integer square root.
+//!
+//! \param ulValue is the value to compute the square root of.
+//!
+//! \return Returns the largest integer whose square is at most \e ulValue.
+//
+//*****************************************************************************
+static unsigned long
+GrAASqrt(unsigned long ulValue)
+{
+    unsigned long ulRoot, ulBit;
+
+    //
+    // Find the highest power of four not above the value, then compute the
+    // root one bit at a time.
+    //
+    for(ulBit = 1UL << 30; ulBit > ulValue; ulBit >>= 2)
+    {
+    }
+
+    for(ulRoot = 0; ulBit; ulBit >>= 2)
+    {
+        if(ulValue >= ulRoot + ulBit)
+        {
+            ulValue -= ulRoot + ulBit;
+            ulRoot = (ulRoot >> 1) + ulBit;
+        }
+        else
+        {
+            ulRoot >>= 1;
+        }
+    }
+
+    return(ulRoot);
+}
+
+//*****************************************************************************
+//
+//! Draws an anti-aliased circle, or a sector of it.
+//!
+//! \param pContext is a pointer to the drawing context to use.
+//! \param lX is the X coordinate of the center of the circle.
+//! \param lY is the Y coordinate of the center of the circle.
+//! \param lRadius is the radius of the circle.
+//! \param psSector is a pointer to the sector to draw, or zero for the whole
+//! circle.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrAACircleDraw(const tContext *pContext, long lX, long lY, long lRadius,
+               const tAASector *psSector)
+{
+    unsigned long ulSquare, ulRoot, ulWeight;
+    long lA;
+
+    //
+    // Return without drawing anything if the circle, with the pixels next to
+    // it, is entirely out of the clipping region.
+    //
+    if((lX - lRadius - 1 > pContext->sClipRegion.sXMax) ||
+       (lX + lRadius + 1 < pContext->sClipRegion.sXMin) ||
+       (lY - lRadius - 1 > pContext->sClipRegion.sYMax) ||
+       (lY + lRadius + 1 < pContext->sClipRegion.sYMin))
+    {
+        return;
+    }
+
+    if(lRadius <= 0)
+    {
+        GrAACirclePixelsDraw(pContext, lX, lY, 0, 0, GR_ALPHA_OPAQUE,
+                             psSector);
+        return;
+    }
+
+    //
+    // Walk along the first octant, from the top of the circle until the
+    // diagonal.  At each column, the circle passes between the two pixels
+    // around the integer square root of the radius squared minus the column
+    // squared, and covers each of them in proportion to how close it passes.
+    //
+    for(lA = 0; ; lA++)
+    {
+        ulSquare = (lRadius * lRadius) - (lA * lA);
+
+        ulRoot = GrAASqrt(ulSquare);
+
+        if(lA > (long)ulRoot)
+        {
+            break;
+        }
+
+        //
+        // The fraction of a pixel the circle passes beyond the root.
+        //
+        ulWeight = ((ulSquare - (ulRoot * ulRoot)) << 8) / ((ulRoot << 1) + 1);
+
+        GrAACirclePixelsDraw(pContext, lX, lY, lA, ulRoot,
+                             GR_ALPHA_OPAQUE - ulWeight, psSector);
+        GrAACirclePixelsDraw(pContext, lX, lY, lA, ulRoot + 1, ulWeight,
+                             psSector);
+    }
+}
+
+//*****************************************************************************
+//
+//! Draws an anti-aliased circle.
+//!
+//! \param pContext is a pointer to the drawing context to use.
+//! \param lX is the X coordinate of the center of the circle.
+//! \param lY is the Y coordinate of the center of the circle.
+//! \param lRadius is the radius of the circle.
+//!
+//! This function draws a circle with Wu's algorithm: at each step along an
+//! octant, the circle covers two pixels across it, and the foreground color
+//! is blended into each of them in proportion to how close the circle passes
+//! to it.  The extent of the circle is the same as with GrCircleDraw(), plus
+//! one pixel on each side.
+//!
+//! The foreground color must have been set with GrContextForegroundSet(),
+//! since a color set with GrContextForegroundSetTranslated() cannot be
+//! blended.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+GrCircleDrawAA(const tContext *pContext, long lX, long lY, long lRadius)
+{
+    //
+    // Check the arguments.
+    //
+    ASSERT(pContext);
+
+    GrAACircleDraw(pContext, lX, lY, lRadius, 0);
+}
+
+//*****************************************************************************
+//
+//! Draws an anti-aliased arc.
+//!
+//! \param pContext is a pointer to the drawing context to use.
+//! \param lX is the X coordinate of the center of the arc.
+//! \param lY is the Y coordinate of the center of the arc.
+//! \param lRadius is the radius of the arc.
+//! \param lStartAngle is the angle the arc starts at.
+//! \param lEndAngle is the angle the arc ends at.
+//!
+//! This function draws the part of the circle drawn by GrCircleDrawAA() that
+//! goes clockwise from \e lStartAngle to \e lEndAngle.  The angles are in
+//! units of \b #GR_ANGLE_360 to the turn, from the right of the center (see
+//! GrAngleFromDegrees()); the arc is the whole circle if \e lEndAngle is a
+//! turn or more after \e lStartAngle.
+//!
+//! The foreground color must have been set with GrContextForegroundSet(),
+//! since a color set with GrContextForegroundSetTranslated() cannot be
+//! blended.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+GrArcDrawAA(const tContext *pContext, long lX, long lY, long lRadius,
+            long lStartAngle, long lEndAngle)
+{
+    tAASector sSector;
+    long lSweep;
+
+    //
+    // Check the arguments.
+    //
+    ASSERT(pContext);
+
+    if(lEndAngle - lStartAngle >= GR_ANGLE_360)
+    {
+        GrAACircleDraw(pContext, lX, lY, lRadius, 0);
+        return;
+    }
+
+    lSweep = (lEndAngle - lStartAngle) & (GR_ANGLE_360 - 1);
+
+    if(!lSweep)
+    {
+        return;
+    }
+
+    sSector.lStartCos = GrAngleCos(lStartAngle);
+    sSector.lStartSin = GrAngleSin(lStartAngle);
+    sSector.lEndCos = GrAngleCos(lEndAngle);
+    sSector.lEndSin = GrAngleSin(lEndAngle);
+    sSector.lWide = lSweep > GR_ANGLE_180;
+
+    GrAACircleDraw(pContext, lX, lY, lRadius, &sSector);
+}
+
+//*****************************************************************************
+//
+// Close the Doxygen group.
+//! @}
+//
+//*****************************************************************************
@@ -0,0 +1,488 @@
+//*****************************************************************************
+//
+// arc.c - Routines for drawing arcs, pie slices and rings.
+//
+//*****************************************************************************
+
+#include "debug.h"
+#include "grlib.h"
+
+//*****************************************************************************
+//
+//! \addtogroup primitives_api
+//! @{
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// This structure holds the sector an arc, a pie slice or a ring is restricted
+// to.  A pixel is within the sector when it is clockwise from its start and
+// counterclockwise from its end, or, for a sector wider than half a turn,
+// either of the two.
+//
+//*****************************************************************************
+typedef struct
+{
+    //
+    // The cosine and sine of the start angle and of the end angle.
+    //
+    long lStartCos;
+    long lStartSin;
+    long lEndCos;
+    long lEndSin;
+
+    //
+    // Non-zero if the sector is wider than half a turn.
+    //
+    long lWide;
+
+    //
+    // Non-zero if the sector is the whole turn.
+    //
+    long lFull;
+}
+tArcSector;
+
+//*****************************************************************************
+//
+//! Divides two integers, rounding the quotient down.
+//!
+//! \param lNum is the dividend.
+//! \param lDen is the divisor, which must be positive.
+//!
+//! \return Returns the largest integer not above \e lNum / \e lDen.
+//
+//*****************************************************************************
+static long
+GrArcDivFloor(long lNum, long lDen)
+{
+    long lQuot;
+
+    lQuot = lNum / lDen;
+
+    if((lNum % lDen) && (lNum < 0))
+    {
+        lQuot--;
+    }
+
+    return(lQuot);
+}
+
+//*****************************************************************************
+//
+//! Restricts a row to the side of a line through the center.
+//!
+//! \param lA is the factor of the X offset from the center.
+//! \param lB is the constant term.
+//! \param lLimit is the largest X offset of the row that can be drawn.
+//! \param plLow is a pointer to the smallest X offset of the row.
+//! \param plHigh is a pointer to the largest X offset of the row.
+//!
+//! This function finds the pixels of the row whose X offset \e dx from the
+//! center satisfies \e lA * \e dx + \e lB >= 0, which is a half-line.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrArcHalfPlaneGet(long lA, long lB, long lLimit, long *plLow, long *plHigh)
+{
+    *plLow = -lLimit;
+    *plHigh = lLimit;
+
+    if(lA > 0)
+    {
+        *plLow = -GrArcDivFloor(lB, lA);
+    }
+    else if(lA < 0)
+    {
+        *plHigh = GrArcDivFloor(lB, -lA);
+    }
+    else if(lB < 0)
+    {
+        *plLow = lLimit + 1;
+    }
+}
+
+//*****************************************************************************
+//
+//! Sets up the sector of an arc.
+//!
+//! \param psSector is a pointer to the sector.
+//! \param lStartAngle is the angle the sector starts at.
+//! \param lEndAngle is the angle the sector ends at.
+//!
+//! \return Returns zero if the sector is empty, and non-zero otherwise.
+//
+//*****************************************************************************
+static long
+GrArcSectorInit(tArcSector *psSector, long lStartAngle, long lEndAngle)
+{
+    long lSweep;
+
+    lSweep = (lEndAngle - lStartAngle) & (GR_ANGLE_360 - 1);
+
+    psSector->lStartCos = GrAngleCos(lStartAngle);
+    psSector->lStartSin = GrAngleSin(lStartAngle);
+    psSector->lEndCos = GrAngleCos(lEndAngle);
+    psSector->lEndSin = GrAngleSin(lEndAngle);
+    psSector->lWide = lSweep > GR_ANGLE_180;
+    psSector->lFull = (lEndAngle - lStartAngle) >= GR_ANGLE_360;
+
+    return(psSector->lFull || lSweep);
+}
+
+//*****************************************************************************
+//
+//! Finds the pixels of a row within a sector.
+//!
+//! \param psSector is a pointer to the sector.
+//! \param lDY is the Y offset of the row from the center.
+//! \param lLimit is the largest X offset of the row that can be drawn.
+//! \param plSpans is a pointer to the array that receives the smallest and
+//! the largest X offset of each run of pixels within the sector, from left to
+//! right.
+//!
+//! A pixel is clockwise from the start of the sector when the cross product
+//! of their directions is positive, and likewise for the end of the sector
+//! and the pixel.  Along a row, each of these conditions holds on a
+//! half-line, so the pixels within the sector form at most two runs.
+//!
+//! \return Returns the number of runs, from zero to two.
+//
+//*****************************************************************************
+static long
+GrArcSectorSpansGet(const tArcSector *psSector, long lDY, long lLimit,
+                    long *plSpans)
+{
+    long lLow1, lHigh1, lLow2, lHigh2, lTemp;
+
+    if(psSector->lFull)
+    {
+        plSpans[0] = -lLimit;
+        plSpans[1] = lLimit;
+        return(1);
+    }
+
+    GrArcHalfPlaneGet(-psSector->lStartSin, psSector->lStartCos * lDY, lLimit,
+                      &lLow1, &lHigh1);
+    GrArcHalfPlaneGet(psSector->lEndSin, -psSector->lEndCos * lDY, lLimit,
+                      &lLow2, &lHigh2);
+
+    //
+    // A sector up to half a turn wide is within both half-lines.
+    //
+    if(!psSector->lWide)
+    {
+        plSpans[0] = (lLow1 > lLow2) ? lLow1 : lLow2;
+        plSpans[1] = (lHigh1 < lHigh2) ? lHigh1 : lHigh2;
+
+        return(plSpans[0] <= plSpans[1]);
+    }
+
+    //
+    // A wider sector is within either of them.  Drop the empty ones, and
+    // merge them if they overlap.
+    //
+    if(lLow1 > lHigh1)
+    {
+        lLow1 = lLow2;
+        lHigh1 = lHigh2;
+        lLow2 = 1;
+        lHigh2 = 0;
+    }
+    else if((lLow2 <= lHigh2) && (lLow2 < lLow1))
+    {
+        lTemp = lLow1;
+        lLow1 = lLow2;
+        lLow2 = lTemp;
+        lTemp = lHigh1;
+        lHigh1 = lHigh2;
+        lHigh2 = lTemp;
+    }
+
+    if(lLow1 > lHigh1)
+    {
+        return(0);
+    }
+
+    plSpans[0] = lLow1;
+    plSpans[1] = lHigh1;
+
+    if(lLow2 > lHigh2)
+    {
+        return(1);
+    }
+
+    if(lLow2 <= (lHigh1 + 1))
+    {
+        plSpans[1] = (lHigh1 > lHigh2) ? lHigh1 : lHigh2;
+        return(1);
+    }
+
+    plSpans[2] = lLow2;
+    plSpans[3] = lHigh2;
+
+    return(2);
+}
+
+//*****************************************************************************
+//
+//! Fills a sector of a ring.
+//!
+//! \param pContext is a pointer to the drawing context to use.
+//! \param lX is the X coordinate of the center.
+//! \param lY is the Y coordinate of the center.
+//! \param lInner is the inner radius, or zero for none.
+//! \param lOuter is the outer radius.
+//! \param lStartAngle is the angle the sector starts at.
+//! \param lEndAngle is the angle the sector ends at.
+//!
+//! This function fills the pixels within the sector whose distance \e d from
+//! the center is within half a pixel of the radii: \e lInner - 1/2 <= \e d <=
+//! \e lOuter + 1/2.  Each row is drawn with at most two horizontal lines on
+//! each side of the hole.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrArcRingFill(const tContext *pContext, long lX, long lY, long lInner,
+              long lOuter, long lStartAngle, long lEndAngle)
+{
+    long lInnerSq, lOuterSq, lDY, lYMax, lIn, lOut, lSpans, lRing, lIdx;
+    long plRing[4], plSpans[4], lX1, lX2;
+    tArcSector sSector;
+
+    //
+    // Return without drawing anything if the sector is empty, or if the ring
+    // is entirely out of the clipping region.
+    //
+    if((lOuter < 0) || (lInner > lOuter) ||
+       !GrArcSectorInit(&sSector, lStartAngle, lEndAngle) ||
+       (lX - lOuter > pContext->sClipRegion.sXMax) ||
+       (lX + lOuter < pContext->sClipRegion.sXMin) ||
+       (lY - lOuter > pContext->sClipRegion.sYMax) ||
+       (lY + lOuter < pContext->sClipRegion.sYMin))
+    {
+        return;
+    }
+
+    //
+    // The squared distances from the center, in whole pixels, that are within
+    // half a pixel of the radii.
+    //
+    lOuterSq = (lOuter * lOuter) + lOuter;
+    lInnerSq = lInner ? ((lInner * lInner) - lInner + 1) : 0;
+
+    //
+    // Only the rows within the clipping region are drawn.
+    //
+    lDY = pContext->sClipRegion.sYMin - lY;
+    if(lDY < -lOuter)
+    {
+        lDY = -lOuter;
+    }
+
+    lYMax = pContext->sClipRegion.sYMax - lY;
+    if(lYMax > lOuter)
+    {
+        lYMax = lOuter;
+    }
+
+    //
+    // The half widths of the outer disc and of the hole change by small steps
+    // from one row to the next, so they are followed rather than computed.
+    //
+    lOut = 0;
+    lIn = lInner;
+
+    for(; lDY <= lYMax; lDY++)
+    {
+        while(((lOut + 1) * (lOut + 1)) + (lDY * lDY) <= lOuterSq)
+        {
+            lOut++;
+        }
+        while((lOut > 0) && ((lOut * lOut) + (lDY * lDY) > lOuterSq))
+        {
+            lOut--;
+        }
+
+        while((lIn > 0) && (((lIn - 1) * (lIn - 1)) + (lDY * lDY) >= lInnerSq))
+        {
+            lIn--;
+        }
+        while(((lIn * lIn) + (lDY * lDY)) < lInnerSq)
+        {
+            lIn++;
+        }
+
+        if(lIn > lOut)
+        {
+            continue;
+        }
+
+        //
+        // Find the runs of the row on either side of the hole, if any.
+        //
+        if(lIn)
+        {
+            plRing[0] = -lOut;
+            plRing[1] = -lIn;
+            plRing[2] = lIn;
+            plRing[3] = lOut;
+            lRing = 2;
+        }
+        else
+        {
+            plRing[0] = -lOut;
+            plRing[1] = lOut;
+            lRing = 1;
+        }
+
+        lSpans = GrArcSectorSpansGet(&sSector, lDY, lOut, plSpans);
+
+        //
+        // Draw the parts of the runs within the sector and the clipping
+        // region.
+        //
+        for(lRing--; lRing >= 0; lRing--)
+        {
+            for(lIdx = 0; lIdx < lSpans; lIdx++)
+            {
+                lX1 = (plRing[lRing * 2] > plSpans[lIdx * 2]) ?
+                      plRing[lRing * 2] : plSpans[lIdx * 2];
+                lX2 = (plRing[(lRing * 2) + 1] < plSpans[(lIdx * 2) + 1]) ?
+                      plRing[(lRing * 2) + 1] : plSpans[(lIdx * 2) + 1];
+
+                lX1 += lX;
+                lX2 += lX;
+
+                if(lX1 < pContext->sClipRegion.sXMin)
+                {
+                    lX1 = pContext->sClipRegion.sXMin;
+                }
+                if(lX2 > pContext->sClipRegion.sXMax)
+                {
+                    lX2 = pContext->sClipRegion.sXMax;
+                }
+
+                if(lX1 <= lX2)
+                {
+                    DpyLineDrawH(pContext->pDisplay, lX1, lX2, lY + lDY,
+                                 pContext->ulForeground);
+                }
+            }
+        }
+    }
+}
+
+//*****************************************************************************
+//
+//! Draws an arc.
+//!
+//! \param pContext is a pointer to the drawing context to use.
+//! \param lX is the X coordinate of the center of the arc.
+//! \param lY is the Y coordinate of the center of the arc.
+//! \param lRadius is the radius of the arc.
+//! \param lStartAngle is the angle the arc starts at.
+//! \param lEndAngle is the angle the arc ends at.
+//!
+//! This function draws the part of a circle of the given radius that goes
+//! clockwise from \e lStartAngle to \e lEndAngle, one pixel wide.  The angles
+//! are in units of \b #GR_ANGLE_360 to the turn, from the right of the center
+//! (see GrAngleFromDegrees()); the arc is the whole circle if \e lEndAngle is
+//! a turn or more after \e lStartAngle.
+//!
+//! The arc is drawn with horizontal lines, and clipped to the clipping region
+//! of the context.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+GrArcDraw(const tContext *pContext, long lX, long lY, long lRadius,
+          long lStartAngle, long lEndAngle)
+{
+    //
+    // Check the arguments.
+    //
+    ASSERT(pContext);
+
+    GrArcRingFill(pContext, lX, lY, lRadius, lRadius, lStartAngle, lEndAngle);
+}
+
+//*****************************************************************************
+//
+//! Draws a filled pie slice.
+//!
+//! \param pContext is a pointer to the drawing context to use.
+//! \param lX is the X coordinate of the center of the pie.
+//! \param lY is the Y coordinate of the center of the pie.
+//! \param lRadius is the radius of the pie.
+//! \param lStartAngle is the angle the slice starts at.
+//! \param lEndAngle is the angle the slice ends at.
+//!
+//! This function fills the sector of a disc of the given radius that goes
+//! clockwise from \e lStartAngle to \e lEndAngle; the angles are as with
+//! GrArcDraw().  Repainting the sector swept by a moving needle, rather than
+//! the whole dial, only needs the slice between its old and new angles.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+GrPieFill(const tContext *pContext, long lX, long lY, long lRadius,
+          long lStartAngle, long lEndAngle)
+{
+    //
+    // Check the arguments.
+    //
+    ASSERT(pContext);
+
+    GrArcRingFill(pContext, lX, lY, 0, lRadius, lStartAngle, lEndAngle);
+}
+
+//*****************************************************************************
+//
+//! Draws a filled ring segment.
+//!
+//! \param pContext is a pointer to the drawing context to use.
+//! \param lX is the X coordinate of the center of the ring.
+//! \param lY is the Y coordinate of the center of the ring.
+//! \param lInnerRadius is the inner radius of the ring.
+//! \param lOuterRadius is the outer radius of the ring.
+//! \param lStartAngle is the angle the segment starts at.
+//! \param lEndAngle is the angle the segment ends at.
+//!
+//! This function fills the sector of a ring that goes clockwise from
+//! \e lStartAngle to \e lEndAngle; the angles are as with GrArcDraw().  The
+//! ring covers the arcs of every radius from \e lInnerRadius to
+//! \e lOuterRadius, inclusive, so a ring whose radii are equal is the arc
+//! drawn by GrArcDraw(), and a ring whose inner radius is zero is the slice
+//! filled by GrPieFill().
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+GrRingFill(const tContext *pContext, long lX, long lY, long lInnerRadius,
+           long lOuterRadius, long lStartAngle, long lEndAngle)
+{
+    //
+    // Check the arguments.
+    //
+    ASSERT(pContext);
+    ASSERT(lInnerRadius <= lOuterRadius);
+
+    GrArcRingFill(pContext, lX, lY, lInnerRadius, lOuterRadius, lStartAngle,
+                  lEndAngle);
+}
+
+//*****************************************************************************
+//
+// Close the Doxygen group.
+//! @}
+//
+//*****************************************************************************
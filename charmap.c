@@ -27,12 +27,25 @@
 #define NumLeadingZeros(x)      __CLZ(x)
 #endif
 #if defined(codered) || defined(gcc) || defined(sourcerygxx)
+#if defined(__arm__) || defined(__thumb__)
 #define NumLeadingZeros(x) __extension__                        \
         ({                                                      \
             register unsigned long __ret, __inp = x;            \
             __asm__("clz %0, %1" : "=r" (__ret) : "r" (__inp)); \
             __ret;                                              \
         })
+#else
+//
+// Host builds (see HOST in makedefs) have no "clz" instruction, so use the
+// compiler builtin.  The builtin is undefined for zero, whereas "clz" returns
+// 32, so that case is handled explicitly.
+//
+#define NumLeadingZeros(x) __extension__                        \
+        ({                                                      \
+            unsigned int __inp = (unsigned int)(x);             \
+            (unsigned long)(__inp ? __builtin_clz(__inp) : 32); \
+        })
+#endif
 #endif
 #if defined(rvmdk) || defined(__ARMCC_VERSION)
 #define NumLeadingZeros(x)      __clz(x)
@@ -1,6 +1,6 @@
 //*****************************************************************************
 //
-// circle.c - Routines for drawing circles.
+// circle.c - Routines for drawing circles, ellipses and rounded rectangles.
 //
 //*****************************************************************************
 
@@ -280,256 +280,344 @@ GrCircleDraw(const tContext *pContext, long lX, long lY, long lRadius)
 
 //*****************************************************************************
 //
-//! Draws a filled circle.
+//! Fills a band of rows with a horizontal span.
 //!
 //! \param pContext is a pointer to the drawing context to use.
-//! \param lX is the X coordinate of the center of the circle.
-//! \param lY is the Y coordinate of the center of the circle.
-//! \param lRadius is the radius of the circle.
+//! \param lX1 is the X coordinate of the start of the span.
+//! \param lX2 is the X coordinate of the end of the span.
+//! \param lY1 is the Y coordinate of the first row.
+//! \param lY2 is the Y coordinate of the last row.
 //!
-//! This function draws a filled circle, utilizing the Bresenham circle drawing
-//! algorithm.  The extent of the circle is from \e lX - \e lRadius to \e lX +
-//! \e lRadius and \e lY - \e lRadius to \e lY + \e lRadius, inclusive.
+//! This function fills the part of the band within the clipping region, with
+//! a single call to the display driver.
 //!
 //! \return None.
 //
 //*****************************************************************************
-void
-GrCircleFill(const tContext *pContext, long lX, long lY, long lRadius)
+static void
+GrRoundBandFill(const tContext *pContext, long lX1, long lX2, long lY1,
+                long lY2)
 {
-    long lA, lB, lD, lX1, lX2, lY1;
+    tRectangle sRect;
 
     //
-    // Check the arguments.
+    // Clip the band.
     //
-    ASSERT(pContext);
+    if(lX1 < pContext->sClipRegion.sXMin)
+    {
+        lX1 = pContext->sClipRegion.sXMin;
+    }
+    if(lX2 > pContext->sClipRegion.sXMax)
+    {
+        lX2 = pContext->sClipRegion.sXMax;
+    }
+    if(lY1 < pContext->sClipRegion.sYMin)
+    {
+        lY1 = pContext->sClipRegion.sYMin;
+    }
+    if(lY2 > pContext->sClipRegion.sYMax)
+    {
+        lY2 = pContext->sClipRegion.sYMax;
+    }
+
+    if((lX1 > lX2) || (lY1 > lY2))
+    {
+        return;
+    }
+
+    if(lY1 == lY2)
+    {
+        DpyLineDrawH(pContext->pDisplay, lX1, lX2, lY1,
+                     pContext->ulForeground);
+    }
+    else
+    {
+        sRect.sXMin = lX1;
+        sRect.sYMin = lY1;
+        sRect.sXMax = lX2;
+        sRect.sYMax = lY2;
+        DpyRectFill(pContext->pDisplay, &sRect, pContext->ulForeground);
+    }
+}
+
+//*****************************************************************************
+//
+//! Fills a rectangle with rounded corners.
+//!
+//! \param pContext is a pointer to the drawing context to use.
+//! \param lX1 is the X coordinate of the centers of the left corners.
+//! \param lY1 is the Y coordinate of the centers of the top corners.
+//! \param lX2 is the X coordinate of the centers of the right corners.
+//! \param lY2 is the Y coordinate of the centers of the bottom corners.
+//! \param lRadiusX is the horizontal radius of the corners.
+//! \param lRadiusY is the vertical radius of the corners.
+//!
+//! This function fills the shape made of the rectangle between the centers of
+//! the corners, widened by \e lRadiusX and heightened by \e lRadiusY, with
+//! each corner a quarter of an ellipse.  When the centers are all the same
+//! point, the shape is an ellipse, or a circle.
+//!
+//! A pixel at (\e dx, \e dy) from the center of a corner is filled when it is
+//! within the ellipse whose radii are half a pixel larger than the given
+//! ones, which for a circle is \e dx^2 + \e dy^2 <= \e r^2 + \e r.  Each row
+//! of the shape is filled once, and the rows that have the same extents are
+//! filled together, so that the straight sides of the shape, and the middle
+//! of a circle where its sides are steep, take a single call to the display
+//! driver.  The radii must be below 32768 pixels, which covers any shape the
+//! 16-bit coordinates of the display can reach; larger radii are clamped.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrRoundFill(const tContext *pContext, long lX1, long lY1, long lX2, long lY2,
+            long lRadiusX, long lRadiusY)
+{
+    unsigned long ulA, ulB, ulT, ulQuot, ulRem, ulV;
+    long lDY, lW, lRunW, lRunStart;
 
     //
-    // Initialize the variables that control the Bresenham circle drawing
-    // algorithm.
+    // Check the arguments.  The radii are limited so that the diameters fit
+    // in 16 bits, which keeps every product below 32 bits.
     //
-    lA = 0;
-    lB = lRadius;
-    lD = 3 - (2 * lRadius);
+    ASSERT(lRadiusX < 32768);
+    ASSERT(lRadiusY < 32768);
+
+    if(lRadiusX > 32767)
+    {
+        lRadiusX = 32767;
+    }
+    if(lRadiusY > 32767)
+    {
+        lRadiusY = 32767;
+    }
 
     //
-    // Loop until the A delta is greater than the B delta, meaning that the
-    // entire circle has been filled.
+    // Return without drawing anything if the shape is entirely out of the
+    // clipping region.
     //
-    while(lA <= lB)
+    if((lX1 - lRadiusX > pContext->sClipRegion.sXMax) ||
+       (lX2 + lRadiusX < pContext->sClipRegion.sXMin) ||
+       (lY1 - lRadiusY > pContext->sClipRegion.sYMax) ||
+       (lY2 + lRadiusY < pContext->sClipRegion.sYMin))
     {
-        //
-        // Determine the row when subtracting the A delta.
-        //
-        lY1 = lY - lA;
+        return;
+    }
 
-        //
-        // See if this row is within the clipping region.
-        //
-        if((lY1 >= pContext->sClipRegion.sYMin) &&
-           (lY1 <= pContext->sClipRegion.sYMax))
-        {
-            //
-            // Determine the column when subtracting the B delta, and move it
-            // to the left edge of the clipping region if it is to the left of
-            // the clipping region.
-            //
-            lX1 = lX - lB;
-            if(lX1 < pContext->sClipRegion.sXMin)
-            {
-                lX1 = pContext->sClipRegion.sXMin;
-            }
+    //
+    // The diameters of the ellipse, with the half pixel added to each side.
+    //
+    ulA = (2 * lRadiusX) + 1;
+    ulB = (2 * lRadiusY) + 1;
 
-            //
-            // Determine the column when adding the B delta, and move it to the
-            // right edge of the clipping region if it is to the right of the
-            // clipping region.
-            //
-            lX2 = lX + lB;
-            if(lX2 > pContext->sClipRegion.sXMax)
-            {
-                lX2 = pContext->sClipRegion.sXMax;
-            }
+    //
+    // Walk the rows of the top and bottom corners from the outside in, while
+    // the half width of the ellipse grows.  A pixel at (dx, dy) is within the
+    // ellipse when (2 dx)^2 B^2 + (2 dy)^2 A^2 <= A^2 B^2, so the half width
+    // at a row is the largest dx for which (2 dx)^2 is at most
+    // A^2 (B^2 - (2 dy)^2) / B^2.  It is computed without overflow by
+    // multiplying by A and dividing by B twice, splitting the value each time
+    // into its quotient and remainder by B, which are both below 2^16, so
+    // that each product fits in 32 bits.
+    //
+    lW = 0;
+    lRunW = -1;
+    lRunStart = 0;
 
-            //
-            // Draw a horizontal line if this portion of the circle is within
-            // the clipping region.
-            //
-            if(lX1 <= lX2)
-            {
-                GrLineDrawH(pContext, lX1, lX2, lY1);
-            }
-        }
+    for(lDY = lRadiusY; lDY > 0; lDY--)
+    {
+        ulT = (ulB - (2 * lDY)) * (ulB + (2 * lDY));
 
         //
-        // Determine the row when adding the A delta.
+        // A T / B, as a quotient and a remainder by B.
         //
-        lY1 = lY + lA;
+        ulQuot = (ulA * (ulT / ulB)) + ((ulA * (ulT % ulB)) / ulB);
+        ulRem = (ulA * (ulT % ulB)) % ulB;
 
         //
-        // See if this row is within the clipping region, and the A delta is
-        // not zero (otherwise, this describes the same row of the circle).
+        // A^2 T / B^2, adding the remainder of A T / B, times A / B, before
+        // the last division.
         //
-        if((lY1 >= pContext->sClipRegion.sYMin) &&
-           (lY1 <= pContext->sClipRegion.sYMax) &&
-           (lA != 0))
+        ulV = ((ulA * (ulQuot / ulB)) +
+               (((ulA * (ulQuot % ulB)) + ((ulA * ulRem) / ulB)) / ulB));
+
+        while((lW < lRadiusX) &&
+              (((unsigned long)(2 * lW + 2) * (2 * lW + 2)) <= ulV))
         {
-            //
-            // Determine the column when subtracting the B delta, and move it
-            // to the left edge of the clipping region if it is to the left of
-            // the clipping region.
-            //
-            lX1 = lX - lB;
-            if(lX1 < pContext->sClipRegion.sXMin)
-            {
-                lX1 = pContext->sClipRegion.sXMin;
-            }
+            lW++;
+        }
 
-            //
-            // Determine the column when adding the B delta, and move it to the
-            // right edge of the clipping region if it is to the right of the
-            // clipping region.
-            //
-            lX2 = lX + lB;
-            if(lX2 > pContext->sClipRegion.sXMax)
+        //
+        // Fill the rows of the previous half width, above and below the
+        // rectangle, when the half width changes.
+        //
+        if(lW != lRunW)
+        {
+            if(lRunW >= 0)
             {
-                lX2 = pContext->sClipRegion.sXMax;
+                GrRoundBandFill(pContext, lX1 - lRunW, lX2 + lRunW,
+                                lY1 - lRunStart, lY1 - lDY - 1);
+                GrRoundBandFill(pContext, lX1 - lRunW, lX2 + lRunW,
+                                lY2 + lDY + 1, lY2 + lRunStart);
             }
 
-            //
-            // Draw a horizontal line if this portion of the circle is within
-            // the clipping region.
-            //
-            if(lX1 <= lX2)
-            {
-                GrLineDrawH(pContext, lX1, lX2, lY1);
-            }
+            lRunW = lW;
+            lRunStart = lDY;
         }
+    }
 
-        //
-        // Only draw the complementary lines if the B delta is about to change
-        // and the A and B delta are different (otherwise, they describe the
-        // same set of pixels).
-        //
-        if((lD >= 0) && (lA != lB))
+    //
+    // The last rows of the corners are filled along with the rectangle if
+    // they are as wide, and by themselves otherwise.
+    //
+    if(lRunW == lRadiusX)
+    {
+        GrRoundBandFill(pContext, lX1 - lRadiusX, lX2 + lRadiusX,
+                        lY1 - lRunStart, lY2 + lRunStart);
+    }
+    else
+    {
+        if(lRunW >= 0)
         {
-            //
-            // Determine the row when subtracting the B delta.
-            //
-            lY1 = lY - lB;
+            GrRoundBandFill(pContext, lX1 - lRunW, lX2 + lRunW,
+                            lY1 - lRunStart, lY1 - 1);
+            GrRoundBandFill(pContext, lX1 - lRunW, lX2 + lRunW, lY2 + 1,
+                            lY2 + lRunStart);
+        }
 
-            //
-            // See if this row is within the clipping region.
-            //
-            if((lY1 >= pContext->sClipRegion.sYMin) &&
-               (lY1 <= pContext->sClipRegion.sYMax))
-            {
-                //
-                // Determine the column when subtracting the A delta, and move
-                // it to the left edge of the clipping regino if it is to the
-                // left of the clipping region.
-                //
-                lX1 = lX - lA;
-                if(lX1 < pContext->sClipRegion.sXMin)
-                {
-                    lX1 = pContext->sClipRegion.sXMin;
-                }
+        GrRoundBandFill(pContext, lX1 - lRadiusX, lX2 + lRadiusX, lY1, lY2);
+    }
+}
 
-                //
-                // Determine the column when adding the A delta, and move it to
-                // the right edge of the clipping region if it is to the right
-                // of the clipping region.
-                //
-                lX2 = lX + lA;
-                if(lX2 > pContext->sClipRegion.sXMax)
-                {
-                    lX2 = pContext->sClipRegion.sXMax;
-                }
+//*****************************************************************************
+//
+//! Draws a filled circle.
+//!
+//! \param pContext is a pointer to the drawing context to use.
+//! \param lX is the X coordinate of the center of the circle.
+//! \param lY is the Y coordinate of the center of the circle.
+//! \param lRadius is the radius of the circle.
+//!
+//! This function draws a filled circle.  The extent of the circle is from
+//! \e lX - \e lRadius to \e lX + \e lRadius and \e lY - \e lRadius to \e lY +
+//! \e lRadius, inclusive; the pixels filled are those whose distance from the
+//! center is at most \e lRadius plus half a pixel, as with GrPieFill().
+//!
+//! Each row of the circle is filled once, and the rows in its middle that
+//! have the same extents are filled together.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+GrCircleFill(const tContext *pContext, long lX, long lY, long lRadius)
+{
+    //
+    // Check the arguments.
+    //
+    ASSERT(pContext);
 
-                //
-                // Draw a horizontal line if this portion of the circle is
-                // within the clipping region.
-                //
-                if(lX1 <= lX2)
-                {
-                    GrLineDrawH(pContext, lX1, lX2, lY1);
-                }
-            }
+    if(lRadius < 0)
+    {
+        return;
+    }
 
-            //
-            // Determine the row when adding the B delta.
-            //
-            lY1 = lY + lB;
+    GrRoundFill(pContext, lX, lY, lX, lY, lRadius, lRadius);
+}
 
-            //
-            // See if this row is within the clipping region.
-            //
-            if((lY1 >= pContext->sClipRegion.sYMin) &&
-               (lY1 <= pContext->sClipRegion.sYMax))
-            {
-                //
-                // Determine the column when subtracting the A delta, and move
-                // it to the left edge of the clipping region if it is to the
-                // left of the clipping region.
-                //
-                lX1 = lX - lA;
-                if(lX1 < pContext->sClipRegion.sXMin)
-                {
-                    lX1 = pContext->sClipRegion.sXMin;
-                }
+//*****************************************************************************
+//
+//! Draws a filled ellipse.
+//!
+//! \param pContext is a pointer to the drawing context to use.
+//! \param lX is the X coordinate of the center of the ellipse.
+//! \param lY is the Y coordinate of the center of the ellipse.
+//! \param lRadiusX is the horizontal radius of the ellipse.
+//! \param lRadiusY is the vertical radius of the ellipse.
+//!
+//! This function draws a filled ellipse.  The extent of the ellipse is from
+//! \e lX - \e lRadiusX to \e lX + \e lRadiusX and \e lY - \e lRadiusY to
+//! \e lY + \e lRadiusY, inclusive; an ellipse whose radii are equal is the
+//! circle filled by GrCircleFill().
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+GrEllipseFill(const tContext *pContext, long lX, long lY, long lRadiusX,
+              long lRadiusY)
+{
+    //
+    // Check the arguments.
+    //
+    ASSERT(pContext);
 
-                //
-                // Determine the column when adding the A delta, and move it to
-                // the right edge of the clipping region if it is to the right
-                // of the clipping region.
-                //
-                lX2 = lX + lA;
-                if(lX2 > pContext->sClipRegion.sXMax)
-                {
-                    lX2 = pContext->sClipRegion.sXMax;
-                }
+    if((lRadiusX < 0) || (lRadiusY < 0))
+    {
+        return;
+    }
 
-                //
-                // Draw a horizontal line if this portion of the circle is
-                // within the clipping region.
-                //
-                if(lX1 <= lX2)
-                {
-                    GrLineDrawH(pContext, lX1, lX2, lY1);
-                }
-            }
-        }
+    GrRoundFill(pContext, lX, lY, lX, lY, lRadiusX, lRadiusY);
+}
 
-        //
-        // See if the error term is negative.
-        //
-        if(lD < 0)
-        {
-            //
-            // Since the error term is negative, adjust it based on a move in
-            // only the A delta.
-            //
-            lD += (4 * lA) + 6;
-        }
-        else
-        {
-            //
-            // Since the error term is non-negative, adjust it based on a move
-            // in both the A and B deltas.
-            //
-            lD += (4 * (lA - lB)) + 10;
+//*****************************************************************************
+//
+//! Draws a filled rectangle with rounded corners.
+//!
+//! \param pContext is a pointer to the drawing context to use.
+//! \param pRect is a pointer to the structure containing the extents of the
+//! rectangle.
+//! \param lRadius is the radius of the corners.
+//!
+//! This function fills a rectangle whose corners are quarters of the circle
+//! filled by GrCircleFill().  The radius is reduced to half the width or
+//! height of the rectangle if it is larger, so that a radius of half the
+//! height of a wide rectangle gives a pill shape.
+//!
+//! The straight sides of the rectangle are filled with a single call to the
+//! display driver.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+GrRoundRectFill(const tContext *pContext, const tRectangle *pRect,
+                long lRadius)
+{
+    long lXMin, lYMin, lXMax, lYMax;
 
-            //
-            // Decrement the B delta.
-            //
-            lB -= 1;
-        }
+    //
+    // Check the arguments.
+    //
+    ASSERT(pContext);
+    ASSERT(pRect);
 
-        //
-        // Increment the A delta.
-        //
-        lA++;
+    //
+    // Order the coordinates of the rectangle.
+    //
+    lXMin = (pRect->sXMin < pRect->sXMax) ? pRect->sXMin : pRect->sXMax;
+    lXMax = (pRect->sXMin < pRect->sXMax) ? pRect->sXMax : pRect->sXMin;
+    lYMin = (pRect->sYMin < pRect->sYMax) ? pRect->sYMin : pRect->sYMax;
+    lYMax = (pRect->sYMin < pRect->sYMax) ? pRect->sYMax : pRect->sYMin;
+
+    //
+    // Keep the corners within the rectangle.
+    //
+    if(lRadius > ((lXMax - lXMin) / 2))
+    {
+        lRadius = (lXMax - lXMin) / 2;
+    }
+    if(lRadius > ((lYMax - lYMin) / 2))
+    {
+        lRadius = (lYMax - lYMin) / 2;
+    }
+    if(lRadius < 0)
+    {
+        lRadius = 0;
     }
+
+    GrRoundFill(pContext, lXMin + lRadius, lYMin + lRadius, lXMax - lRadius,
+                lYMax - lRadius, lRadius, lRadius);
 }
 
 //*****************************************************************************
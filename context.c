@@ -76,9 +76,9 @@ GrLibInit(const tGrLibDefaults *pDefaults)
 //! \param pContext is a pointer to the drawing context to initialize.
 //!
 //! This function initializes a drawing context, preparing it for use.  The
-//! provided display driver will be used for all subsequent graphics
-//! operations, and the default clipping region will be set to the extent of
-//! the screen.
+//! context draws onto the global display, g_sDisplay, until another display is
+//! selected with GrContextDisplaySet(), and the default clipping region will be
+//! set to the extent of the screen.
 //!
 //! \return None.
 //
@@ -96,19 +96,25 @@ GrContextInit(tContext *pContext)
     //
     pContext->lSize = sizeof(tContext);
 
+    //
+    // Draw onto the global display.
+    //
+    pContext->pDisplay = &g_sDisplay;
+
     //
     // Initialize the extent of the clipping region to the extents of the
     // screen.
     //
     pContext->sClipRegion.sXMin = 0;
     pContext->sClipRegion.sYMin = 0;
-    pContext->sClipRegion.sXMax = DisplayWidthGet() - 1;
-    pContext->sClipRegion.sYMax = DisplayHeightGet() - 1;
+    pContext->sClipRegion.sXMax = DpyWidthGet(pContext->pDisplay) - 1;
+    pContext->sClipRegion.sYMax = DpyHeightGet(pContext->pDisplay) - 1;
 
     //
     // Provide a default color and font.
     //
     pContext->ulForeground = 0;
+    pContext->ulForegroundRGB = 0;
     pContext->ulBackground = 0;
     pContext->ulGradient1  = 0;
     pContext->ulGradient2  = 0;
@@ -138,6 +144,50 @@ GrContextInit(tContext *pContext)
 #endif
 }
 
+//*****************************************************************************
+//
+//! Sets the display used by a drawing context.
+//!
+//! \param pContext is a pointer to the drawing context to modify.
+//! \param pDisplay is a pointer to the display structure to draw onto.
+//!
+//! This function selects the display onto which all subsequent drawing
+//! operations of the context are performed, for example an off-screen buffer
+//! initialized with GrOffScreen16BPPInit().  The clipping region is reset to
+//! the extents of the new display.  Colors are translated by the display when
+//! they are set, so the foreground and background colors must be set again
+//! after the display is changed.
+//!
+//! Each display structure carries its own driver-specific data, so contexts
+//! bound to different surfaces, including surfaces of the same format, may be
+//! drawn with in any order.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+GrContextDisplaySet(tContext *pContext, const tDisplay *pDisplay)
+{
+    //
+    // Check the arguments.
+    //
+    ASSERT(pContext);
+    ASSERT(pDisplay);
+
+    //
+    // Remember the display.
+    //
+    pContext->pDisplay = pDisplay;
+
+    //
+    // Reset the extent of the clipping region to the extents of the display.
+    //
+    pContext->sClipRegion.sXMin = 0;
+    pContext->sClipRegion.sYMin = 0;
+    pContext->sClipRegion.sXMax = DpyWidthGet(pDisplay) - 1;
+    pContext->sClipRegion.sYMax = DpyHeightGet(pDisplay) - 1;
+}
+
 //*****************************************************************************
 //
 //! Sets the extents of the clipping region.
@@ -172,8 +222,8 @@ GrContextClipRegionSet(tContext *pContext, tRectangle *pRect)
     //
     // Get the width and height of the display.
     //
-    ulW = DisplayWidthGet();
-    ulH = DisplayHeightGet();
+    ulW = DpyWidthGet(pContext->pDisplay);
+    ulH = DpyHeightGet(pContext->pDisplay);
 
     //
     // Set the extents of the clipping region, forcing them to reside within
@@ -0,0 +1,292 @@
+//*****************************************************************************
+//
+// dirtyrect.c - Accumulator of the display areas that need to be flushed.
+//
+//*****************************************************************************
+
+#include "debug.h"
+#include "grlib.h"
+
+//*****************************************************************************
+//
+//! \addtogroup primitives_api
+//! @{
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// Make sure min and max are defined.
+//
+//*****************************************************************************
+#ifndef min
+#define min(a, b)               (((a) < (b)) ? (a) : (b))
+#endif
+
+#ifndef max
+#define max(a, b)               (((a) < (b)) ? (b) : (a))
+#endif
+
+//*****************************************************************************
+//
+// Computes the number of pixels in a rectangle.
+//
+//*****************************************************************************
+#define RectArea(pRect)                                                      \
+        ((unsigned long)((pRect)->sXMax - (pRect)->sXMin + 1) *              \
+         (unsigned long)((pRect)->sYMax - (pRect)->sYMin + 1))
+
+//*****************************************************************************
+//
+// The dirty rectangles collected since the last flush.  There are at most
+// GRLIB_DIRTY_RECTS of them, so the number of flushes per frame never exceeds
+// this value.
+//
+//*****************************************************************************
+static tDirtyRectSet g_sDirtyRects;
+
+//*****************************************************************************
+//
+// Computes the bounding box of two rectangles.
+//
+//*****************************************************************************
+static void
+DirtyRectBoundsGet(const tRectangle *psRect1, const tRectangle *psRect2,
+                   tRectangle *psBounds)
+{
+    psBounds->sXMin = min(psRect1->sXMin, psRect2->sXMin);
+    psBounds->sYMin = min(psRect1->sYMin, psRect2->sYMin);
+    psBounds->sXMax = max(psRect1->sXMax, psRect2->sXMax);
+    psBounds->sYMax = max(psRect1->sYMax, psRect2->sYMax);
+}
+
+//*****************************************************************************
+//
+// Determines if two rectangles should be flushed as one.  This is the case if
+// they overlap or touch, and their bounding box holds no more pixels than the
+// union of the two rectangles; in other words, merging them never makes the
+// flush push pixels that were not damaged.
+//
+//*****************************************************************************
+static long
+DirtyRectMergeable(const tRectangle *psRect1, const tRectangle *psRect2,
+                   tRectangle *psBounds)
+{
+    tRectangle sOverlap;
+    unsigned long ulUnion;
+
+    //
+    // Rectangles that are apart by at least one pixel are kept separate.
+    //
+    if((psRect1->sXMax + 1 < psRect2->sXMin) ||
+       (psRect2->sXMax + 1 < psRect1->sXMin) ||
+       (psRect1->sYMax + 1 < psRect2->sYMin) ||
+       (psRect2->sYMax + 1 < psRect1->sYMin))
+    {
+        return(0);
+    }
+
+    //
+    // Count the pixels of the union, taking the pixels that the two rectangles
+    // share only once.  Rectangles that merely touch share no pixels.
+    //
+    ulUnion = RectArea(psRect1) + RectArea(psRect2);
+    sOverlap.sXMin = max(psRect1->sXMin, psRect2->sXMin);
+    sOverlap.sYMin = max(psRect1->sYMin, psRect2->sYMin);
+    sOverlap.sXMax = min(psRect1->sXMax, psRect2->sXMax);
+    sOverlap.sYMax = min(psRect1->sYMax, psRect2->sYMax);
+    if((sOverlap.sXMin <= sOverlap.sXMax) &&
+       (sOverlap.sYMin <= sOverlap.sYMax))
+    {
+        ulUnion -= RectArea(&sOverlap);
+    }
+
+    //
+    // Merge only if the bounding box does not add pixels.
+    //
+    DirtyRectBoundsGet(psRect1, psRect2, psBounds);
+
+    return(RectArea(psBounds) <= ulUnion);
+}
+
+//*****************************************************************************
+//
+//! Adds an area to a set of dirty rectangles.
+//!
+//! \param psSet is a pointer to the set of dirty rectangles.
+//! \param pRect is a pointer to the rectangle to add.
+//!
+//! This function adds a rectangle to a set of display areas.  A rectangle that
+//! lies within an area of the set is dropped, and rectangles that overlap or
+//! touch are merged when that does not grow the area of the set.  If all the
+//! slots are in use, the new rectangle is merged with the one whose bounding
+//! box grows the least.  A set is emptied by setting its \e ulCount to zero.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+GrDirtyRectSetAdd(tDirtyRectSet *psSet, const tRectangle *pRect)
+{
+    tRectangle sRect, sBounds;
+    unsigned long ulIdx, ulBest, ulGrowth, ulBestGrowth;
+
+    //
+    // Check the arguments.
+    //
+    ASSERT(psSet);
+    ASSERT(pRect);
+
+    //
+    // Ignore empty rectangles.
+    //
+    if((pRect->sXMin > pRect->sXMax) || (pRect->sYMin > pRect->sYMax))
+    {
+        return;
+    }
+
+    sRect = *pRect;
+
+    //
+    // Loop through the dirty rectangles, absorbing the ones that can be merged
+    // with the new one.  The scan restarts after each merge since the grown
+    // rectangle may now touch entries that were checked before.
+    //
+    for(ulIdx = 0; ulIdx < psSet->ulCount; ulIdx++)
+    {
+        //
+        // Nothing to do if this area is already dirty.
+        //
+        if((psSet->psRects[ulIdx].sXMin <= sRect.sXMin) &&
+           (psSet->psRects[ulIdx].sYMin <= sRect.sYMin) &&
+           (psSet->psRects[ulIdx].sXMax >= sRect.sXMax) &&
+           (psSet->psRects[ulIdx].sYMax >= sRect.sYMax))
+        {
+            return;
+        }
+
+        if(DirtyRectMergeable(&psSet->psRects[ulIdx], &sRect, &sBounds))
+        {
+            //
+            // Take the entry out of the list, replacing it with the last one,
+            // and continue with the merged rectangle.
+            //
+            psSet->psRects[ulIdx] = psSet->psRects[--psSet->ulCount];
+            sRect = sBounds;
+            ulIdx = (unsigned long)-1;
+        }
+    }
+
+    //
+    // Store the rectangle if there is a free slot.
+    //
+    if(psSet->ulCount < GRLIB_DIRTY_RECTS)
+    {
+        psSet->psRects[psSet->ulCount++] = sRect;
+        return;
+    }
+
+    //
+    // There is no free slot, so find the entry that grows the least when the
+    // new rectangle is merged into it.
+    //
+    ulBest = 0;
+    ulBestGrowth = 0xffffffff;
+    for(ulIdx = 0; ulIdx < psSet->ulCount; ulIdx++)
+    {
+        DirtyRectBoundsGet(&psSet->psRects[ulIdx], &sRect, &sBounds);
+        ulGrowth = RectArea(&sBounds) - RectArea(&psSet->psRects[ulIdx]);
+        if(ulGrowth < ulBestGrowth)
+        {
+            ulBest = ulIdx;
+            ulBestGrowth = ulGrowth;
+        }
+    }
+
+    //
+    // Take that entry out of the list and add the merged rectangle again, so
+    // that it can absorb any entry it now covers.
+    //
+    DirtyRectBoundsGet(&psSet->psRects[ulBest], &sRect, &sBounds);
+    psSet->psRects[ulBest] = psSet->psRects[--psSet->ulCount];
+    GrDirtyRectSetAdd(psSet, &sBounds);
+}
+
+//*****************************************************************************
+//
+//! Marks an area of the display as changed.
+//!
+//! \param pRect is a pointer to the rectangle that has changed.
+//!
+//! This function adds a rectangle to the set of display areas that need to be
+//! flushed, as GrDirtyRectSetAdd() does.  The areas are sent to the display by
+//! GrDirtyRectFlush().
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+GrDirtyRectAdd(const tRectangle *pRect)
+{
+    GrDirtyRectSetAdd(&g_sDirtyRects, pRect);
+}
+
+//*****************************************************************************
+//
+//! Gets the number of pending dirty rectangles.
+//!
+//! This function returns the number of separate display areas that have been
+//! marked as changed since the last call to GrDirtyRectFlush().
+//!
+//! \return Returns the number of pending dirty rectangles.
+//
+//*****************************************************************************
+unsigned long
+GrDirtyRectCountGet(void)
+{
+    return(g_sDirtyRects.ulCount);
+}
+
+//*****************************************************************************
+//
+//! Flushes the dirty areas to a display.
+//!
+//! \param pDisplay is a pointer to the display to flush.
+//!
+//! This function flushes every area marked by GrDirtyRectAdd() to the display
+//! with one call to its flush function per area, and then forgets them.  It is
+//! intended to be called once per frame, after all drawing is done.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+GrDirtyRectFlush(const tDisplay *pDisplay)
+{
+    unsigned long ulIdx;
+
+    //
+    // Check the arguments.
+    //
+    ASSERT(pDisplay);
+
+    //
+    // Flush the dirty areas.
+    //
+    for(ulIdx = 0; ulIdx < g_sDirtyRects.ulCount; ulIdx++)
+    {
+        DpyFlush(pDisplay, &g_sDirtyRects.psRects[ulIdx]);
+    }
+
+    //
+    // Nothing is dirty anymore.
+    //
+    g_sDirtyRects.ulCount = 0;
+}
+
+//*****************************************************************************
+//
+// Close the Doxygen group.
+//! @}
+//
+//*****************************************************************************
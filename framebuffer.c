@@ -0,0 +1,877 @@
+//*****************************************************************************
+//
+// framebuffer.c - In-memory frame buffer display driver.
+//
+//*****************************************************************************
+
+#include "debug.h"
+#include "grlib.h"
+
+//*****************************************************************************
+//
+//! \addtogroup primitives_api
+//! @{
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+//! Computes the address of a pixel in the frame buffer.
+//!
+//! \param psFrameBuffer is a pointer to the frame buffer.
+//! \param lX is the X coordinate of the pixel.
+//! \param lY is the Y coordinate of the pixel.
+//!
+//! \return Returns a pointer to the first byte of the pixel.
+//
+//*****************************************************************************
+static unsigned char *
+GrFrameBufferPixelAddr(tFrameBuffer *psFrameBuffer, long lX, long lY)
+{
+    if(psFrameBuffer->ulFormat == FRAMEBUFFER_FMT_RGB565)
+    {
+        return(psFrameBuffer->pucBuffer + (lY * psFrameBuffer->lStride) +
+               (lX * sizeof(unsigned short)));
+    }
+    else
+    {
+        return(psFrameBuffer->pucBuffer + (lY * psFrameBuffer->lStride) +
+               (lX * sizeof(unsigned long)));
+    }
+}
+
+//*****************************************************************************
+//
+//! Fills a horizontal run of pixels in the frame buffer.
+//!
+//! \param psFrameBuffer is a pointer to the frame buffer.
+//! \param pucData is a pointer to the first pixel of the run.
+//! \param lCount is the number of pixels in the run.
+//! \param ulValue is the display driver-specific color of the pixels.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrFrameBufferSpanFill(tFrameBuffer *psFrameBuffer, unsigned char *pucData,
+                      long lCount, unsigned long ulValue)
+{
+    unsigned short *pusData;
+    unsigned long *pulData;
+
+    if(psFrameBuffer->ulFormat == FRAMEBUFFER_FMT_RGB565)
+    {
+        pusData = (unsigned short *)pucData;
+        while(lCount--)
+        {
+            *pusData++ = ulValue;
+        }
+    }
+    else
+    {
+        pulData = (unsigned long *)pucData;
+        while(lCount--)
+        {
+            *pulData++ = ulValue;
+        }
+    }
+}
+
+//*****************************************************************************
+//
+//! Enables the frame buffer display.
+//!
+//! This function is a no operation for the frame buffer display.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrFrameBufferEnable(void *pvDisplayData)
+{
+}
+
+//*****************************************************************************
+//
+//! Disables the frame buffer display.
+//!
+//! This function is a no operation for the frame buffer display.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrFrameBufferDisable(void *pvDisplayData)
+{
+}
+
+//*****************************************************************************
+//
+//! Sets the backlight state of the frame buffer display.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//! \param usNewState is the state of the backlight.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrFrameBufferBacklightStateSet(void *pvDisplayData, unsigned short usNewState)
+{
+    tFrameBuffer *psFrameBuffer;
+
+    psFrameBuffer = (tFrameBuffer *)pvDisplayData;
+
+    psFrameBuffer->usBacklightState = usNewState;
+}
+
+//*****************************************************************************
+//
+//! Gets the backlight state of the frame buffer display.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//!
+//! \return Returns the last backlight state that was set.
+//
+//*****************************************************************************
+static unsigned short
+GrFrameBufferBacklightStateGet(void *pvDisplayData)
+{
+    tFrameBuffer *psFrameBuffer;
+
+    psFrameBuffer = (tFrameBuffer *)pvDisplayData;
+
+    return(psFrameBuffer->usBacklightState);
+}
+
+//*****************************************************************************
+//
+//! Sets the orientation of the frame buffer display.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//! \param usNewOrientation is the orientation of the display.
+//!
+//! The orientation is only remembered; the frame buffer is not rotated.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrFrameBufferOrientationSet(void *pvDisplayData,
+                            unsigned short usNewOrientation)
+{
+    tFrameBuffer *psFrameBuffer;
+
+    psFrameBuffer = (tFrameBuffer *)pvDisplayData;
+
+    psFrameBuffer->usOrientation = usNewOrientation;
+}
+
+//*****************************************************************************
+//
+//! Gets the orientation of the frame buffer display.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//!
+//! \return Returns the last orientation that was set.
+//
+//*****************************************************************************
+static unsigned short
+GrFrameBufferOrientationGet(void *pvDisplayData)
+{
+    tFrameBuffer *psFrameBuffer;
+
+    psFrameBuffer = (tFrameBuffer *)pvDisplayData;
+
+    return(psFrameBuffer->usOrientation);
+}
+
+//*****************************************************************************
+//
+//! Gets the width of the frame buffer display.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//!
+//! \return Returns the width of the frame buffer in pixels.
+//
+//*****************************************************************************
+static unsigned short
+GrFrameBufferWidthGet(void *pvDisplayData)
+{
+    tFrameBuffer *psFrameBuffer;
+
+    psFrameBuffer = (tFrameBuffer *)pvDisplayData;
+
+    return(psFrameBuffer->lWidth);
+}
+
+//*****************************************************************************
+//
+//! Gets the height of the frame buffer display.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//!
+//! \return Returns the height of the frame buffer in pixels.
+//
+//*****************************************************************************
+static unsigned short
+GrFrameBufferHeightGet(void *pvDisplayData)
+{
+    tFrameBuffer *psFrameBuffer;
+
+    psFrameBuffer = (tFrameBuffer *)pvDisplayData;
+
+    return(psFrameBuffer->lHeight);
+}
+
+//*****************************************************************************
+//
+//! Translates a 24-bit RGB color to a display driver-specific color.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//! \param ulValue is the 24-bit RGB color.  The least-significant byte is the
+//! blue channel, the next byte is the green channel, and the third byte is the
+//! red channel.
+//!
+//! This function translates a 24-bit RGB color into a value that can be
+//! written into the frame buffer in order to reproduce that color, or the
+//! closest possible approximation of that color.
+//!
+//! \return Returns the display-driver specific color.
+//
+//*****************************************************************************
+static unsigned long
+GrFrameBufferColorTranslate(void *pvDisplayData, unsigned long ulValue)
+{
+    tFrameBuffer *psFrameBuffer;
+
+    psFrameBuffer = (tFrameBuffer *)pvDisplayData;
+
+    psFrameBuffer->sStats.ulColorTranslateCalls++;
+
+    if(psFrameBuffer->ulFormat == FRAMEBUFFER_FMT_RGB565)
+    {
+        return(((((ulValue >> ClrRedShift) & 0xff) >> 3) << 11) |
+               ((((ulValue >> ClrGreenShift) & 0xff) >> 2) << 5) |
+               (((ulValue >> ClrBlueShift) & 0xff) >> 3));
+    }
+    else
+    {
+        return(ulValue & 0x00ffffff);
+    }
+}
+
+//*****************************************************************************
+//
+//! Draws a pixel on the frame buffer.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//! \param lX is the X coordinate of the pixel.
+//! \param lY is the Y coordinate of the pixel.
+//! \param ulValue is the color of the pixel.
+//!
+//! This function sets the given pixel to a particular color.  The coordinates
+//! of the pixel are assumed to be within the extents of the display.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrFrameBufferPixelDraw(void *pvDisplayData, long lX, long lY,
+                       unsigned long ulValue)
+{
+    tFrameBuffer *psFrameBuffer;
+
+    psFrameBuffer = (tFrameBuffer *)pvDisplayData;
+
+    ASSERT(psFrameBuffer->pucBuffer);
+
+    psFrameBuffer->sStats.ulPixelDrawCalls++;
+    psFrameBuffer->sStats.ulPixelsWritten++;
+
+    GrFrameBufferSpanFill(psFrameBuffer,
+                          GrFrameBufferPixelAddr(psFrameBuffer, lX, lY), 1,
+                          ulValue);
+}
+
+//*****************************************************************************
+//
+//! Draws a horizontal sequence of pixels on the frame buffer.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//! \param lX is the X coordinate of the first pixel.
+//! \param lY is the Y coordinate of the first pixel.
+//! \param lX0 is sub-pixel offset within the pixel data, which is valid for 1
+//! or 4 bit per pixel formats.
+//! \param lCount is the number of pixels to draw.
+//! \param lBPP is the number of bits per pixel; must be 1, 4, or 8.
+//! \param pucData is a pointer to the pixel data.  For 1 and 4 bit per pixel
+//! formats, the most significant bit(s) represent the left-most pixel.
+//! \param pucPalette is a pointer to the palette used to draw the pixels.
+//!
+//! This function draws a horizontal sequence of pixels on the frame buffer,
+//! using the supplied palette.  For 1 bit per pixel format, the palette
+//! contains pre-translated colors; for 4 and 8 bit per pixel formats, the
+//! palette contains 24-bit RGB values that must be translated before being
+//! written to the display.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrFrameBufferPixelDrawMultiple(void *pvDisplayData, long lX, long lY, long lX0,
+                               long lCount, long lBPP,
+                               const unsigned char *pucData,
+                               const unsigned char *pucPalette)
+{
+    tFrameBuffer *psFrameBuffer;
+    unsigned char *pucPtr;
+    unsigned long ulByte, ulIdx;
+    long lPixelSize;
+
+    psFrameBuffer = (tFrameBuffer *)pvDisplayData;
+
+    ASSERT(psFrameBuffer->pucBuffer);
+    ASSERT(pucData);
+    ASSERT(pucPalette);
+
+    psFrameBuffer->sStats.ulPixelDrawMultipleCalls++;
+    psFrameBuffer->sStats.ulPixelsWritten += lCount;
+
+    //
+    // Get the address of the first pixel and the size of each pixel.
+    //
+    pucPtr = GrFrameBufferPixelAddr(psFrameBuffer, lX, lY);
+    lPixelSize = ((psFrameBuffer->ulFormat == FRAMEBUFFER_FMT_RGB565) ?
+                  sizeof(unsigned short) : sizeof(unsigned long));
+
+    //
+    // Loop while there are more pixels to draw.
+    //
+    while(lCount > 0)
+    {
+        //
+        // Determine how to interpret the pixel data based on the number of
+        // bits per pixel.
+        //
+        switch(lBPP)
+        {
+            //
+            // The palette holds two pre-translated colors.
+            //
+            case 1:
+            {
+                ulByte = ((unsigned long *)pucPalette)[(*pucData >>
+                                                        (7 - lX0)) & 1];
+                if(++lX0 == 8)
+                {
+                    lX0 = 0;
+                    pucData++;
+                }
+                break;
+            }
+
+            //
+            // The palette holds 16 24-bit RGB colors.
+            //
+            case 4:
+            {
+                ulIdx = ((lX0 & 1) ? (*pucData++ & 15) : (*pucData >> 4)) * 3;
+                ulByte = GrFrameBufferColorTranslate(
+                             pvDisplayData,
+                             pucPalette[ulIdx] |
+                             (pucPalette[ulIdx + 1] << 8) |
+                             (pucPalette[ulIdx + 2] << 16));
+                lX0 ^= 1;
+                break;
+            }
+
+            //
+            // The palette holds 256 24-bit RGB colors.
+            //
+            case 8:
+            default:
+            {
+                ulIdx = *pucData++ * 3;
+                ulByte = GrFrameBufferColorTranslate(
+                             pvDisplayData,
+                             pucPalette[ulIdx] |
+                             (pucPalette[ulIdx + 1] << 8) |
+                             (pucPalette[ulIdx + 2] << 16));
+                break;
+            }
+        }
+
+        //
+        // Write this pixel and move to the next one.
+        //
+        GrFrameBufferSpanFill(psFrameBuffer, pucPtr, 1, ulByte);
+        pucPtr += lPixelSize;
+        lCount--;
+    }
+}
+
+//*****************************************************************************
+//
+//! Draws a horizontal line.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//! \param lX1 is the X coordinate of the start of the line.
+//! \param lX2 is the X coordinate of the end of the line.
+//! \param lY is the Y coordinate of the line.
+//! \param ulValue is the color of the line.
+//!
+//! This function draws a horizontal line on the frame buffer.  The
+//! coordinates of the line are assumed to be within the extents of the
+//! display.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrFrameBufferLineDrawH(void *pvDisplayData, long lX1, long lX2, long lY,
+                       unsigned long ulValue)
+{
+    tFrameBuffer *psFrameBuffer;
+
+    psFrameBuffer = (tFrameBuffer *)pvDisplayData;
+
+    ASSERT(psFrameBuffer->pucBuffer);
+
+    psFrameBuffer->sStats.ulLineDrawHCalls++;
+    psFrameBuffer->sStats.ulPixelsWritten += lX2 - lX1 + 1;
+
+    GrFrameBufferSpanFill(psFrameBuffer,
+                          GrFrameBufferPixelAddr(psFrameBuffer, lX1, lY),
+                          lX2 - lX1 + 1, ulValue);
+}
+
+//*****************************************************************************
+//
+//! Draws a vertical line.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//! \param lX is the X coordinate of the line.
+//! \param lY1 is the Y coordinate of the start of the line.
+//! \param lY2 is the Y coordinate of the end of the line.
+//! \param ulValue is the color of the line.
+//!
+//! This function draws a vertical line on the frame buffer.  The coordinates
+//! of the line are assumed to be within the extents of the display.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrFrameBufferLineDrawV(void *pvDisplayData, long lX, long lY1, long lY2,
+                       unsigned long ulValue)
+{
+    tFrameBuffer *psFrameBuffer;
+    unsigned char *pucData;
+
+    psFrameBuffer = (tFrameBuffer *)pvDisplayData;
+
+    ASSERT(psFrameBuffer->pucBuffer);
+
+    psFrameBuffer->sStats.ulLineDrawVCalls++;
+    psFrameBuffer->sStats.ulPixelsWritten += lY2 - lY1 + 1;
+
+    //
+    // Loop over the rows of the line.
+    //
+    for(pucData = GrFrameBufferPixelAddr(psFrameBuffer, lX, lY1); lY1 <= lY2;
+        lY1++, pucData += psFrameBuffer->lStride)
+    {
+        GrFrameBufferSpanFill(psFrameBuffer, pucData, 1, ulValue);
+    }
+}
+
+//*****************************************************************************
+//
+//! Fills a rectangle.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//! \param pRect is a pointer to the structure describing the rectangle.
+//! \param ulValue is the color of the rectangle.
+//!
+//! This function fills a rectangle on the frame buffer.  The coordinates of
+//! the rectangle are assumed to be within the extents of the display, and the
+//! rectangle specification is fully inclusive (in other words, both sXMin and
+//! sXMax are drawn, along with sYMin and sYMax).
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrFrameBufferRectFill(void *pvDisplayData, tRectangle *pRect,
+                      unsigned long ulValue)
+{
+    tFrameBuffer *psFrameBuffer;
+    unsigned char *pucData;
+    long lY, lCount;
+
+    psFrameBuffer = (tFrameBuffer *)pvDisplayData;
+
+    ASSERT(psFrameBuffer->pucBuffer);
+    ASSERT(pRect);
+
+    lCount = pRect->sXMax - pRect->sXMin + 1;
+
+    psFrameBuffer->sStats.ulRectFillCalls++;
+    psFrameBuffer->sStats.ulPixelsWritten +=
+        lCount * (pRect->sYMax - pRect->sYMin + 1);
+
+    //
+    // Fill the rectangle one row at a time.
+    //
+    for(lY = pRect->sYMin,
+        pucData = GrFrameBufferPixelAddr(psFrameBuffer, pRect->sXMin,
+                                         pRect->sYMin);
+        lY <= pRect->sYMax; lY++, pucData += psFrameBuffer->lStride)
+    {
+        GrFrameBufferSpanFill(psFrameBuffer, pucData, lCount, ulValue);
+    }
+}
+
+//*****************************************************************************
+//
+//! Reads back a pixel of the frame buffer.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//! \param lX is the X coordinate of the pixel.
+//! \param lY is the Y coordinate of the pixel.
+//!
+//! This function reads back the color of a pixel.  The coordinates of the
+//! pixel are assumed to be within the extents of the display.
+//!
+//! \return Returns the 24-bit RGB color of the pixel.
+//
+//*****************************************************************************
+static unsigned long
+GrFrameBufferPixelRead(void *pvDisplayData, long lX, long lY)
+{
+    tFrameBuffer *psFrameBuffer;
+    unsigned long ulValue;
+
+    psFrameBuffer = (tFrameBuffer *)pvDisplayData;
+
+    ASSERT(psFrameBuffer->pucBuffer);
+
+    if(psFrameBuffer->ulFormat == FRAMEBUFFER_FMT_RGB565)
+    {
+        ulValue = *(unsigned short *)GrFrameBufferPixelAddr(psFrameBuffer, lX,
+                                                            lY);
+
+        //
+        // Widen each component to eight bits, repeating its top bits in the
+        // new low bits so that full intensity stays full intensity.
+        //
+        return(((((ulValue >> 8) & 0xf8) | ((ulValue >> 13) & 0x07)) <<
+                ClrRedShift) |
+               ((((ulValue >> 3) & 0xfc) | ((ulValue >> 9) & 0x03)) <<
+                ClrGreenShift) |
+               ((((ulValue << 3) & 0xf8) | ((ulValue >> 2) & 0x07)) <<
+                ClrBlueShift));
+    }
+    else
+    {
+        return(*(unsigned long *)GrFrameBufferPixelAddr(psFrameBuffer, lX,
+                                                        lY) & 0x00ffffff);
+    }
+}
+
+//*****************************************************************************
+//
+//! Blends a color into a pixel of the frame buffer.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//! \param lX is the X coordinate of the pixel.
+//! \param lY is the Y coordinate of the pixel.
+//! \param ulValue is the 24-bit RGB color to blend.
+//! \param ulAlpha is the opacity of the color, from 0 to
+//! \b #GR_ALPHA_OPAQUE.
+//!
+//! This function blends a color into a pixel.  The coordinates of the pixel
+//! are assumed to be within the extents of the display.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrFrameBufferPixelBlend(void *pvDisplayData, long lX, long lY,
+                        unsigned long ulValue, unsigned long ulAlpha)
+{
+    tFrameBuffer *psFrameBuffer;
+    unsigned long ulPixel, ulBlend;
+    long lShift;
+
+    psFrameBuffer = (tFrameBuffer *)pvDisplayData;
+
+    ASSERT(psFrameBuffer->pucBuffer);
+
+    psFrameBuffer->sStats.ulPixelBlendCalls++;
+    psFrameBuffer->sStats.ulPixelsWritten++;
+
+    ulPixel = GrFrameBufferPixelRead(pvDisplayData, lX, lY);
+
+    //
+    // Blend the color into the pixel one component at a time.
+    //
+    ulBlend = 0;
+
+    for(lShift = ClrRedShift; lShift >= 0; lShift -= 8)
+    {
+        ulBlend |= (((((ulValue >> lShift) & 0xff) * ulAlpha) +
+                     (((ulPixel >> lShift) & 0xff) *
+                      (GR_ALPHA_OPAQUE - ulAlpha)) +
+                     (GR_ALPHA_OPAQUE / 2)) / GR_ALPHA_OPAQUE) << lShift;
+    }
+
+    if(psFrameBuffer->ulFormat == FRAMEBUFFER_FMT_RGB565)
+    {
+        ulBlend = (((((ulBlend >> ClrRedShift) & 0xff) >> 3) << 11) |
+                   ((((ulBlend >> ClrGreenShift) & 0xff) >> 2) << 5) |
+                   (((ulBlend >> ClrBlueShift) & 0xff) >> 3));
+    }
+
+    GrFrameBufferSpanFill(psFrameBuffer,
+                          GrFrameBufferPixelAddr(psFrameBuffer, lX, lY), 1,
+                          ulBlend);
+}
+
+//*****************************************************************************
+//
+//! Flushes a rectangle of the frame buffer.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//! \param pRect is a pointer to the rectangle to be flushed.
+//!
+//! This function clips the rectangle to the extents of the frame buffer and
+//! passes it to the flush function set with GrFrameBufferFlushSet(), if any.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrFrameBufferFlush(void *pvDisplayData, tRectangle *pRect)
+{
+    tFrameBuffer *psFrameBuffer;
+    tRectangle sRect;
+
+    psFrameBuffer = (tFrameBuffer *)pvDisplayData;
+
+    ASSERT(psFrameBuffer->pucBuffer);
+    ASSERT(pRect);
+
+    //
+    // Clip the rectangle to the extents of the frame buffer.
+    //
+    sRect.sXMin = (pRect->sXMin < 0) ? 0 : pRect->sXMin;
+    sRect.sYMin = (pRect->sYMin < 0) ? 0 : pRect->sYMin;
+    sRect.sXMax = ((pRect->sXMax >= psFrameBuffer->lWidth) ?
+                   (psFrameBuffer->lWidth - 1) : pRect->sXMax);
+    sRect.sYMax = ((pRect->sYMax >= psFrameBuffer->lHeight) ?
+                   (psFrameBuffer->lHeight - 1) : pRect->sYMax);
+
+    //
+    // Nothing to do if the rectangle is outside of the frame buffer.
+    //
+    if((sRect.sXMin > sRect.sXMax) || (sRect.sYMin > sRect.sYMax))
+    {
+        return;
+    }
+
+    psFrameBuffer->sStats.ulFlushCalls++;
+    psFrameBuffer->sStats.ulPixelsFlushed +=
+        (sRect.sXMax - sRect.sXMin + 1) * (sRect.sYMax - sRect.sYMin + 1);
+
+    if(psFrameBuffer->pfnFlush)
+    {
+        psFrameBuffer->pfnFlush(&sRect,
+                                GrFrameBufferPixelAddr(psFrameBuffer,
+                                                       sRect.sXMin,
+                                                       sRect.sYMin),
+                                psFrameBuffer->lStride);
+    }
+}
+
+//*****************************************************************************
+//
+//! Initializes the frame buffer display driver.
+//!
+//! \param pDisplay is a pointer to the display structure to be configured for
+//! the frame buffer (typically \b g_sDisplay).
+//! \param psFrameBuffer is a pointer to the structure that holds the state of
+//! this frame buffer.
+//! \param pvBuffer is a pointer to the pixel memory of the frame buffer.
+//! \param lWidth is the width of the frame buffer in pixels.
+//! \param lHeight is the height of the frame buffer in pixels.
+//! \param ulFormat is the pixel format, one of \b #FRAMEBUFFER_FMT_RGB565 or
+//! \b #FRAMEBUFFER_FMT_RGB888.
+//!
+//! This function binds the supplied memory to the frame buffer state,
+//! makes that state the driver-specific data of the display, and fills in
+//! every function of the display structure.  The memory is assumed to be at
+//! least GrFrameBufferSize() bytes long and suitably aligned for the pixel
+//! format.  The flush function and the driver counters are cleared.  Each
+//! frame buffer needs its own state structure, which must stay valid for as
+//! long as the display is used.
+//!
+//! The driver needs nothing but memory, so it allows the graphics library
+//! and widgets to be rendered and benchmarked on a host machine.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+GrFrameBufferInit(tDisplay *pDisplay, tFrameBuffer *psFrameBuffer,
+                  void *pvBuffer, long lWidth, long lHeight,
+                  unsigned long ulFormat)
+{
+    //
+    // Check the arguments.
+    //
+    ASSERT(pDisplay);
+    ASSERT(psFrameBuffer);
+    ASSERT(pvBuffer);
+    ASSERT((ulFormat == FRAMEBUFFER_FMT_RGB565) ||
+           (ulFormat == FRAMEBUFFER_FMT_RGB888));
+
+    //
+    // Bind the pixel memory to the frame buffer state.
+    //
+    psFrameBuffer->pucBuffer = (unsigned char *)pvBuffer;
+    psFrameBuffer->lWidth = lWidth;
+    psFrameBuffer->lHeight = lHeight;
+    psFrameBuffer->ulFormat = ulFormat;
+    psFrameBuffer->lStride = GrFrameBufferSize(lWidth, 1, ulFormat);
+    psFrameBuffer->usBacklightState = 0;
+    psFrameBuffer->usOrientation = 0;
+    psFrameBuffer->pfnFlush = 0;
+
+    //
+    // Initialize the display structure.
+    //
+    pDisplay->pvDisplayData = psFrameBuffer;
+    pDisplay->pfnEnable = GrFrameBufferEnable;
+    pDisplay->pfnDisable = GrFrameBufferDisable;
+    pDisplay->pfnBacklightStateSet = GrFrameBufferBacklightStateSet;
+    pDisplay->pfnBacklightStateGet = GrFrameBufferBacklightStateGet;
+    pDisplay->pfnOrientationSet = GrFrameBufferOrientationSet;
+    pDisplay->pfnOrientationGet = GrFrameBufferOrientationGet;
+    pDisplay->pfnWidthGet = GrFrameBufferWidthGet;
+    pDisplay->pfnHeightGet = GrFrameBufferHeightGet;
+    pDisplay->pfnPixelDraw = GrFrameBufferPixelDraw;
+    pDisplay->pfnPixelDrawMultiple = GrFrameBufferPixelDrawMultiple;
+    pDisplay->pfnLineDrawH = GrFrameBufferLineDrawH;
+    pDisplay->pfnLineDrawV = GrFrameBufferLineDrawV;
+    pDisplay->pfnRectFill = GrFrameBufferRectFill;
+    pDisplay->pfnColorTranslate = GrFrameBufferColorTranslate;
+    pDisplay->pfnFlush = GrFrameBufferFlush;
+    pDisplay->pfnPixelBlend = GrFrameBufferPixelBlend;
+    pDisplay->pfnPixelRead = GrFrameBufferPixelRead;
+
+    GrFrameBufferStatsReset(pDisplay);
+}
+
+//*****************************************************************************
+//
+//! Sets the function called when the frame buffer is flushed.
+//!
+//! \param pDisplay is a pointer to the display structure of the frame buffer.
+//! \param pfnFlush is a pointer to the function to call, or 0 to make flushes
+//! a no operation.
+//!
+//! The function receives the flushed rectangle (clipped to the frame buffer),
+//! a pointer to its top-left pixel and the number of bytes between rows.  A
+//! host application may use it to copy the rectangle into a window or an
+//! image file.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+GrFrameBufferFlushSet(tDisplay *pDisplay, tFrameBufferFlush pfnFlush)
+{
+    ASSERT(pDisplay);
+
+    ((tFrameBuffer *)pDisplay->pvDisplayData)->pfnFlush = pfnFlush;
+}
+
+//*****************************************************************************
+//
+//! Gets the counters of the frame buffer driver activity.
+//!
+//! \param pDisplay is a pointer to the display structure of the frame buffer.
+//! \param psStats is a pointer to the structure to be filled with the
+//! counters.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+GrFrameBufferStatsGet(const tDisplay *pDisplay, tFrameBufferStats *psStats)
+{
+    ASSERT(pDisplay);
+    ASSERT(psStats);
+
+    *psStats = ((tFrameBuffer *)pDisplay->pvDisplayData)->sStats;
+}
+
+//*****************************************************************************
+//
+//! Resets the counters of the frame buffer driver activity.
+//!
+//! \param pDisplay is a pointer to the display structure of the frame buffer.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+GrFrameBufferStatsReset(tDisplay *pDisplay)
+{
+    tFrameBufferStats *psStats;
+
+    ASSERT(pDisplay);
+
+    psStats = &((tFrameBuffer *)pDisplay->pvDisplayData)->sStats;
+
+    psStats->ulPixelDrawCalls = 0;
+    psStats->ulPixelDrawMultipleCalls = 0;
+    psStats->ulLineDrawHCalls = 0;
+    psStats->ulLineDrawVCalls = 0;
+    psStats->ulRectFillCalls = 0;
+    psStats->ulPixelBlendCalls = 0;
+    psStats->ulColorTranslateCalls = 0;
+    psStats->ulFlushCalls = 0;
+    psStats->ulPixelsWritten = 0;
+    psStats->ulPixelsFlushed = 0;
+}
+
+//*****************************************************************************
+//
+// Close the Doxygen group.
+//! @}
+//
+//*****************************************************************************
@@ -0,0 +1,501 @@
+//*****************************************************************************
+//
+// gradient.c - Routines for filling areas with color gradients.
+//
+//*****************************************************************************
+
+#include "debug.h"
+#include "grlib.h"
+
+//*****************************************************************************
+//
+//! \addtogroup primitives_api
+//! @{
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// The number of two-color gradients drawn by GrRectGradientFill() whose colors
+// are kept, and the number of colors kept for each of them.  A gradient drawn
+// over a longer area has its colors computed as it is drawn.
+//
+//*****************************************************************************
+#ifndef GRLIB_GRADIENT_CACHE_ENTRIES
+#define GRLIB_GRADIENT_CACHE_ENTRIES    2
+#endif
+
+#ifndef GRLIB_GRADIENT_CACHE_SIZE
+#define GRLIB_GRADIENT_CACHE_SIZE       64
+#endif
+
+//*****************************************************************************
+//
+// The two-color gradients drawn by GrRectGradientFill(), with their stops and
+// their color tables, and the entry to be replaced next.
+//
+//*****************************************************************************
+static tGradient g_psGradientCache[GRLIB_GRADIENT_CACHE_ENTRIES];
+static tGradientStop g_psGradientCacheStops[GRLIB_GRADIENT_CACHE_ENTRIES][2];
+static unsigned long g_pulGradientCacheTables[GRLIB_GRADIENT_CACHE_ENTRIES]
+                                             [GRLIB_GRADIENT_CACHE_SIZE];
+static unsigned long g_ulGradientCacheNext;
+
+//*****************************************************************************
+//
+// Computes the 24-bit RGB color of a gradient at a given point along it.
+//
+//*****************************************************************************
+static unsigned long
+GradientColorGet(const tGradient *psGradient, unsigned long ulIndex,
+                 unsigned long ulLength)
+{
+	const tGradientStop *psStop;
+	unsigned long ulPos, ulStart, ulIdx, ulColor;
+	long lFrac, lFrom, lTo;
+	long lShift;
+
+	psStop = psGradient->psStops;
+
+	//
+	// Get the position of the point, in 1/256th of a stop position.
+	//
+	ulPos = (ulLength > 1) ?
+	        ((ulIndex * (GRADIENT_POS_END << 8)) / (ulLength - 1)) : 0;
+
+	//
+	// Before the first stop, the gradient has the color of that stop.
+	//
+	if(ulPos <= ((unsigned long)psStop[0].ucPosition << 8))
+	{
+		return(psStop[0].ulColor);
+	}
+
+	//
+	// Find the first stop at or after the point.  After the last stop, the
+	// gradient has the color of that stop.
+	//
+	for(ulIdx = 1; ulIdx < psGradient->ulStops; ulIdx++)
+	{
+		if(ulPos <= ((unsigned long)psStop[ulIdx].ucPosition << 8))
+		{
+			break;
+		}
+	}
+
+	if(ulIdx == psGradient->ulStops)
+	{
+		return(psStop[ulIdx - 1].ulColor);
+	}
+
+	//
+	// Blend the colors of the stops around the point, one component at a
+	// time.
+	//
+	ulStart = (unsigned long)psStop[ulIdx - 1].ucPosition << 8;
+	lFrac = (long)(((ulPos - ulStart) << 8) /
+	               (((unsigned long)psStop[ulIdx].ucPosition << 8) - ulStart));
+
+	ulColor = 0;
+
+	for(lShift = ClrRedShift; lShift >= 0; lShift -= 8)
+	{
+		lFrom = (psStop[ulIdx - 1].ulColor >> lShift) & 0xff;
+		lTo = (psStop[ulIdx].ulColor >> lShift) & 0xff;
+
+		ulColor |= (unsigned long)(lFrom + (((lTo - lFrom) * lFrac) / 256)) <<
+		           lShift;
+	}
+
+	return(ulColor);
+}
+
+//*****************************************************************************
+//
+// Gets the translated color of a gradient at a given point along it, from its
+// table if it holds the colors for this length.
+//
+//*****************************************************************************
+static unsigned long
+GradientEntryGet(const tGradient *psGradient, const tDisplay *pDisplay,
+                 unsigned long ulIndex, unsigned long ulLength)
+{
+	if(psGradient->ulLength == ulLength)
+	{
+		return(psGradient->pulTable[ulIndex]);
+	}
+
+	return(DpyColorTranslate(pDisplay,
+	                         GradientColorGet(psGradient, ulIndex, ulLength)));
+}
+
+//*****************************************************************************
+//
+//! Initializes a gradient.
+//!
+//! \param psGradient is a pointer to the gradient to initialize.
+//! \param ulDirection is the direction of the gradient; this is one of
+//! \b #GRADIENT_VERTICAL, \b #GRADIENT_HORIZONTAL or \b #GRADIENT_DIAGONAL.
+//! \param psStops is a pointer to the color stops of the gradient, ordered by
+//! position.
+//! \param ulStops is the number of color stops, which must be at least one.
+//! \param pulTable is a pointer to the table that receives the translated
+//! colors of the gradient, or zero for none.
+//! \param ulTableSize is the number of entries of the table.
+//!
+//! This function initializes a gradient, which can then be drawn with
+//! GrGradientFill().  The gradient keeps a pointer to \e psStops and
+//! \e pulTable, which must stay valid as long as it is used.
+//!
+//! The colors of the gradient are computed and translated for the display into
+//! the table when the gradient is drawn, and used again as long as it is drawn
+//! over areas of the same length: the height of the area for a vertical
+//! gradient, its width for a horizontal gradient, and the sum of both minus
+//! one for a diagonal gradient.  If the table is too small for the length, the
+//! colors are computed as the gradient is drawn.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+GrGradientInit(tGradient *psGradient, unsigned long ulDirection,
+               const tGradientStop *psStops, unsigned long ulStops,
+               unsigned long *pulTable, unsigned long ulTableSize)
+{
+	//
+	// Check the arguments.
+	//
+	ASSERT(psGradient);
+	ASSERT(psStops);
+	ASSERT(ulStops);
+
+	psGradient->ulDirection = ulDirection;
+	psGradient->psStops     = psStops;
+	psGradient->ulStops     = ulStops;
+	psGradient->pulTable    = pulTable;
+	psGradient->ulTableSize = pulTable ? ulTableSize : 0;
+	psGradient->ulLength    = 0;
+	psGradient->pDisplay    = 0;
+}
+
+//*****************************************************************************
+//
+//! Discards the colors kept by a gradient.
+//!
+//! \param psGradient is a pointer to the gradient.
+//!
+//! This function must be called after the color stops of a gradient have been
+//! changed, so that its colors are computed again.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+GrGradientInvalidate(tGradient *psGradient)
+{
+	psGradient->ulLength = 0;
+}
+
+//*****************************************************************************
+//
+//! Fills a rectangle with a gradient.
+//!
+//! \param pContext is a pointer to the drawing context to use.
+//! \param psGradient is a pointer to the gradient.
+//! \param pRect is a pointer to the structure containing the extents of the
+//! rectangle.
+//!
+//! This function fills a rectangle with a gradient, which goes from its first
+//! stop at one side or corner of the rectangle to its last stop at the
+//! opposite one.  The part of the rectangle within the clipping region is
+//! drawn, with the same colors as if it was drawn whole.
+//!
+//! The rows of a vertical gradient, or the columns of a horizontal gradient,
+//! that have the same color are filled together by a single call to the
+//! display driver, as are the runs of pixels of a row of a diagonal gradient.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+GrGradientFill(const tContext *pContext, tGradient *psGradient,
+               const tRectangle *pRect)
+{
+	unsigned long ulLength, ulIdx, ulColor;
+	long lX0, lY0, lStart, lEnd, lRow;
+	const tDisplay *pDisplay;
+	tRectangle sTemp, sRun;
+
+	//
+	// Check the arguments.
+	//
+	ASSERT(pContext);
+	ASSERT(psGradient);
+	ASSERT(pRect);
+
+	//
+	// Order the coordinates of the rectangle.
+	//
+	sTemp.sXMin = (pRect->sXMin < pRect->sXMax) ? pRect->sXMin : pRect->sXMax;
+	sTemp.sXMax = (pRect->sXMin < pRect->sXMax) ? pRect->sXMax : pRect->sXMin;
+	sTemp.sYMin = (pRect->sYMin < pRect->sYMax) ? pRect->sYMin : pRect->sYMax;
+	sTemp.sYMax = (pRect->sYMin < pRect->sYMax) ? pRect->sYMax : pRect->sYMin;
+
+	//
+	// The colors are placed relative to the whole rectangle, before it is
+	// clipped.
+	//
+	lX0 = sTemp.sXMin;
+	lY0 = sTemp.sYMin;
+
+	if(psGradient->ulDirection == GRADIENT_HORIZONTAL)
+	{
+		ulLength = sTemp.sXMax - sTemp.sXMin + 1;
+	}
+	else if(psGradient->ulDirection == GRADIENT_VERTICAL)
+	{
+		ulLength = sTemp.sYMax - sTemp.sYMin + 1;
+	}
+	else
+	{
+		ulLength = (sTemp.sXMax - sTemp.sXMin) + (sTemp.sYMax - sTemp.sYMin) + 1;
+	}
+
+	//
+	// Clip the rectangle, and return without drawing anything if it is out of
+	// the clipping region.
+	//
+	if(sTemp.sXMin < pContext->sClipRegion.sXMin)
+	{
+		sTemp.sXMin = pContext->sClipRegion.sXMin;
+	}
+	if(sTemp.sXMax > pContext->sClipRegion.sXMax)
+	{
+		sTemp.sXMax = pContext->sClipRegion.sXMax;
+	}
+	if(sTemp.sYMin < pContext->sClipRegion.sYMin)
+	{
+		sTemp.sYMin = pContext->sClipRegion.sYMin;
+	}
+	if(sTemp.sYMax > pContext->sClipRegion.sYMax)
+	{
+		sTemp.sYMax = pContext->sClipRegion.sYMax;
+	}
+
+	if((sTemp.sXMin > sTemp.sXMax) || (sTemp.sYMin > sTemp.sYMax))
+	{
+		return;
+	}
+
+	pDisplay = pContext->pDisplay;
+
+	//
+	// Compute the table of colors if it does not hold the colors for this
+	// length and this display, and it is large enough.
+	//
+	if((psGradient->ulLength != ulLength) ||
+	   (psGradient->pDisplay != pDisplay))
+	{
+		psGradient->ulLength = 0;
+
+		if(ulLength <= psGradient->ulTableSize)
+		{
+			for(ulIdx = 0; ulIdx < ulLength; ulIdx++)
+			{
+				psGradient->pulTable[ulIdx] =
+				    DpyColorTranslate(pDisplay,
+				                      GradientColorGet(psGradient, ulIdx,
+				                                       ulLength));
+			}
+
+			psGradient->ulLength = ulLength;
+			psGradient->pDisplay = pDisplay;
+		}
+	}
+
+	if(psGradient->ulDirection == GRADIENT_VERTICAL)
+	{
+		//
+		// Fill the runs of rows that have the same color.
+		//
+		sRun.sXMin = sTemp.sXMin;
+		sRun.sXMax = sTemp.sXMax;
+
+		for(lStart = sTemp.sYMin; lStart <= sTemp.sYMax; lStart = lEnd + 1)
+		{
+			ulColor = GradientEntryGet(psGradient, pDisplay, lStart - lY0,
+			                           ulLength);
+
+			for(lEnd = lStart;
+			    (lEnd < sTemp.sYMax) &&
+			    (GradientEntryGet(psGradient, pDisplay, lEnd + 1 - lY0,
+			                      ulLength) == ulColor);
+			    lEnd++)
+			{
+			}
+
+			if(lEnd == lStart)
+			{
+				DpyLineDrawH(pDisplay, sRun.sXMin, sRun.sXMax, lStart,
+				             ulColor);
+			}
+			else
+			{
+				sRun.sYMin = lStart;
+				sRun.sYMax = lEnd;
+				DpyRectFill(pDisplay, &sRun, ulColor);
+			}
+		}
+	}
+	else if(psGradient->ulDirection == GRADIENT_HORIZONTAL)
+	{
+		//
+		// Fill the runs of columns that have the same color.
+		//
+		sRun.sYMin = sTemp.sYMin;
+		sRun.sYMax = sTemp.sYMax;
+
+		for(lStart = sTemp.sXMin; lStart <= sTemp.sXMax; lStart = lEnd + 1)
+		{
+			ulColor = GradientEntryGet(psGradient, pDisplay, lStart - lX0,
+			                           ulLength);
+
+			for(lEnd = lStart;
+			    (lEnd < sTemp.sXMax) &&
+			    (GradientEntryGet(psGradient, pDisplay, lEnd + 1 - lX0,
+			                      ulLength) == ulColor);
+			    lEnd++)
+			{
+			}
+
+			if(lEnd == lStart)
+			{
+				DpyLineDrawV(pDisplay, lStart, sRun.sYMin, sRun.sYMax,
+				             ulColor);
+			}
+			else
+			{
+				sRun.sXMin = lStart;
+				sRun.sXMax = lEnd;
+				DpyRectFill(pDisplay, &sRun, ulColor);
+			}
+		}
+	}
+	else
+	{
+		//
+		// Fill the runs of pixels of each row that have the same color.  The
+		// color of a pixel depends on the sum of its coordinates, so each row
+		// uses the colors of the previous one, shifted by one.
+		//
+		for(lRow = sTemp.sYMin; lRow <= sTemp.sYMax; lRow++)
+		{
+			for(lStart = sTemp.sXMin; lStart <= sTemp.sXMax; lStart = lEnd + 1)
+			{
+				ulIdx = (lStart - lX0) + (lRow - lY0);
+				ulColor = GradientEntryGet(psGradient, pDisplay, ulIdx,
+				                           ulLength);
+
+				for(lEnd = lStart;
+				    (lEnd < sTemp.sXMax) &&
+				    (GradientEntryGet(psGradient, pDisplay, ++ulIdx,
+				                      ulLength) == ulColor);
+				    lEnd++)
+				{
+				}
+
+				DpyLineDrawH(pDisplay, lStart, lEnd, lRow, ulColor);
+			}
+		}
+	}
+}
+
+//*****************************************************************************
+//
+//! Draws a rectangle filled by linear gradient.
+//!
+//! \param pContext is a pointer to the drawing context to use.
+//! \param pRect is a pointer to the structure containing the extents of the
+//! rectangle.
+//!
+//! This function fills a rectangle with a vertical gradient, from the first
+//! gradient color of the context (see GrContextGradientSet()) at the top to
+//! the second one at the bottom.
+//!
+//! The colors of the last GRLIB_GRADIENT_CACHE_ENTRIES gradients drawn are
+//! kept, so that drawing the same gradient again over a rectangle of the same
+//! height, such as another button of the same size, does not compute or
+//! translate any color.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+GrRectGradientFill( tContext *pContext, const tRectangle *pRect )
+{
+	unsigned long ulIdx, ulHeight;
+	tGradient *psGradient;
+
+	//
+	// Check the arguments.
+	//
+	ASSERT(pContext);
+	ASSERT(pRect);
+
+	ulHeight = ((pRect->sYMax > pRect->sYMin) ?
+	            (pRect->sYMax - pRect->sYMin) :
+	            (pRect->sYMin - pRect->sYMax)) + 1;
+
+	//
+	// Look for this gradient among the ones kept, preferring one whose colors
+	// have been computed for this height.
+	//
+	psGradient = 0;
+
+	for(ulIdx = 0; ulIdx < GRLIB_GRADIENT_CACHE_ENTRIES; ulIdx++)
+	{
+		if(g_psGradientCache[ulIdx].psStops &&
+		   (g_psGradientCacheStops[ulIdx][0].ulColor ==
+		    pContext->ulGradient1) &&
+		   (g_psGradientCacheStops[ulIdx][1].ulColor ==
+		    pContext->ulGradient2))
+		{
+			psGradient = &g_psGradientCache[ulIdx];
+
+			if(psGradient->ulLength == ulHeight)
+			{
+				break;
+			}
+		}
+	}
+
+	//
+	// Otherwise, replace the gradient kept the longest.
+	//
+	if(!psGradient)
+	{
+		ulIdx = g_ulGradientCacheNext;
+		g_ulGradientCacheNext = (ulIdx + 1) % GRLIB_GRADIENT_CACHE_ENTRIES;
+
+		g_psGradientCacheStops[ulIdx][0].ulColor = pContext->ulGradient1;
+		g_psGradientCacheStops[ulIdx][0].ucPosition = 0;
+		g_psGradientCacheStops[ulIdx][1].ulColor = pContext->ulGradient2;
+		g_psGradientCacheStops[ulIdx][1].ucPosition = GRADIENT_POS_END;
+
+		psGradient = &g_psGradientCache[ulIdx];
+
+		GrGradientInit(psGradient, GRADIENT_VERTICAL,
+		               g_psGradientCacheStops[ulIdx], 2,
+		               g_pulGradientCacheTables[ulIdx],
+		               GRLIB_GRADIENT_CACHE_SIZE);
+	}
+
+	GrGradientFill(pContext, psGradient, pRect);
+}
+
+//*****************************************************************************
+//
+// Close the Doxygen group.
+//! @}
+//
+//*****************************************************************************
@@ -39,7 +39,11 @@ extern "C"
 //*****************************************************************************
 //
 //! This message is sent to widget for update itself on the display.
-//! Neither \e ulParam1 nor \e ulParam2 are used by this message.
+//! Neither \e ulParam1 nor \e ulParam2 are used by this message when it is
+//! delivered to a widget.  When it is posted without any flags, \e ulParam1
+//! and \e ulParam2 are the upper left and lower right corners of the area to
+//! repaint, relative to the widget and packed with MSG_PARAM_POINT(), or are
+//! both zero for the whole widget.
 //! This message is delivered in top-down order.
 //
 //*****************************************************************************
@@ -166,6 +170,15 @@ extern "C"
 //*****************************************************************************
 #define WIDGET_NOTIFY_CHANGE        0x0000000D
 
+//*****************************************************************************
+//
+//! This message is sent to a widget when one of its timers expires (see
+//! WidgetTimer::Start()).  \e ulParam1 is the pointer to the timer that has
+//! expired.  \e ulParam2 is not used by this message.
+//
+//*****************************************************************************
+#define WIDGET_MSG_TIMER            0x0000000E
+
 //*****************************************************************************
 //
 //! This structure defines the extents of a rectangle.  All points greater than
@@ -197,6 +210,56 @@ typedef struct
 }
 tRectangle;
 
+//*****************************************************************************
+//
+//! This structure defines a point, such as a vertex of a polygon.
+//
+//*****************************************************************************
+typedef struct
+{
+    //
+    //! The X coordinate of the point.
+    //
+    short sX;
+
+    //
+    //! The Y coordinate of the point.
+    //
+    short sY;
+}
+tPoint;
+
+//*****************************************************************************
+//
+//! The largest number of separate rectangles held by a set of dirty
+//! rectangles.  When a new rectangle does not fit, it is merged with the
+//! rectangle that grows the least.
+//
+//*****************************************************************************
+#ifndef GRLIB_DIRTY_RECTS
+#define GRLIB_DIRTY_RECTS       8
+#endif
+
+//*****************************************************************************
+//
+//! This structure holds a set of areas of the display, such as the areas that
+//! need to be flushed or repainted (see GrDirtyRectSetAdd()).
+//
+//*****************************************************************************
+typedef struct
+{
+    //
+    //! The number of valid entries of psRects.
+    //
+    unsigned long ulCount;
+
+    //
+    //! The areas of the set, which do not contain each other.
+    //
+    tRectangle psRects[GRLIB_DIRTY_RECTS];
+}
+tDirtyRectSet;
+
 
 //*****************************************************************************
 //
@@ -863,83 +926,110 @@ tGrLibDefaults;
 //*****************************************************************************
 typedef struct
 {
+    //
+    //! A pointer to the driver-specific data for this display, which is
+    //! passed as the first argument to each of the functions below.
+    //
+    void *pvDisplayData;
+
     //
     //! A pointer to the function to enable this display.
     //
-    void (*pfnEnable)(void);
+    void (*pfnEnable)(void *pvDisplayData);
 
     //
     //! A pointer to the function to disable this display.
     //
-    void (*pfnDisable)(void);
+    void (*pfnDisable)(void *pvDisplayData);
 
     //
     //! A pointer to the function to set backlight state of this display.
     //
-    void (*pfnBacklightStateSet)(unsigned short usNewState);
+    void (*pfnBacklightStateSet)(void *pvDisplayData,
+                                 unsigned short usNewState);
 
     //
     //! A pointer to the function to get backlight state of this display.
     //
-    unsigned short (*pfnBacklightStateGet)(void);
+    unsigned short (*pfnBacklightStateGet)(void *pvDisplayData);
 
     //
     //! A pointer to the function to set an orientation of this display.
     //
-    void (*pfnOrientationSet)(unsigned short usNewOrientation);
+    void (*pfnOrientationSet)(void *pvDisplayData,
+                              unsigned short usNewOrientation);
 
     //
     //! A pointer to the function to get an orientation of this display.
     //
-    unsigned short (*pfnOrientationGet)(void);
+    unsigned short (*pfnOrientationGet)(void *pvDisplayData);
 
     //
     //! A pointer to the function to get a width of this display.
     //
-    unsigned short (*pfnWidthGet)(void);
+    unsigned short (*pfnWidthGet)(void *pvDisplayData);
 
     //
     //! A pointer to the function to get a height of this display.
     //
-    unsigned short (*pfnHeightGet)(void);
+    unsigned short (*pfnHeightGet)(void *pvDisplayData);
 
     //
     //! A pointer to the function to draw a pixel on this display.
     //
-    void (*pfnPixelDraw)(long lX, long lY, unsigned long ulValue);
+    void (*pfnPixelDraw)(void *pvDisplayData, long lX, long lY,
+                         unsigned long ulValue);
 
     //
     //! A pointer to the function to draw multiple pixels on this display.
     //
-    void (*pfnPixelDrawMultiple)(long lX, long lY, long lX0, long lCount,
-    		                     long lBPP, const unsigned char *pucData,
+    void (*pfnPixelDrawMultiple)(void *pvDisplayData, long lX, long lY,
+                                 long lX0, long lCount, long lBPP,
+                                 const unsigned char *pucData,
                                  const unsigned char *pucPalette);
 
     //
     //! A pointer to the function to draw a horizontal line on this display.
     //
-    void (*pfnLineDrawH)(long lX1, long lX2, long lY, unsigned long ulValue);
+    void (*pfnLineDrawH)(void *pvDisplayData, long lX1, long lX2, long lY,
+                         unsigned long ulValue);
 
     //
     //! A pointer to the function to draw a vertical line on this display.
     //
-    void (*pfnLineDrawV)(long lX, long lY1, long lY2, unsigned long ulValue);
+    void (*pfnLineDrawV)(void *pvDisplayData, long lX, long lY1, long lY2,
+                         unsigned long ulValue);
 
     //
     //! A pointer to the function to draw a filled rectangle on this display.
     //
-    void (*pfnRectFill)(tRectangle *pRect, unsigned long ulValue);
+    void (*pfnRectFill)(void *pvDisplayData, tRectangle *pRect,
+                        unsigned long ulValue);
 
     //
     //! A pointer to the function to translate 24-bit RGB colors to
     //! display-specific colors.
     //
-    unsigned long (*pfnColorTranslate)(unsigned long ulValue);
+    unsigned long (*pfnColorTranslate)(void *pvDisplayData,
+                                       unsigned long ulValue);
 
     //
     //! A pointer to the function to flush rectangle area to this display.
     //
-    void (*pfnFlush)(tRectangle *pRect);
+    void (*pfnFlush)(void *pvDisplayData, tRectangle *pRect);
+
+    //
+    //! A pointer to the function to blend a 24-bit RGB color into a pixel of
+    //! this display, or zero if the display cannot blend pixels.
+    //
+    void (*pfnPixelBlend)(void *pvDisplayData, long lX, long lY,
+                          unsigned long ulValue, unsigned long ulAlpha);
+
+    //
+    //! A pointer to the function to read back a pixel of this display as a
+    //! 24-bit RGB color, or zero if the display cannot read back pixels.
+    //
+    unsigned long (*pfnPixelRead)(void *pvDisplayData, long lX, long lY);
 
 } tDisplay;
 
@@ -953,7 +1043,7 @@ typedef struct
 //
 //*****************************************************************************
 #define DisplayEnable() \
-	(&g_sDisplay)->pfnEnable()
+	(&g_sDisplay)->pfnEnable((&g_sDisplay)->pvDisplayData)
 
 //*****************************************************************************
 //
@@ -965,7 +1055,7 @@ typedef struct
 //
 //*****************************************************************************
 #define DisplayDisable() \
-	(&g_sDisplay)->pfnDisable()
+	(&g_sDisplay)->pfnDisable((&g_sDisplay)->pvDisplayData)
 
 //*****************************************************************************
 //
@@ -979,7 +1069,8 @@ typedef struct
 //
 //*****************************************************************************
 #define DisplayBacklightStateSet(usNewState) \
-	(&g_sDisplay)->pfnBacklightStateSet(usNewState)
+	(&g_sDisplay)->pfnBacklightStateSet((&g_sDisplay)->pvDisplayData, \
+	                                   usNewState)
 
 //*****************************************************************************
 //
@@ -991,7 +1082,7 @@ typedef struct
 //
 //*****************************************************************************
 #define DisplayBacklightStateGet() \
-	((&g_sDisplay)->pfnBacklightStateGet())
+	((&g_sDisplay)->pfnBacklightStateGet((&g_sDisplay)->pvDisplayData))
 
 //*****************************************************************************
 //
@@ -1005,7 +1096,8 @@ typedef struct
 //
 //*****************************************************************************
 #define DisplayOrientationSet(usNewState) \
-	(&g_sDisplay)->pfnOrientationSet(usNewState)
+	(&g_sDisplay)->pfnOrientationSet((&g_sDisplay)->pvDisplayData, \
+	                                usNewState)
 
 //*****************************************************************************
 //
@@ -1017,7 +1109,7 @@ typedef struct
 //
 //*****************************************************************************
 #define DisplayOrientationGet() \
-	((&g_sDisplay)->pfnOrientationGet())
+	((&g_sDisplay)->pfnOrientationGet((&g_sDisplay)->pvDisplayData))
 
 //*****************************************************************************
 //
@@ -1029,7 +1121,7 @@ typedef struct
 //
 //*****************************************************************************
 #define DisplayWidthGet() \
-	((&g_sDisplay)->pfnWidthGet())
+	((&g_sDisplay)->pfnWidthGet((&g_sDisplay)->pvDisplayData))
 
 //*****************************************************************************
 //
@@ -1041,7 +1133,7 @@ typedef struct
 //
 //*****************************************************************************
 #define DisplayHeightGet() \
-	((&g_sDisplay)->pfnHeightGet())
+	((&g_sDisplay)->pfnHeightGet((&g_sDisplay)->pvDisplayData))
 
 //*****************************************************************************
 //
@@ -1058,7 +1150,8 @@ typedef struct
 //
 //*****************************************************************************
 #define DisplayPixelDraw(lX, lY, ulValue) \
-		(&g_sDisplay)->pfnPixelDraw(lX, lY, ulValue)
+		(&g_sDisplay)->pfnPixelDraw((&g_sDisplay)->pvDisplayData, lX, lY, \
+		                            ulValue)
 
 //*****************************************************************************
 //
@@ -1085,8 +1178,9 @@ typedef struct
 //*****************************************************************************
 #define DisplayPixelDrawMultiple(lX, lY, lX0, lCount, lBPP,       \
                                  pucData, pucPalette)             \
-	(&g_sDisplay)->pfnPixelDrawMultiple(lX, lY, lX0, lCount, lBPP, \
-                                       pucData, pucPalette)
+	(&g_sDisplay)->pfnPixelDrawMultiple((&g_sDisplay)->pvDisplayData,  \
+	                                    lX, lY, lX0, lCount, lBPP,     \
+	                                    pucData, pucPalette)
 
 //*****************************************************************************
 //
@@ -1104,7 +1198,8 @@ typedef struct
 //
 //*****************************************************************************
 #define DisplayLineDrawH(lX1, lX2, lY, ulValue) \
-	(&g_sDisplay)->pfnLineDrawH(lX1, lX2, lY, ulValue)
+	(&g_sDisplay)->pfnLineDrawH((&g_sDisplay)->pvDisplayData, lX1, lX2, lY, \
+	                            ulValue)
 
 //*****************************************************************************
 //
@@ -1122,7 +1217,8 @@ typedef struct
 //
 //*****************************************************************************
 #define DisplayLineDrawV(lX, lY1, lY2, ulValue) \
-	(&g_sDisplay)->pfnLineDrawV(lX, lY1, lY2, ulValue)
+	(&g_sDisplay)->pfnLineDrawV((&g_sDisplay)->pvDisplayData, lX, lY1, lY2, \
+	                            ulValue)
 
 //*****************************************************************************
 //
@@ -1140,7 +1236,7 @@ typedef struct
 //
 //*****************************************************************************
 #define DisplayRectFill(pRect, ulValue) \
-	(&g_sDisplay)->pfnRectFill(pRect, ulValue)
+	(&g_sDisplay)->pfnRectFill((&g_sDisplay)->pvDisplayData, pRect, ulValue)
 
 //*****************************************************************************
 //
@@ -1158,7 +1254,7 @@ typedef struct
 //
 //*****************************************************************************
 #define DisplayColorTranslate(ulValue) \
-	((&g_sDisplay)->pfnColorTranslate(ulValue))
+	((&g_sDisplay)->pfnColorTranslate((&g_sDisplay)->pvDisplayData, ulValue))
 
 //*****************************************************************************
 //
@@ -1174,7 +1270,346 @@ typedef struct
 //
 //*****************************************************************************
 #define DisplayFlush(pRect) \
-	(&g_sDisplay)->pfnFlush(pRect)
+	(&g_sDisplay)->pfnFlush((&g_sDisplay)->pvDisplayData, pRect)
+
+//*****************************************************************************
+//
+//! Blends a color into a pixel of this display.
+//!
+//! \param lX is the X coordinate of the pixel.
+//! \param lY is the Y coordinate of the pixel.
+//! \param ulValue is the 24-bit RGB color to blend.
+//! \param ulAlpha is the opacity of the color, from 0 (transparent) to
+//! \b #GR_ALPHA_OPAQUE.
+//!
+//! This function blends a color into the given pixel.  The coordinates of the
+//! pixel are assumed to be within the extents of the display, and the display
+//! is assumed to provide this function.
+//!
+//! \return None.
+//
+//*****************************************************************************
+#define DisplayPixelBlend(lX, lY, ulValue, ulAlpha) \
+	(&g_sDisplay)->pfnPixelBlend((&g_sDisplay)->pvDisplayData, lX, lY, \
+	                             ulValue, ulAlpha)
+
+//*****************************************************************************
+//
+//! Reads back a pixel of this display.
+//!
+//! \param lX is the X coordinate of the pixel.
+//! \param lY is the Y coordinate of the pixel.
+//!
+//! This function reads back the color of the given pixel.  The coordinates of
+//! the pixel are assumed to be within the extents of the display, and the
+//! display is assumed to provide this function.
+//!
+//! \return Returns the 24-bit RGB color of the pixel.
+//
+//*****************************************************************************
+#define DisplayPixelRead(lX, lY) \
+	((&g_sDisplay)->pfnPixelRead((&g_sDisplay)->pvDisplayData, lX, lY))
+
+//*****************************************************************************
+//
+// The Dpy* macros below call the functions of a given display structure.
+// The drawing primitives use them with the display of their drawing context,
+// which lets several contexts draw to different displays (such as the panel
+// and an off-screen buffer) at the same time.  The Display* macros above are
+// the same functions applied to g_sDisplay.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+//! Enables a display.
+//!
+//! \param pDisplay is a pointer to the display structure.
+//!
+//! This function enables the display.
+//!
+//! \return None.
+//
+//*****************************************************************************
+#define DpyEnable(pDisplay) \
+        (pDisplay)->pfnEnable((pDisplay)->pvDisplayData)
+
+//*****************************************************************************
+//
+//! Disables a display.
+//!
+//! \param pDisplay is a pointer to the display structure.
+//!
+//! This function disables the display.
+//!
+//! \return None.
+//
+//*****************************************************************************
+#define DpyDisable(pDisplay) \
+        (pDisplay)->pfnDisable((pDisplay)->pvDisplayData)
+
+//*****************************************************************************
+//
+//! Sets the backlight state of a display.
+//!
+//! \param pDisplay is a pointer to the display structure.
+//! \param usNewState is the new state of the backlight.
+//!
+//! This function sets the state of the display backlight.
+//!
+//! \return None.
+//
+//*****************************************************************************
+#define DpyBacklightStateSet(pDisplay, usNewState) \
+        (pDisplay)->pfnBacklightStateSet((pDisplay)->pvDisplayData,        \
+                                         usNewState)
+
+//*****************************************************************************
+//
+//! Gets the backlight state of a display.
+//!
+//! \param pDisplay is a pointer to the display structure.
+//!
+//! This function gets the state of the display backlight.
+//!
+//! \return Returns the state of the backlight.
+//
+//*****************************************************************************
+#define DpyBacklightStateGet(pDisplay) \
+        ((pDisplay)->pfnBacklightStateGet((pDisplay)->pvDisplayData))
+
+//*****************************************************************************
+//
+//! Sets the orientation of a display.
+//!
+//! \param pDisplay is a pointer to the display structure.
+//! \param usNewOrientation is the new orientation of the display.
+//!
+//! This function sets the orientation of the display.
+//!
+//! \return None.
+//
+//*****************************************************************************
+#define DpyOrientationSet(pDisplay, usNewOrientation) \
+        (pDisplay)->pfnOrientationSet((pDisplay)->pvDisplayData,           \
+                                      usNewOrientation)
+
+//*****************************************************************************
+//
+//! Gets the orientation of a display.
+//!
+//! \param pDisplay is a pointer to the display structure.
+//!
+//! This function gets the orientation of the display.
+//!
+//! \return Returns the orientation of the display.
+//
+//*****************************************************************************
+#define DpyOrientationGet(pDisplay) \
+        ((pDisplay)->pfnOrientationGet((pDisplay)->pvDisplayData))
+
+//*****************************************************************************
+//
+//! Gets the width of a display.
+//!
+//! \param pDisplay is a pointer to the display structure.
+//!
+//! This function gets the width of the display.
+//!
+//! \return Returns the width of the display in pixels.
+//
+//*****************************************************************************
+#define DpyWidthGet(pDisplay) \
+        ((pDisplay)->pfnWidthGet((pDisplay)->pvDisplayData))
+
+//*****************************************************************************
+//
+//! Gets the height of a display.
+//!
+//! \param pDisplay is a pointer to the display structure.
+//!
+//! This function gets the height of the display.
+//!
+//! \return Returns the height of the display in pixels.
+//
+//*****************************************************************************
+#define DpyHeightGet(pDisplay) \
+        ((pDisplay)->pfnHeightGet((pDisplay)->pvDisplayData))
+
+//*****************************************************************************
+//
+//! Draws a pixel on a display.
+//!
+//! \param pDisplay is a pointer to the display structure.
+//! \param lX is the X coordinate of the pixel.
+//! \param lY is the Y coordinate of the pixel.
+//! \param ulValue is the display driver-specific color of the pixel.
+//!
+//! This function draws a pixel on the display.  The coordinates of the pixel
+//! are assumed to be within the extents of the display.
+//!
+//! \return None.
+//
+//*****************************************************************************
+#define DpyPixelDraw(pDisplay, lX, lY, ulValue) \
+        (pDisplay)->pfnPixelDraw((pDisplay)->pvDisplayData, lX, lY, ulValue)
+
+//*****************************************************************************
+//
+//! Draws a horizontal sequence of pixels on a display.
+//!
+//! \param pDisplay is a pointer to the display structure.
+//! \param lX is the X coordinate of the first pixel.
+//! \param lY is the Y coordinate of the first pixel.
+//! \param lX0 is sub-pixel offset within the pixel data, which is valid for 1
+//! or 4 bit per pixel formats.
+//! \param lCount is the number of pixels to draw.
+//! \param lBPP is the number of bits per pixel; must be 1, 4, or 8.
+//! \param pucData is a pointer to the pixel data.
+//! \param pucPalette is a pointer to the palette used to draw the pixels.
+//!
+//! This function draws a horizontal sequence of pixels on the display, using
+//! the supplied palette.  See DisplayPixelDrawMultiple() for the details of
+//! the pixel data and palette.
+//!
+//! \return None.
+//
+//*****************************************************************************
+#define DpyPixelDrawMultiple(pDisplay, lX, lY, lX0, lCount, lBPP,       \
+                             pucData, pucPalette)                       \
+        (pDisplay)->pfnPixelDrawMultiple((pDisplay)->pvDisplayData, lX, lY, \
+                                         lX0, lCount, lBPP, pucData,        \
+                                         pucPalette)
+
+//*****************************************************************************
+//
+//! Draws a horizontal line on a display.
+//!
+//! \param pDisplay is a pointer to the display structure.
+//! \param lX1 is the starting X coordinate of the line.
+//! \param lX2 is the ending X coordinate of the line.
+//! \param lY is the Y coordinate of the line.
+//! \param ulValue is the display driver-specific color of the line.
+//!
+//! This function draws a horizontal line on the display.  The coordinates of
+//! the line are assumed to be within the extents of the display.
+//!
+//! \return None.
+//
+//*****************************************************************************
+#define DpyLineDrawH(pDisplay, lX1, lX2, lY, ulValue) \
+        (pDisplay)->pfnLineDrawH((pDisplay)->pvDisplayData, lX1, lX2, lY, \
+                                 ulValue)
+
+//*****************************************************************************
+//
+//! Draws a vertical line on a display.
+//!
+//! \param pDisplay is a pointer to the display structure.
+//! \param lX is the X coordinate of the line.
+//! \param lY1 is the starting Y coordinate of the line.
+//! \param lY2 is the ending Y coordinate of the line.
+//! \param ulValue is the display driver-specific color of the line.
+//!
+//! This function draws a vertical line on the display.  The coordinates of
+//! the line are assumed to be within the extents of the display.
+//!
+//! \return None.
+//
+//*****************************************************************************
+#define DpyLineDrawV(pDisplay, lX, lY1, lY2, ulValue) \
+        (pDisplay)->pfnLineDrawV((pDisplay)->pvDisplayData, lX, lY1, lY2, \
+                                 ulValue)
+
+//*****************************************************************************
+//
+//! Fills a rectangle on a display.
+//!
+//! \param pDisplay is a pointer to the display structure.
+//! \param pRect is a pointer to the structure describing the rectangle.
+//! \param ulValue is the display driver-specific color of the rectangle.
+//!
+//! This function fills a rectangle on the display.  The coordinates of the
+//! rectangle are assumed to be within the extents of the display, and the
+//! rectangle specification is fully inclusive.
+//!
+//! \return None.
+//
+//*****************************************************************************
+#define DpyRectFill(pDisplay, pRect, ulValue) \
+        (pDisplay)->pfnRectFill((pDisplay)->pvDisplayData, pRect, ulValue)
+
+//*****************************************************************************
+//
+//! Translates a 24-bit RGB color to a display driver-specific color.
+//!
+//! \param pDisplay is a pointer to the display structure.
+//! \param ulValue is the 24-bit RGB color.
+//!
+//! This function translates a 24-bit RGB color into a value that can be
+//! written into the frame buffer of the display.
+//!
+//! \return Returns the display-driver specific color.
+//
+//*****************************************************************************
+#define DpyColorTranslate(pDisplay, ulValue) \
+        ((pDisplay)->pfnColorTranslate((pDisplay)->pvDisplayData, ulValue))
+
+//*****************************************************************************
+//
+//! Flushes a rectangle area to a display.
+//!
+//! \param pDisplay is a pointer to the display structure.
+//! \param pRect is a pointer to the rectangle to be flushed.
+//!
+//! This function flushes the rectangle area of a local frame buffer, if the
+//! display driver uses one, to the display.
+//!
+//! \return None.
+//
+//*****************************************************************************
+#define DpyFlush(pDisplay, pRect) \
+        (pDisplay)->pfnFlush((pDisplay)->pvDisplayData, pRect)
+
+//*****************************************************************************
+//
+//! Blends a color into a pixel of a display.
+//!
+//! \param pDisplay is a pointer to the display structure.
+//! \param lX is the X coordinate of the pixel.
+//! \param lY is the Y coordinate of the pixel.
+//! \param ulValue is the 24-bit RGB color to blend.
+//! \param ulAlpha is the opacity of the color, from 0 (transparent) to
+//! \b #GR_ALPHA_OPAQUE.
+//!
+//! This function blends a color into a pixel of the display.  The coordinates
+//! of the pixel are assumed to be within the extents of the display, and the
+//! display is assumed to provide this function.
+//!
+//! \return None.
+//
+//*****************************************************************************
+#define DpyPixelBlend(pDisplay, lX, lY, ulValue, ulAlpha) \
+        (pDisplay)->pfnPixelBlend((pDisplay)->pvDisplayData, lX, lY,      \
+                                  ulValue, ulAlpha)
+
+//*****************************************************************************
+//
+//! Reads back a pixel of a display.
+//!
+//! \param pDisplay is a pointer to the display structure.
+//! \param lX is the X coordinate of the pixel.
+//! \param lY is the Y coordinate of the pixel.
+//!
+//! This function reads back the color of a pixel of the display.  The
+//! coordinates of the pixel are assumed to be within the extents of the
+//! display, and the display is assumed to provide this function.
+//!
+//! \return Returns the 24-bit RGB color of the pixel.
+//
+//*****************************************************************************
+#define DpyPixelRead(pDisplay, lX, lY) \
+        ((pDisplay)->pfnPixelRead((pDisplay)->pvDisplayData, lX, lY))
 
 //*****************************************************************************
 //
@@ -1193,6 +1628,11 @@ typedef struct _tContext
     //
     long lSize;
 
+    //
+    //! The screen onto which drawing operations are performed.
+    //
+    const tDisplay *pDisplay;
+
     //
     //! The clipping region to be used when drawing onto the screen.
     //
@@ -1203,6 +1643,13 @@ typedef struct _tContext
     //
     unsigned long ulForeground;
 
+    //
+    //! The color used to draw primitives onto the screen, as a 24-bit RGB
+    //! color, for the primitives that blend it into the display, or
+    //! \b #GR_RGB_UNKNOWN if it was set already translated.
+    //
+    unsigned long ulForegroundRGB;
+
     //
     //! The background color used to draw primitives onto the screen.
     //
@@ -1262,6 +1709,15 @@ typedef struct _tContext
 }
 tContext;
 
+//*****************************************************************************
+//
+//! The value of the 24-bit RGB foreground color of a context whose foreground
+//! color was set with GrContextForegroundSetTranslated(), which cannot be
+//! blended into the display.
+//
+//*****************************************************************************
+#define GR_RGB_UNKNOWN          0xffffffff
+
 //*****************************************************************************
 //
 //! Sets the background color to be used.
@@ -1275,12 +1731,12 @@ tContext;
 //! \return None.
 //
 //*****************************************************************************
-#define GrContextBackgroundSet(pContext, ulValue)              \
-        do                                                     \
-        {                                                      \
-            tContext *pC = pContext;                           \
-            pC->ulBackground = DisplayColorTranslate(ulValue); \
-        }                                                      \
+#define GrContextBackgroundSet(pContext, ulValue)                            \
+        do                                                                   \
+        {                                                                    \
+            tContext *pC = pContext;                                         \
+            pC->ulBackground = DpyColorTranslate(pC->pDisplay, ulValue);     \
+        }                                                                    \
         while(0)
 
 //*****************************************************************************
@@ -1319,7 +1775,7 @@ tContext;
 //
 //*****************************************************************************
 #define GrContextDisplayWidthGet(pContext)      \
-        (DisplayWidthGet())
+        (DpyWidthGet((pContext)->pDisplay))
 
 //*****************************************************************************
 //
@@ -1334,7 +1790,7 @@ tContext;
 //
 //*****************************************************************************
 #define GrContextDisplayHeightGet(pContext)      \
-        (DisplayHeightGet())
+        (DpyHeightGet((pContext)->pDisplay))
 
 #ifdef GRLIB_REMOVE_WIDE_FONT_SUPPORT
 //*****************************************************************************
@@ -1380,7 +1836,9 @@ extern void GrContextFontSet(tContext *pContext, const tFont *pFnt);
         do                                                                   \
         {                                                                    \
             tContext *pC = pContext;                                         \
-            pC->ulForeground = DisplayColorTranslate(ulValue);               \
+            pC->ulForegroundRGB = ulValue;                                   \
+            pC->ulForeground = DpyColorTranslate(pC->pDisplay,               \
+                                                 pC->ulForegroundRGB);       \
         }                                                                    \
         while(0)
 
@@ -1422,6 +1880,10 @@ extern void GrContextFontSet(tContext *pContext, const tFont *pFnt);
 //! translated to a driver-specific color (for example, via
 //! DisplayColorTranslate()).
 //!
+//! The anti-aliased primitives blend the 24-bit RGB foreground color into the
+//! display, which this function marks as unknown; it must be set with
+//! GrContextForegroundSet() before they are used.
+//!
 //! \return None.
 //
 //*****************************************************************************
@@ -1430,6 +1892,7 @@ extern void GrContextFontSet(tContext *pContext, const tFont *pFnt);
         {                                                   \
             tContext *pC = pContext;                        \
             pC->ulForeground = ulValue;                     \
+            pC->ulForegroundRGB = GR_RGB_UNKNOWN;           \
         }                                                   \
         while(0)
 
@@ -1451,7 +1914,7 @@ extern void GrContextFontSet(tContext *pContext, const tFont *pFnt);
         do                                                   \
         {                                                    \
             const tContext *pC = pContext;                   \
-            DisplayFlush(&(pC->sClipRegion));                \
+            DpyFlush(pC->pDisplay, &(pC->sClipRegion));      \
         }                                                    \
         while(0)
 
@@ -1597,6 +2060,343 @@ extern void GrContextFontSet(tContext *pContext, const tFont *pFnt);
 #define GrOffScreen8BPPSize(lWidth, lHeight) \
         (6 + (256 * 3) + (lWidth * lHeight))
 
+//*****************************************************************************
+//
+//! Determines the size of the buffer for a 16 BPP off-screen image.
+//!
+//! \param lWidth is the width of the image in pixels.
+//! \param lHeight is the height of the image in pixels.
+//!
+//! This function determines the size of the memory buffer required to hold a
+//! 16 BPP (RGB565) off-screen image of the specified geometry, including
+//! the header that holds the geometry in front of the pixels.
+//!
+//! \return Returns the number of bytes required by the image.
+//
+//*****************************************************************************
+#define GrOffScreen16BPPSize(lWidth, lHeight) \
+        ((2 + ((lWidth) * (lHeight))) * sizeof(unsigned short))
+
+//*****************************************************************************
+//
+//! Determines the size of the buffer for a 32 BPP off-screen image.
+//!
+//! \param lWidth is the width of the image in pixels.
+//! \param lHeight is the height of the image in pixels.
+//!
+//! This function determines the size of the memory buffer required to hold a
+//! 32 BPP (ARGB8888) off-screen image of the specified geometry, including
+//! the header that holds the geometry in front of the pixels.
+//!
+//! \return Returns the number of bytes required by the image.
+//
+//*****************************************************************************
+#define GrOffScreen32BPPSize(lWidth, lHeight) \
+        ((1 + ((lWidth) * (lHeight))) * sizeof(unsigned long))
+
+//*****************************************************************************
+//
+//! Indicates that the frame buffer stores each pixel as a 16-bit RGB565
+//! value.
+//
+//*****************************************************************************
+#define FRAMEBUFFER_FMT_RGB565  0x00000010
+
+//*****************************************************************************
+//
+//! Indicates that the frame buffer stores each pixel as a 24-bit RGB value in
+//! the low bits of a 32-bit word.
+//
+//*****************************************************************************
+#define FRAMEBUFFER_FMT_RGB888  0x00000018
+
+//*****************************************************************************
+//
+//! Determines the size of the buffer for a frame buffer display.
+//!
+//! \param lWidth is the width of the frame buffer in pixels.
+//! \param lHeight is the height of the frame buffer in pixels.
+//! \param ulFormat is the pixel format, one of FRAMEBUFFER_FMT_xxx.
+//!
+//! This function determines the size of the memory buffer required to hold a
+//! frame buffer of the specified geometry and pixel format.
+//!
+//! \return Returns the number of bytes required by the frame buffer.
+//
+//*****************************************************************************
+#define GrFrameBufferSize(lWidth, lHeight, ulFormat)                  \
+        (((ulFormat) == FRAMEBUFFER_FMT_RGB565) ?                     \
+         ((lWidth) * (lHeight) * sizeof(unsigned short)) :            \
+         ((lWidth) * (lHeight) * sizeof(unsigned long)))
+
+//*****************************************************************************
+//
+//! The prototype of the function called by the frame buffer display driver
+//! when a rectangle is flushed.  \e pRect is the flushed rectangle, clipped to
+//! the frame buffer, \e pucPixels points to its top-left pixel, and \e lStride
+//! is the number of bytes between two adjacent rows.
+//
+//*****************************************************************************
+typedef void (*tFrameBufferFlush)(const tRectangle *pRect,
+                                  const unsigned char *pucPixels,
+                                  long lStride);
+
+//*****************************************************************************
+//
+//! This structure holds the counters of the frame buffer display driver
+//! activity.  They are used to measure how much driver traffic a drawing
+//! operation generates.
+//
+//*****************************************************************************
+typedef struct
+{
+    //
+    //! The number of calls to the pixel draw function.
+    //
+    unsigned long ulPixelDrawCalls;
+
+    //
+    //! The number of calls to the multiple pixel draw function.
+    //
+    unsigned long ulPixelDrawMultipleCalls;
+
+    //
+    //! The number of calls to the horizontal line draw function.
+    //
+    unsigned long ulLineDrawHCalls;
+
+    //
+    //! The number of calls to the vertical line draw function.
+    //
+    unsigned long ulLineDrawVCalls;
+
+    //
+    //! The number of calls to the rectangle fill function.
+    //
+    unsigned long ulRectFillCalls;
+
+    //
+    //! The number of calls to the pixel blend function.
+    //
+    unsigned long ulPixelBlendCalls;
+
+    //
+    //! The number of colors translated.
+    //
+    unsigned long ulColorTranslateCalls;
+
+    //
+    //! The number of calls to the flush function that flushed any pixels.
+    //
+    unsigned long ulFlushCalls;
+
+    //
+    //! The number of pixels written into the frame buffer.
+    //
+    unsigned long ulPixelsWritten;
+
+    //
+    //! The number of pixels flushed from the frame buffer.
+    //
+    unsigned long ulPixelsFlushed;
+}
+tFrameBufferStats;
+
+//*****************************************************************************
+//
+//! This structure holds the state of one frame buffer display.  The
+//! application provides one for each frame buffer, and GrFrameBufferInit()
+//! makes it the driver-specific data of the display structure.  The members
+//! are private to the frame buffer driver.
+//
+//*****************************************************************************
+typedef struct
+{
+    //
+    //! A pointer to the pixel memory of the frame buffer.
+    //
+    unsigned char *pucBuffer;
+
+    //
+    //! The width of the frame buffer in pixels.
+    //
+    long lWidth;
+
+    //
+    //! The height of the frame buffer in pixels.
+    //
+    long lHeight;
+
+    //
+    //! The number of bytes between the starts of two adjacent rows.
+    //
+    long lStride;
+
+    //
+    //! The pixel format of the frame buffer, one of FRAMEBUFFER_FMT_xxx.
+    //
+    unsigned long ulFormat;
+
+    //
+    //! The backlight state, kept only so that it can be read back.
+    //
+    unsigned short usBacklightState;
+
+    //
+    //! The orientation, kept only so that it can be read back.
+    //
+    unsigned short usOrientation;
+
+    //
+    //! The function called when a rectangle is flushed, if any.
+    //
+    tFrameBufferFlush pfnFlush;
+
+    //
+    //! The counters of the driver activity.
+    //
+    tFrameBufferStats sStats;
+}
+tFrameBuffer;
+
+//*****************************************************************************
+//
+//! The directions of a gradient: from the top to the bottom, from the left to
+//! the right, or from the top-left corner to the bottom-right corner.
+//
+//*****************************************************************************
+#define GRADIENT_VERTICAL       0x00000000
+#define GRADIENT_HORIZONTAL     0x00000001
+#define GRADIENT_DIAGONAL       0x00000002
+
+//*****************************************************************************
+//
+//! The position of the last stop of a gradient, which is at its end; the first
+//! one is at position 0, at its start.
+//
+//*****************************************************************************
+#define GRADIENT_POS_END        255
+
+//*****************************************************************************
+//
+//! This structure describes a color stop of a gradient.
+//
+//*****************************************************************************
+typedef struct
+{
+    //
+    //! The 24-bit RGB color of the gradient at this stop.
+    //
+    unsigned long ulColor;
+
+    //
+    //! The position of this stop along the gradient, from 0 to
+    //! GRADIENT_POS_END.
+    //
+    unsigned char ucPosition;
+}
+tGradientStop;
+
+//*****************************************************************************
+//
+//! This structure describes a gradient, along with the table of its colors,
+//! already translated for the display, which is kept for the length it was
+//! last drawn with.  A gradient drawn over areas of the same length, such as
+//! buttons of the same height, computes its colors only once.
+//
+//*****************************************************************************
+typedef struct
+{
+    //
+    //! The direction of the gradient; this is one of GRADIENT_xxx.
+    //
+    unsigned long ulDirection;
+
+    //
+    //! A pointer to the color stops of the gradient, ordered by position.
+    //
+    const tGradientStop *psStops;
+
+    //
+    //! The number of color stops.
+    //
+    unsigned long ulStops;
+
+    //
+    //! A pointer to the table of translated colors, or zero to compute the
+    //! colors as the gradient is drawn.
+    //
+    unsigned long *pulTable;
+
+    //
+    //! The number of entries of the table.
+    //
+    unsigned long ulTableSize;
+
+    //
+    //! The length the table has been computed for, or zero if it has not.
+    //
+    unsigned long ulLength;
+
+    //
+    //! The display the table has been translated for.
+    //
+    const tDisplay *pDisplay;
+}
+tGradient;
+
+//*****************************************************************************
+//
+//! The opacity of a fully opaque color, when blending it into a pixel.
+//
+//*****************************************************************************
+#define GR_ALPHA_OPAQUE         255
+
+//*****************************************************************************
+//
+//! The angles of the arc primitives.  An angle is a fixed-point fraction of a
+//! turn, of which there are GR_ANGLE_360 units; it grows clockwise on the
+//! screen, starting from the right of the center.
+//
+//*****************************************************************************
+#define GR_ANGLE_0              0x00000000
+#define GR_ANGLE_90             0x00004000
+#define GR_ANGLE_180            0x00008000
+#define GR_ANGLE_270            0x0000c000
+#define GR_ANGLE_360            0x00010000
+
+//*****************************************************************************
+//
+//! Converts an angle in degrees to an angle of the arc primitives.
+//!
+//! \param lDegrees is the angle, in degrees.
+//!
+//! \return Returns the angle, in units of GR_ANGLE_360 to the turn.
+//
+//*****************************************************************************
+#define GrAngleFromDegrees(lDegrees) \
+        (((long)(lDegrees) * GR_ANGLE_360) / 360)
+
+//*****************************************************************************
+//
+//! The value of a sine or a cosine of 1, as returned by GrAngleSin() and
+//! GrAngleCos().
+//
+//*****************************************************************************
+#define GR_SIN_ONE              0x00008000
+
+//*****************************************************************************
+//
+//! Computes the cosine of an angle.
+//!
+//! \param lAngle is the angle, in units of GR_ANGLE_360 to the turn.
+//!
+//! \return Returns the cosine of the angle, in units of GR_SIN_ONE.
+//
+//*****************************************************************************
+#define GrAngleCos(lAngle) \
+        GrAngleSin((lAngle) + GR_ANGLE_90)
+
 //*****************************************************************************
 //
 //! Draws a pixel.
@@ -1619,7 +2419,7 @@ extern void GrContextFontSet(tContext *pContext, const tFont *pFnt);
                (lY >= pC->sClipRegion.sYMin) &&                           \
                (lY <= pC->sClipRegion.sYMax))                             \
             {                                                             \
-                DisplayPixelDraw(lX, lY, pC->ulForeground);               \
+                DpyPixelDraw(pC->pDisplay, lX, lY, pC->ulForeground);     \
             }                                                             \
         }                                                                 \
         while(0)
@@ -2030,12 +2830,25 @@ extern  const unsigned char g_pucDoslike15pt[];
 #define NumLeadingZeros(x)      __CLZ(x)
 #endif
 #if defined(codered) || defined(gcc) || defined(sourcerygxx)
+#if defined(__arm__) || defined(__thumb__)
 #define NumLeadingZeros(x) __extension__                        \
         ({                                                      \
             register unsigned long __ret, __inp = x;            \
             __asm__("clz %0, %1" : "=r" (__ret) : "r" (__inp)); \
             __ret;                                              \
         })
+#else
+//
+// Host builds (see HOST in makedefs) have no "clz" instruction, so use the
+// compiler builtin.  The builtin is undefined for zero, whereas "clz" returns
+// 32, so that case is handled explicitly.
+//
+#define NumLeadingZeros(x) __extension__                        \
+        ({                                                      \
+            unsigned int __inp = (unsigned int)(x);             \
+            (unsigned long)(__inp ? __builtin_clz(__inp) : 32); \
+        })
+#endif
 #endif
 #if defined(rvmdk) || defined(__ARMCC_VERSION)
 #define NumLeadingZeros(x)      __clz(x)
@@ -2060,8 +2873,27 @@ extern void GrCircleDraw(const tContext *pContext, long lX, long lY,
                          long lRadius);
 extern void GrCircleFill(const tContext *pContext, long lX, long lY,
                          long lRadius);
+extern void GrEllipseFill(const tContext *pContext, long lX, long lY,
+                          long lRadiusX, long lRadiusY);
+extern void GrRoundRectFill(const tContext *pContext, const tRectangle *pRect,
+                            long lRadius);
+extern void GrCircleDrawAA(const tContext *pContext, long lX, long lY,
+                           long lRadius);
+extern void GrArcDrawAA(const tContext *pContext, long lX, long lY,
+                        long lRadius, long lStartAngle, long lEndAngle);
+extern void GrArcDraw(const tContext *pContext, long lX, long lY,
+                      long lRadius, long lStartAngle, long lEndAngle);
+extern void GrPieFill(const tContext *pContext, long lX, long lY,
+                      long lRadius, long lStartAngle, long lEndAngle);
+extern void GrRingFill(const tContext *pContext, long lX, long lY,
+                       long lInnerRadius, long lOuterRadius,
+                       long lStartAngle, long lEndAngle);
+extern long GrAngleSin(long lAngle);
 extern void GrContextClipRegionSet(tContext *pContext, tRectangle *pRect);
 extern void GrContextInit(tContext *pContext);
+
+extern void GrContextDisplaySet(tContext *pContext, const tDisplay *pDisplay);
+
 extern void GrImageDraw(const tContext *pContext,
                         const unsigned char *pucImage, long lX, long lY);
 extern void GrTransparentImageDraw(const tContext *pContext,
@@ -2072,23 +2904,56 @@ extern void GrLineDraw(const tContext *pContext, long lX1, long lY1, long lX2,
                        long lY2);
 extern void GrLineDrawH(const tContext *pContext, long lX1, long lX2, long lY);
 extern void GrLineDrawV(const tContext *pContext, long lX, long lY1, long lY2);
-//extern void GrOffScreen1BPPInit(tDisplay *pDisplay, unsigned char *pucImage,
-//                                long lWidth, long lHeight);
-//extern void GrOffScreen4BPPInit(tDisplay *pDisplay, unsigned char *pucImage,
-//                                long lWidth, long lHeight);
-//extern void GrOffScreen4BPPPaletteSet(tDisplay *pDisplay,
-//                                      unsigned long *pulPalette,
-//                                      unsigned long ulOffset,
-//                                      unsigned long ulCount);
-//extern void GrOffScreen8BPPInit(tDisplay *pDisplay, unsigned char *pucImage,
-//                                long lWidth, long lHeight);
-//extern void GrOffScreen8BPPPaletteSet(tDisplay *pDisplay,
-//                                      unsigned long *pulPalette,
-//                                      unsigned long ulOffset,
-//                                      unsigned long ulCount);
+extern void GrLineDrawAA(const tContext *pContext, long lX1, long lY1,
+                         long lX2, long lY2);
+extern void GrOffScreen1BPPInit(tDisplay *pDisplay, unsigned char *pucImage,
+                                long lWidth, long lHeight);
+extern void GrOffScreen4BPPInit(tDisplay *pDisplay, unsigned char *pucImage,
+                                long lWidth, long lHeight);
+extern void GrOffScreen4BPPPaletteSet(tDisplay *pDisplay,
+                                      unsigned long *pulPalette,
+                                      unsigned long ulOffset,
+                                      unsigned long ulCount);
+extern void GrOffScreen8BPPInit(tDisplay *pDisplay, unsigned char *pucImage,
+                                long lWidth, long lHeight);
+extern void GrOffScreen8BPPPaletteSet(tDisplay *pDisplay,
+                                      unsigned long *pulPalette,
+                                      unsigned long ulOffset,
+                                      unsigned long ulCount);
+extern void GrOffScreen16BPPInit(tDisplay *pDisplay, unsigned char *pucImage,
+                                 long lWidth, long lHeight);
+extern void GrOffScreen16BPPDraw(const tContext *pContext,
+                                 const unsigned char *pucImage, long lX,
+                                 long lY);
+extern void GrOffScreen32BPPInit(tDisplay *pDisplay, unsigned char *pucImage,
+                                 long lWidth, long lHeight);
+extern void GrOffScreen32BPPDraw(const tContext *pContext,
+                                 const unsigned char *pucImage, long lX,
+                                 long lY);
+extern void GrDirtyRectAdd(const tRectangle *pRect);
+extern void GrDirtyRectSetAdd(tDirtyRectSet *psSet, const tRectangle *pRect);
+extern unsigned long GrDirtyRectCountGet(void);
+extern void GrDirtyRectFlush(const tDisplay *pDisplay);
+extern void GrFrameBufferInit(tDisplay *pDisplay, tFrameBuffer *psFrameBuffer,
+                              void *pvBuffer, long lWidth, long lHeight,
+                              unsigned long ulFormat);
+extern void GrFrameBufferFlushSet(tDisplay *pDisplay,
+                                  tFrameBufferFlush pfnFlush);
+extern void GrFrameBufferStatsGet(const tDisplay *pDisplay,
+                                  tFrameBufferStats *psStats);
+extern void GrFrameBufferStatsReset(tDisplay *pDisplay);
+extern void GrPolygonFill(const tContext *pContext, const tPoint *psPoints,
+                          unsigned long ulCount);
 extern void GrRectDraw(const tContext *pContext, const tRectangle *pRect);
 extern void GrRectFill(const tContext *pContext, const tRectangle *pRect);
 extern void GrRectGradientFill( tContext *pContext, const tRectangle *pRect );
+extern void GrGradientInit(tGradient *psGradient, unsigned long ulDirection,
+                           const tGradientStop *psStops,
+                           unsigned long ulStops, unsigned long *pulTable,
+                           unsigned long ulTableSize);
+extern void GrGradientInvalidate(tGradient *psGradient);
+extern void GrGradientFill(const tContext *pContext, tGradient *psGradient,
+                           const tRectangle *pRect);
 extern unsigned long
 GrGradientRowColorGet( short sRow, const tRectangle *pRect,
 								unsigned long ulColor1, unsigned long ulColor2 );
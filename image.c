@@ -197,9 +197,9 @@ PixelTransparentDraw(const tContext *pContext, long lX, long lY,
                 {
                     lDraw = ((lOff + lOn) > lLen) ? (lX + lLen) :
                             (lX + lOff + lOn);
-                    DisplayLineDrawH(lX + lOff, lDraw - 1, lY,
+                    DpyLineDrawH(pContext->pDisplay, lX + lOff, lDraw - 1, lY,
                                  *(unsigned long *)(pucPalette +
-                                 (ulTransparent ? 0 : 4)));
+                                                    (ulTransparent ? 0 : 4)));
                 }
 
                 //
@@ -280,7 +280,7 @@ PixelTransparentDraw(const tContext *pContext, long lX, long lY,
                         //
                         // Yes - draw what we have.
                         //
-                        DisplayPixelDrawMultiple(lX + lStart,
+                        DpyPixelDrawMultiple(pContext->pDisplay, lX + lStart,
                                              lY, lStartX0, lLen, 4,
                                              &pucData[(lStart + lBit) / 2],
                                              pucPalette);
@@ -300,7 +300,7 @@ PixelTransparentDraw(const tContext *pContext, long lX, long lY,
             //
             if(!bSkip && lLen)
             {
-                DisplayPixelDrawMultiple(lX + lStart,
+                DpyPixelDrawMultiple(pContext->pDisplay, lX + lStart,
                                      lY, lStartX0, lLen, 4,
                                      &pucData[(lStart + lBit) / 2],
                                      pucPalette);
@@ -363,7 +363,7 @@ PixelTransparentDraw(const tContext *pContext, long lX, long lY,
                         //
                         // Yes - draw what we have.
                         //
-                        DisplayPixelDrawMultiple(lX + lStart,
+                        DpyPixelDrawMultiple(pContext->pDisplay, lX + lStart,
                                              lY, 0, lLen, 8,
                                              &pucData[lStart], pucPalette);
 
@@ -382,7 +382,7 @@ PixelTransparentDraw(const tContext *pContext, long lX, long lY,
             //
             if(!bSkip && lLen)
             {
-                DisplayPixelDrawMultiple(lX + lStart,
+                DpyPixelDrawMultiple(pContext->pDisplay, lX + lStart,
                                      lY, lX0, lLen, 8,
                                      &pucData[lStart], pucPalette);
             }
@@ -579,7 +579,7 @@ InternalImageDraw(const tContext *pContext, const unsigned char *pucImage,
             }
             else
             {
-                DisplayPixelDrawMultiple(lX + lX0, lY, lXMask,
+                DpyPixelDrawMultiple(pContext->pDisplay, lX + lX0, lY, lXMask,
                                      lX2 - lX0 + 1, lBPP,
                                      pucImage + ((lX0 * lBPP) / 8), pucPalette);
             }
@@ -806,10 +806,11 @@ InternalImageDraw(const tContext *pContext, const unsigned char *pucImage,
                             }
                             else
                             {
-                                DisplayPixelDrawMultiple(lX + lX1, lY, lXMask,
-                                                         ulNum, lBPP,
-                                                         g_pucDictionary + ulIdx,
-                                                         pucPalette);
+                                DpyPixelDrawMultiple(pContext->pDisplay,
+                                                     lX + lX1, lY, lXMask,
+                                                     ulNum, lBPP,
+                                                     g_pucDictionary + ulIdx,
+                                                     pucPalette);
                             }
                         }
 
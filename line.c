@@ -93,7 +93,7 @@ GrLineDrawH(const tContext *pContext, long lX1, long lX2, long lY)
     //
     // Call the low level horizontal line drawing routine.
     //
-    DisplayLineDrawH(lX1, lX2, lY, pContext->ulForeground);
+    DpyLineDrawH(pContext->pDisplay, lX1, lX2, lY, pContext->ulForeground);
 }
 
 //*****************************************************************************
@@ -175,7 +175,7 @@ GrLineDrawV(const tContext *pContext, long lX, long lY1, long lY2)
     //
     // Call the low level vertical line drawing routine.
     //
-    DisplayLineDrawV(lX, lY1, lY2, pContext->ulForeground);
+    DpyLineDrawV(pContext->pDisplay, lX, lY1, lY2, pContext->ulForeground);
 }
 
 //*****************************************************************************
@@ -571,14 +571,14 @@ GrLineDraw(const tContext *pContext, long lX1, long lY1, long lX2, long lY2)
             //
             // Plot this point of the line, swapping the X and Y coordinates.
             //
-            DisplayPixelDraw(lY1, lX1, pContext->ulForeground);
+            DpyPixelDraw(pContext->pDisplay, lY1, lX1, pContext->ulForeground);
         }
         else
         {
             //
             // Plot this point of the line, using the coordinates as is.
             //
-            DisplayPixelDraw(lX1, lY1, pContext->ulForeground);
+            DpyPixelDraw(pContext->pDisplay, lX1, lY1, pContext->ulForeground);
         }
 
         //
@@ -1,6 +1,6 @@
 //*****************************************************************************
 //
-// mqueue.h - Prototypes for the message queue class
+// mqueue.h - Lock-free message queue template
 //
 //*****************************************************************************
 
@@ -9,101 +9,377 @@
 
 //*****************************************************************************
 //
-// Start of the C bindings section for C++ compilers
+// Message queue class
 //
-//*****************************************************************************
-#ifdef __cplusplus
-extern "C"
-{
-#endif
-
-//*****************************************************************************
+// This is a bounded ring of items of type T, holding up to ulSize items, where
+// ulSize is a power of two.  Items are added by any number of producers (or
+// by a single one, if bMultiProducer is false, which saves an atomic
+// compare-and-swap per item) and removed by a single consumer, without any
+// lock, so that it can be written from interrupt handlers and threads while
+// it is being read.
 //
-// Message queue class
+// Each slot holds a sequence number that tells which position of the ring it
+// currently stands for and what state it is in.  Sequence numbers step by two
+// per position, so that a slot in use is told apart by its odd value.  For the
+// slot of position ulPos, the sequence number is:
+//
+// - 2 * ulPos when the slot is free and can be written by a producer,
+// - 2 * ulPos + 2 when the slot holds an item that can be read by the
+//   consumer,
+// - 2 * ulPos + 1 while a producer or the consumer is accessing an item
+//   already in the queue,
+// - 2 * (ulPos + ulSize) once the item has been read, so that the slot is free
+//   for the next lap of the ring.
+//
+// An odd value is never expected by a producer or the consumer, so a party
+// holding a stale position cannot mistake a slot in use for an item of an
+// earlier lap.
+//
+// The sequence numbers are written with release and read with acquire
+// ordering, so that the contents of a slot are visible to whoever sees its
+// new sequence number.  Items are copied by assignment, one machine word at
+// a time, rather than byte per byte.
 //
 //*****************************************************************************
+template <class T, unsigned long ulSize, bool bMultiProducer = true>
 class MQueue
 {
 public:
 	//
 	// Constructs a message queue object
 	//
-	MQueue(unsigned long ulItemSize, unsigned long ulItemsCount);
+	MQueue(void);
 
 	//
 	// Enqueues a new message
 	//
-	long EnQueue(void *pMsgPtr);
+	long EnQueue(const T *pItem);
 
 	//
 	// Dequeues a message
 	//
-	long DeQueue(void *pMsgPtr);
+	long DeQueue(T *pItem);
 
 	//
-	// Shows a message from queue wihout dequeuing
+	// Merges a new message into the last message of the queue
 	//
-	long Show(void *pMsgPtr);
+	long TailUpdate(const T *pItem, long (*pfnMerge)(T *pTail, const T *pItem));
 
 	//
-	// Overwrites a message in queue
+	// Updates every message of the queue
 	//
-	long OverWrite(void *pMsgPtr);
+	void Update(const T *pItem, void (*pfnUpdate)(T *pOld, const T *pItem));
 
 	//
-	// Destructs a message queue object
+	// Determines if the queue is empty
 	//
-	~MQueue(void);
+	long IsEmpty(void);
 
 private:
 	//
-	// Attempts to acquire a mutex
+	// The queue size must be a power of two, so that positions are mapped to
+	// slots with a mask and wrap around cleanly.
+	//
+	typedef char tSizeCheck[((ulSize >= 2) &&
+	                         ((ulSize & (ulSize - 1)) == 0)) ? 1 : -1];
+
+	//
+	// A slot of the ring
 	//
-	long MutexGet(void);
+	typedef struct
+	{
+		//
+		// The sequence number of the slot
+		//
+		unsigned long ulSeq;
+
+		//
+		// The message held by the slot
+		//
+		T sItem;
+	}
+	tSlot;
 
 	//
-	// Release a mutex
+	// The slots of the ring
 	//
-	void MutexPut(void);
+	tSlot psSlots[ulSize];
 
 	//
-	// Pointer to the message queue
+	// The position of the next message to be written to the queue
 	//
-	void *pMQ;
+	unsigned long ulWritePos;
 
 	//
-	// Size of the message item in queue
+	// The position of the next message to be read from the queue; this is
+	// only accessed by the consumer
 	//
-	unsigned long ulItemSize;
+	unsigned long ulReadPos;
+};
+
+//*****************************************************************************
+//
+// Constructs a message queue object
+//
+//*****************************************************************************
+template <class T, unsigned long ulSize, bool bMultiProducer>
+MQueue<T, ulSize, bMultiProducer>::MQueue(void)
+{
+	unsigned long ulIdx;
 
 	//
-	// Number of all messages to be queued
+	// Set initial values; every slot is free for its first lap
 	//
-	unsigned long ulItemsCount;
+	for(ulIdx = 0; ulIdx < ulSize; ulIdx++)
+	{
+		this->psSlots[ulIdx].ulSeq = 2 * ulIdx;
+	}
+
+	this->ulWritePos = 0;
+	this->ulReadPos  = 0;
+}
+
+//*****************************************************************************
+//
+// Enqueues a new message
+//
+// Returns 1 if the message was added, or 0 if the queue is full.
+//
+//*****************************************************************************
+template <class T, unsigned long ulSize, bool bMultiProducer>
+long
+MQueue<T, ulSize, bMultiProducer>::EnQueue(const T *pItem)
+{
+	unsigned long ulPos, ulSeq;
+	tSlot *psSlot;
+
+	ulPos = __atomic_load_n(&this->ulWritePos, __ATOMIC_RELAXED);
+
+	for(;;)
+	{
+		psSlot = &this->psSlots[ulPos & (ulSize - 1)];
+		ulSeq = __atomic_load_n(&psSlot->ulSeq, __ATOMIC_ACQUIRE);
+
+		//
+		// Is the message queue full?
+		//
+		if((long)(ulSeq - (2 * ulPos)) < 0)
+		{
+			return 0;
+		}
+
+		//
+		// Is the slot free for this position?
+		//
+		if(ulSeq == (2 * ulPos))
+		{
+			//
+			// A single producer owns the write position
+			//
+			if(!bMultiProducer)
+			{
+				__atomic_store_n(&this->ulWritePos, ulPos + 1,
+				                 __ATOMIC_RELAXED);
+				break;
+			}
+
+			//
+			// Claim the position, unless another producer got it first (in
+			// which case ulPos is reloaded)
+			//
+			if(__atomic_compare_exchange_n(&this->ulWritePos, &ulPos,
+			                               ulPos + 1, 0, __ATOMIC_RELAXED,
+			                               __ATOMIC_RELAXED))
+			{
+				break;
+			}
+		}
+		else
+		{
+			//
+			// Another producer has already written this position
+			//
+			ulPos = __atomic_load_n(&this->ulWritePos, __ATOMIC_RELAXED);
+		}
+	}
 
 	//
-	// The index of a message to be read from the message queue
+	// Write this message into the slot and hand it over to the consumer
 	//
-	unsigned long ulReadPtr;
+	psSlot->sItem = *pItem;
+
+	__atomic_store_n(&psSlot->ulSeq, (2 * ulPos) + 2, __ATOMIC_RELEASE);
+
+	return 1;
+}
+
+//*****************************************************************************
+//
+// Dequeues a message
+//
+// Returns 1 if a message was removed, or 0 if the queue is empty or the
+// oldest message is still being written or updated by a producer; in the
+// latter case IsEmpty() returns 0, so that the caller tries again.
+//
+//*****************************************************************************
+template <class T, unsigned long ulSize, bool bMultiProducer>
+long
+MQueue<T, ulSize, bMultiProducer>::DeQueue(T *pItem)
+{
+	unsigned long ulPos, ulSeq;
+	tSlot *psSlot;
+
+	ulPos = this->ulReadPos;
+	psSlot = &this->psSlots[ulPos & (ulSize - 1)];
 
 	//
-	// The index of a message to be written to the message queue
+	// Take the message out of reach of TailUpdate() while it is copied
 	//
-	unsigned long ulWritePtr;
+	ulSeq = (2 * ulPos) + 2;
+
+	if(!__atomic_compare_exchange_n(&psSlot->ulSeq, &ulSeq, (2 * ulPos) + 1,
+	                                0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+	{
+		return 0;
+	}
 
 	//
-	// The mutex that used to protect access to the message queue
+	// Copy the contents of this message
 	//
-	unsigned char ucMutex;
-};
+	*pItem = psSlot->sItem;
+
+	//
+	// Free the slot for the next lap of the ring
+	//
+	__atomic_store_n(&psSlot->ulSeq, 2 * (ulPos + ulSize), __ATOMIC_RELEASE);
+
+	this->ulReadPos = ulPos + 1;
+
+	return 1;
+}
 
 //*****************************************************************************
 //
-// End of the C bindings section for C++ compilers
+// Merges a new message into the last message of the queue
+//
+// The last message of the queue, if it has not been read yet, is passed to
+// pfnMerge along with the new message.  pfnMerge may update the last message
+// in place and returns non-zero if the new message was merged into it, or
+// zero if the new message must be queued separately.  No message can be
+// added or read while pfnMerge runs.
+//
+// Returns the value returned by pfnMerge, or 0 if the queue is empty or its
+// last message cannot be accessed.
 //
 //*****************************************************************************
-#ifdef __cplusplus
+template <class T, unsigned long ulSize, bool bMultiProducer>
+long
+MQueue<T, ulSize, bMultiProducer>::TailUpdate(const T *pItem,
+                                   long (*pfnMerge)(T *pTail, const T *pItem))
+{
+	unsigned long ulPos, ulSeq;
+	tSlot *psSlot;
+	long lRet;
+
+	//
+	// Claim the slot of the last message written
+	//
+	ulPos = __atomic_load_n(&this->ulWritePos, __ATOMIC_ACQUIRE) - 1;
+	psSlot = &this->psSlots[ulPos & (ulSize - 1)];
+
+	ulSeq = (2 * ulPos) + 2;
+
+	if(!__atomic_compare_exchange_n(&psSlot->ulSeq, &ulSeq, (2 * ulPos) + 1,
+	                                0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+	{
+		return 0;
+	}
+
+	//
+	// Give up if another producer has added a message meanwhile, since the
+	// claimed message is no longer the last one
+	//
+	if(bMultiProducer &&
+	   (__atomic_load_n(&this->ulWritePos, __ATOMIC_ACQUIRE) != (ulPos + 1)))
+	{
+		__atomic_store_n(&psSlot->ulSeq, (2 * ulPos) + 2, __ATOMIC_RELEASE);
+
+		return 0;
+	}
+
+	lRet = pfnMerge(&psSlot->sItem, pItem);
+
+	//
+	// Hand the message back to the consumer
+	//
+	__atomic_store_n(&psSlot->ulSeq, (2 * ulPos) + 2, __ATOMIC_RELEASE);
+
+	return lRet;
+}
+
+//*****************************************************************************
+//
+// Updates every message of the queue
+//
+// Each message of the queue that has not been read yet is passed to pfnUpdate
+// along with pItem, and may be changed in place; this is how the consumer
+// cancels messages that must not be delivered any more.  This must only be
+// called by the consumer.  Messages still being written or merged by a
+// producer are skipped.
+//
+//*****************************************************************************
+template <class T, unsigned long ulSize, bool bMultiProducer>
+void
+MQueue<T, ulSize, bMultiProducer>::Update(const T *pItem,
+                                   void (*pfnUpdate)(T *pOld, const T *pItem))
+{
+	unsigned long ulPos, ulEnd, ulSeq;
+	tSlot *psSlot;
+
+	ulEnd = __atomic_load_n(&this->ulWritePos, __ATOMIC_ACQUIRE);
+
+	for(ulPos = this->ulReadPos; ulPos != ulEnd; ulPos++)
+	{
+		psSlot = &this->psSlots[ulPos & (ulSize - 1)];
+
+		//
+		// Take the message out of reach of TailUpdate() while it is changed
+		//
+		ulSeq = (2 * ulPos) + 2;
+
+		if(!__atomic_compare_exchange_n(&psSlot->ulSeq, &ulSeq,
+		                                (2 * ulPos) + 1, 0, __ATOMIC_ACQUIRE,
+		                                __ATOMIC_RELAXED))
+		{
+			continue;
+		}
+
+		pfnUpdate(&psSlot->sItem, pItem);
+
+		__atomic_store_n(&psSlot->ulSeq, (2 * ulPos) + 2, __ATOMIC_RELEASE);
+	}
+}
+
+//*****************************************************************************
+//
+// Determines if the queue is empty
+//
+// This must only be called by the consumer.  A message that is still being
+// written or updated by a producer is counted, even though it cannot be read
+// yet, so that the consumer does not go to sleep while it is pending.
+//
+// Returns 1 if there is no message in the queue, and 0 otherwise.
+//
+//*****************************************************************************
+template <class T, unsigned long ulSize, bool bMultiProducer>
+long
+MQueue<T, ulSize, bMultiProducer>::IsEmpty(void)
+{
+	//
+	// Every position below the write position has been claimed by a producer
+	//
+	return(__atomic_load_n(&this->ulWritePos, __ATOMIC_ACQUIRE) ==
+	       this->ulReadPos);
 }
-#endif
 
 #endif /* __MQUEUE_H__ */
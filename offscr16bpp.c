@@ -0,0 +1,779 @@
+//*****************************************************************************
+//
+// offscr16bpp.c - 16 BPP (RGB565) off-screen display buffer driver.
+//
+//*****************************************************************************
+
+#include "debug.h"
+#include "grlib.h"
+
+//*****************************************************************************
+//
+//! \addtogroup primitives_api
+//! @{
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// Converts a 24-bit RGB color to a 16-bit RGB565 pixel.
+//
+//*****************************************************************************
+#define DPYCOLORTRANSLATE(c)    ((((c) & 0x00f80000) >> 8) |                  \
+                                 (((c) & 0x0000fc00) >> 5) |                  \
+                                 (((c) & 0x000000f8) >> 3))
+
+//*****************************************************************************
+//
+// Converts a 16-bit RGB565 pixel back to a 24-bit RGB color, replicating the
+// upper bits of each channel into its lower bits so that white stays white.
+//
+//*****************************************************************************
+#define DPYCOLORUNTRANSLATE(p)  (((((p) & 0xf800) << 8) |                     \
+                                  (((p) & 0xe000) << 3)) |                    \
+                                 ((((p) & 0x07e0) << 5) |                     \
+                                  (((p) & 0x0600) >> 1)) |                    \
+                                 ((((p) & 0x001f) << 3) |                     \
+                                  (((p) & 0x001c) >> 2)))
+
+//*****************************************************************************
+//
+// A 16 BPP image begins with a header of two half-words, holding the width
+// and the height of the image in pixels, which is followed by the RGB565
+// pixels of the image in row-major order.  The header is the driver-specific
+// data of the display, so each image carries its own geometry.
+//
+//*****************************************************************************
+#define IMAGEWIDTH(pvImage)     (((const unsigned short *)(pvImage))[0])
+#define IMAGEHEIGHT(pvImage)    (((const unsigned short *)(pvImage))[1])
+#define IMAGEPIXELS(pvImage)    ((unsigned short *)(pvImage) + 2)
+
+//*****************************************************************************
+//
+//! Translates a 24-bit RGB color to a display driver-specific color.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//! \param ulValue is the 24-bit RGB color.  The least-significant byte is the
+//! blue channel, the next byte is the green channel, and the third byte is the
+//! red channel.
+//!
+//! This function translates a 24-bit RGB color into a 16-bit RGB565 value
+//! that can be written into the off-screen buffer.
+//!
+//! \return Returns the display-driver specific color.
+//
+//*****************************************************************************
+static unsigned long
+GrOffScreen16BPPColorTranslate(void *pvDisplayData, unsigned long ulValue)
+{
+    //
+    // Translate from a 24-bit RGB color to a 5-6-5 RGB color.
+    //
+    return(DPYCOLORTRANSLATE(ulValue));
+}
+
+//*****************************************************************************
+//
+//! Draws a pixel on the screen.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//! \param lX is the X coordinate of the pixel.
+//! \param lY is the Y coordinate of the pixel.
+//! \param ulValue is the color of the pixel.
+//!
+//! This function sets the given pixel to a particular color.  The coordinates
+//! of the pixel are assumed to be within the extents of the display.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrOffScreen16BPPPixelDraw(void *pvDisplayData, long lX, long lY,
+                          unsigned long ulValue)
+{
+    //
+    // Check the arguments.
+    //
+    ASSERT(pvDisplayData);
+
+    //
+    // Write this pixel into the image buffer.
+    //
+    IMAGEPIXELS(pvDisplayData)[(lY * IMAGEWIDTH(pvDisplayData)) + lX] =
+        ulValue;
+}
+
+//*****************************************************************************
+//
+//! Draws a horizontal sequence of pixels on the screen.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//! \param lX is the X coordinate of the first pixel.
+//! \param lY is the Y coordinate of the first pixel.
+//! \param lX0 is sub-pixel offset within the pixel data, which is valid for 1
+//! or 4 bit per pixel formats.
+//! \param lCount is the number of pixels to draw.
+//! \param lBPP is the number of bits per pixel; must be 1, 4, or 8.
+//! \param pucData is a pointer to the pixel data.  For 1 and 4 bit per pixel
+//! formats, the most significant bit(s) represent the left-most pixel.
+//! \param pucPalette is a pointer to the palette used to draw the pixels.
+//!
+//! This function draws a horizontal sequence of pixels on the screen, using
+//! the supplied palette.  For 1 bit per pixel format, the palette contains
+//! pre-translated colors; for 4 and 8 bit per pixel formats, the palette
+//! contains 24-bit RGB values that must be translated before being written to
+//! the display.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrOffScreen16BPPPixelDrawMultiple(void *pvDisplayData, long lX, long lY,
+                                  long lX0, long lCount, long lBPP,
+                                  const unsigned char *pucData,
+                                  const unsigned char *pucPalette)
+{
+    unsigned short *pusPtr;
+    unsigned long ulByte;
+
+    //
+    // Check the arguments.
+    //
+    ASSERT(pvDisplayData);
+    ASSERT(pucData);
+    ASSERT(pucPalette);
+
+    //
+    // Get a pointer to the starting pixel in the image buffer.
+    //
+    pusPtr = (IMAGEPIXELS(pvDisplayData) +
+              (lY * IMAGEWIDTH(pvDisplayData)) + lX);
+
+    //
+    // Determine how to interpret the pixel data based on the number of bits
+    // per pixel.
+    //
+    switch(lBPP)
+    {
+        //
+        // The pixel data is in 1 bit per pixel format.
+        //
+        case 1:
+        {
+            //
+            // Loop while there are more pixels to draw.
+            //
+            while(lCount)
+            {
+                //
+                // Get the next byte of image data.
+                //
+                ulByte = *pucData++;
+
+                //
+                // Loop through the pixels in this byte of image data.
+                //
+                for(; (lX0 < 8) && lCount; lX0++, lCount--)
+                {
+                    //
+                    // Draw this pixel in the appropriate color.
+                    //
+                    *pusPtr++ = (((unsigned long *)pucPalette)[(ulByte >>
+                                                                (7 - lX0)) &
+                                                               1]);
+                }
+
+                //
+                // Start at the beginning of the next byte of image data.
+                //
+                lX0 = 0;
+            }
+
+            //
+            // The image data has been drawn.
+            //
+            break;
+        }
+
+        //
+        // The pixel data is in 4 bit per pixel format.
+        //
+        case 4:
+        {
+            //
+            // Loop while there are more pixels to draw.  "Duff's device" is
+            // used to jump into the middle of the loop if the first nibble of
+            // the pixel data should not be used.
+            //
+            switch(lX0 & 1)
+            {
+                case 0:
+                    while(lCount)
+                    {
+                        //
+                        // Get the upper nibble of the next byte of pixel data
+                        // and extract the corresponding entry from the
+                        // palette.
+                        //
+                        ulByte = (*pucData >> 4) * 3;
+                        ulByte = (*(unsigned long *)(pucPalette + ulByte) &
+                                  0x00ffffff);
+
+                        //
+                        // Translate this palette entry and write it to the
+                        // screen.
+                        //
+                        *pusPtr++ = DPYCOLORTRANSLATE(ulByte);
+
+                        //
+                        // Decrement the count of pixels to draw.
+                        //
+                        lCount--;
+
+                        //
+                        // See if there is another pixel to draw.
+                        //
+                        if(lCount)
+                        {
+                case 1:
+                            //
+                            // Get the lower nibble of the next byte of pixel
+                            // data and extract the corresponding entry from
+                            // the palette.
+                            //
+                            ulByte = (*pucData++ & 15) * 3;
+                            ulByte = (*(unsigned long *)(pucPalette + ulByte) &
+                                      0x00ffffff);
+
+                            //
+                            // Translate this palette entry and write it to the
+                            // screen.
+                            //
+                            *pusPtr++ = DPYCOLORTRANSLATE(ulByte);
+
+                            //
+                            // Decrement the count of pixels to draw.
+                            //
+                            lCount--;
+                        }
+                    }
+            }
+
+            //
+            // The image data has been drawn.
+            //
+            break;
+        }
+
+        //
+        // The pixel data is in 8 bit per pixel format.
+        //
+        case 8:
+        {
+            //
+            // Loop while there are more pixels to draw.
+            //
+            while(lCount--)
+            {
+                //
+                // Get the next byte of pixel data and extract the
+                // corresponding entry from the palette.
+                //
+                ulByte = *pucData++ * 3;
+                ulByte = *(unsigned long *)(pucPalette + ulByte) & 0x00ffffff;
+
+                //
+                // Translate this palette entry and write it to the screen.
+                //
+                *pusPtr++ = DPYCOLORTRANSLATE(ulByte);
+            }
+
+            //
+            // The image data has been drawn.
+            //
+            break;
+        }
+    }
+}
+
+//*****************************************************************************
+//
+//! Draws a horizontal line.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//! \param lX1 is the X coordinate of the start of the line.
+//! \param lX2 is the X coordinate of the end of the line.
+//! \param lY is the Y coordinate of the line.
+//! \param ulValue is the color of the line.
+//!
+//! This function draws a horizontal line on the display.  The coordinates of
+//! the line are assumed to be within the extents of the display.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrOffScreen16BPPLineDrawH(void *pvDisplayData, long lX1, long lX2, long lY,
+                          unsigned long ulValue)
+{
+    unsigned short *pusData;
+
+    //
+    // Check the arguments.
+    //
+    ASSERT(pvDisplayData);
+
+    //
+    // Get a pointer to the starting pixel in the image buffer.
+    //
+    pusData = (IMAGEPIXELS(pvDisplayData) +
+               (lY * IMAGEWIDTH(pvDisplayData)) + lX1);
+
+    //
+    // Loop over the pixels of the line.
+    //
+    for(; lX1 <= lX2; lX1++)
+    {
+        *pusData++ = ulValue;
+    }
+}
+
+//*****************************************************************************
+//
+//! Draws a vertical line.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//! \param lX is the X coordinate of the line.
+//! \param lY1 is the Y coordinate of the start of the line.
+//! \param lY2 is the Y coordinate of the end of the line.
+//! \param ulValue is the color of the line.
+//!
+//! This function draws a vertical line on the display.  The coordinates of the
+//! line are assumed to be within the extents of the display.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrOffScreen16BPPLineDrawV(void *pvDisplayData, long lX, long lY1, long lY2,
+                          unsigned long ulValue)
+{
+    unsigned short *pusData;
+
+    //
+    // Check the arguments.
+    //
+    ASSERT(pvDisplayData);
+
+    //
+    // Get a pointer to the starting pixel in the image buffer.
+    //
+    pusData = (IMAGEPIXELS(pvDisplayData) +
+               (lY1 * IMAGEWIDTH(pvDisplayData)) + lX);
+
+    //
+    // Loop over the rows of the line.
+    //
+    for(; lY1 <= lY2; lY1++)
+    {
+        *pusData = ulValue;
+        pusData += IMAGEWIDTH(pvDisplayData);
+    }
+}
+
+//*****************************************************************************
+//
+//! Fills a rectangle.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//! \param pRect is a pointer to the structure describing the rectangle.
+//! \param ulValue is the color of the rectangle.
+//!
+//! This function fills a rectangle on the display.  The coordinates of the
+//! rectangle are assumed to be within the extents of the display, and the
+//! rectangle specification is fully inclusive (in other words, both sXMin and
+//! sXMax are drawn, along with sYMin and sYMax).
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrOffScreen16BPPRectFill(void *pvDisplayData, tRectangle *pRect,
+                         unsigned long ulValue)
+{
+    long lY;
+
+    //
+    // Check the arguments.
+    //
+    ASSERT(pvDisplayData);
+    ASSERT(pRect);
+
+    //
+    // Fill the rectangle one row at a time.
+    //
+    for(lY = pRect->sYMin; lY <= pRect->sYMax; lY++)
+    {
+        GrOffScreen16BPPLineDrawH(pvDisplayData, pRect->sXMin, pRect->sXMax,
+                                  lY, ulValue);
+    }
+}
+
+//*****************************************************************************
+//
+//! Flushes any cached drawing operations.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//! \param pRect is a pointer to the structure describing the area to flush.
+//!
+//! This functions flushes any cached drawing operations to the display.  For
+//! the off-screen display buffer driver, the flush is a no operation; the
+//! buffer is copied to a real display with GrOffScreen16BPPDraw().
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrOffScreen16BPPFlush(void *pvDisplayData, tRectangle *pRect)
+{
+    //
+    // Check the arguments.
+    //
+    ASSERT(pvDisplayData);
+    ASSERT(pRect);
+}
+
+//*****************************************************************************
+//
+//! Enables the off-screen buffer.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//!
+//! This function is a no operation for the off-screen display buffer driver.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrOffScreen16BPPEnable(void *pvDisplayData)
+{
+}
+
+//*****************************************************************************
+//
+//! Disables the off-screen buffer.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//!
+//! This function is a no operation for the off-screen display buffer driver.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrOffScreen16BPPDisable(void *pvDisplayData)
+{
+}
+
+//*****************************************************************************
+//
+//! Sets the backlight state of the off-screen buffer.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//! \param usNewState is the state of the backlight.
+//!
+//! An off-screen buffer has no backlight, so this is a no operation.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrOffScreen16BPPBacklightStateSet(void *pvDisplayData,
+                                  unsigned short usNewState)
+{
+}
+
+//*****************************************************************************
+//
+//! Gets the backlight state of the off-screen buffer.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//!
+//! \return Always returns zero.
+//
+//*****************************************************************************
+static unsigned short
+GrOffScreen16BPPBacklightStateGet(void *pvDisplayData)
+{
+    return(0);
+}
+
+//*****************************************************************************
+//
+//! Sets the orientation of the off-screen buffer.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//! \param usNewOrientation is the orientation of the display.
+//!
+//! An off-screen buffer is always drawn in its natural orientation, so this is
+//! a no operation.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrOffScreen16BPPOrientationSet(void *pvDisplayData,
+                               unsigned short usNewOrientation)
+{
+}
+
+//*****************************************************************************
+//
+//! Gets the orientation of the off-screen buffer.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//!
+//! \return Always returns zero.
+//
+//*****************************************************************************
+static unsigned short
+GrOffScreen16BPPOrientationGet(void *pvDisplayData)
+{
+    return(0);
+}
+
+//*****************************************************************************
+//
+//! Gets the width of the off-screen buffer.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//!
+//! \return Returns the width of the image buffer in pixels.
+//
+//*****************************************************************************
+static unsigned short
+GrOffScreen16BPPWidthGet(void *pvDisplayData)
+{
+    ASSERT(pvDisplayData);
+
+    return(IMAGEWIDTH(pvDisplayData));
+}
+
+//*****************************************************************************
+//
+//! Gets the height of the off-screen buffer.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//!
+//! \return Returns the height of the image buffer in pixels.
+//
+//*****************************************************************************
+static unsigned short
+GrOffScreen16BPPHeightGet(void *pvDisplayData)
+{
+    ASSERT(pvDisplayData);
+
+    return(IMAGEHEIGHT(pvDisplayData));
+}
+
+//*****************************************************************************
+//
+//! Initializes a 16 BPP off-screen buffer.
+//!
+//! \param pDisplay is a pointer to the display structure to be configured for
+//! the 16 BPP off-screen buffer.
+//! \param pucImage is a pointer to the image buffer to be used for the
+//! off-screen buffer; it must be half-word aligned.
+//! \param lWidth is the width of the image buffer in pixels.
+//! \param lHeight is the height of the image buffer in pixels.
+//!
+//! This function initializes a display structure, preparing it to draw into
+//! the supplied image buffer.  The image buffer is assumed to be large enough
+//! to hold an image of the specified geometry (see GrOffScreen16BPPSize()).
+//! Each pixel is stored as an RGB565 half-word.
+//!
+//! The geometry is written into the header of the image, which the display
+//! structure uses as its driver-specific data, so any number of 16 BPP images
+//! can be drawn into at the same time through their own display structures.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+GrOffScreen16BPPInit(tDisplay *pDisplay, unsigned char *pucImage, long lWidth,
+                     long lHeight)
+{
+    //
+    // Check the arguments.
+    //
+    ASSERT(pDisplay);
+    ASSERT(pucImage);
+    ASSERT(((unsigned long)pucImage & 1) == 0);
+
+    //
+    // Initialize the display structure.
+    //
+    pDisplay->pvDisplayData = pucImage;
+    pDisplay->pfnEnable = GrOffScreen16BPPEnable;
+    pDisplay->pfnDisable = GrOffScreen16BPPDisable;
+    pDisplay->pfnBacklightStateSet = GrOffScreen16BPPBacklightStateSet;
+    pDisplay->pfnBacklightStateGet = GrOffScreen16BPPBacklightStateGet;
+    pDisplay->pfnOrientationSet = GrOffScreen16BPPOrientationSet;
+    pDisplay->pfnOrientationGet = GrOffScreen16BPPOrientationGet;
+    pDisplay->pfnWidthGet = GrOffScreen16BPPWidthGet;
+    pDisplay->pfnHeightGet = GrOffScreen16BPPHeightGet;
+    pDisplay->pfnPixelDraw = GrOffScreen16BPPPixelDraw;
+    pDisplay->pfnPixelDrawMultiple = GrOffScreen16BPPPixelDrawMultiple;
+    pDisplay->pfnLineDrawH = GrOffScreen16BPPLineDrawH;
+    pDisplay->pfnLineDrawV = GrOffScreen16BPPLineDrawV;
+    pDisplay->pfnRectFill = GrOffScreen16BPPRectFill;
+    pDisplay->pfnColorTranslate = GrOffScreen16BPPColorTranslate;
+    pDisplay->pfnFlush = GrOffScreen16BPPFlush;
+    pDisplay->pfnPixelBlend = 0;
+    pDisplay->pfnPixelRead = 0;
+
+    //
+    // Initialize the image header.
+    //
+    ((unsigned short *)pucImage)[0] = lWidth;
+    ((unsigned short *)pucImage)[1] = lHeight;
+}
+
+//*****************************************************************************
+//
+//! Draws a 16 BPP off-screen buffer to the display.
+//!
+//! \param pContext is a pointer to the drawing context to use.
+//! \param pucImage is a pointer to the 16 BPP image buffer.
+//! \param lX is the X coordinate of the upper left corner of the image.
+//! \param lY is the Y coordinate of the upper left corner of the image.
+//!
+//! This function copies an image composed with the 16 BPP off-screen driver
+//! onto the display, clipped to the clipping region of the context.  Each row
+//! is sent to the display as runs of equally colored pixels, so flat areas
+//! (which make up most of a widget) cost a single horizontal line each.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+GrOffScreen16BPPDraw(const tContext *pContext, const unsigned char *pucImage,
+                     long lX, long lY)
+{
+    const unsigned short *pusRow;
+    unsigned long ulPixel, ulLastPixel, ulColor;
+    long lWidth, lHeight, lX1, lX2, lY1, lY2, lStart, lEnd;
+
+    //
+    // Check the arguments.
+    //
+    ASSERT(pContext);
+    ASSERT(pucImage);
+
+    //
+    // Get the geometry of the image from its header.
+    //
+    lWidth = IMAGEWIDTH(pucImage);
+    lHeight = IMAGEHEIGHT(pucImage);
+
+    //
+    // Clip the image to the clipping region.
+    //
+    lX1 = (lX < pContext->sClipRegion.sXMin) ? pContext->sClipRegion.sXMin : lX;
+    lY1 = (lY < pContext->sClipRegion.sYMin) ? pContext->sClipRegion.sYMin : lY;
+    lX2 = lX + lWidth - 1;
+    lY2 = lY + lHeight - 1;
+    if(lX2 > pContext->sClipRegion.sXMax)
+    {
+        lX2 = pContext->sClipRegion.sXMax;
+    }
+    if(lY2 > pContext->sClipRegion.sYMax)
+    {
+        lY2 = pContext->sClipRegion.sYMax;
+    }
+
+    //
+    // Return without doing anything if the image is entirely clipped.
+    //
+    if((lX1 > lX2) || (lY1 > lY2))
+    {
+        return;
+    }
+
+    //
+    // Convert the horizontal extents to columns of the image.
+    //
+    lX1 -= lX;
+    lX2 -= lX;
+
+    //
+    // Prime the translated color cache with a value that no pixel can have.
+    //
+    ulLastPixel = 0xffffffff;
+    ulColor = 0;
+
+    //
+    // Loop over the visible rows of the image.
+    //
+    for(; lY1 <= lY2; lY1++)
+    {
+        //
+        // Get a pointer to the first pixel of this row.
+        //
+        pusRow = IMAGEPIXELS(pucImage) + ((lY1 - lY) * lWidth);
+
+        //
+        // Loop over the runs of equally colored pixels in this row.
+        //
+        for(lStart = lX1; lStart <= lX2; lStart = lEnd + 1)
+        {
+            //
+            // Find the end of this run.
+            //
+            ulPixel = pusRow[lStart];
+            for(lEnd = lStart; (lEnd < lX2) && (pusRow[lEnd + 1] == ulPixel);
+                lEnd++)
+            {
+            }
+
+            //
+            // Translate the color of the run unless it matches the previous
+            // run.
+            //
+            if(ulPixel != ulLastPixel)
+            {
+                ulColor = DpyColorTranslate(pContext->pDisplay,
+                                            DPYCOLORUNTRANSLATE(ulPixel));
+                ulLastPixel = ulPixel;
+            }
+
+            //
+            // Draw this run.
+            //
+            DpyLineDrawH(pContext->pDisplay, lX + lStart, lX + lEnd, lY1,
+                         ulColor);
+        }
+    }
+}
+
+//*****************************************************************************
+//
+// Close the Doxygen group.
+//! @}
+//
+//*****************************************************************************
@@ -578,7 +578,7 @@ GrOffScreen1BPPLineDrawV(void *pvDisplayData, long lX, long lY1, long lY2,
 //
 //*****************************************************************************
 static void
-GrOffScreen1BPPRectFill(void *pvDisplayData, const tRectangle *pRect,
+GrOffScreen1BPPRectFill(void *pvDisplayData, tRectangle *pRect,
                         unsigned long ulValue)
 {
     unsigned char *pucData, *pucColumn;
@@ -808,7 +808,7 @@ GrOffScreen1BPPColorTranslate(void *pvDisplayData, unsigned long ulValue)
 //
 //*****************************************************************************
 static void
-GrOffScreen1BPPFlush(void *pvDisplayData, const tRectangle *pRect)
+GrOffScreen1BPPFlush(void *pvDisplayData, tRectangle *pRect)
 {
     //
     // Check the arguments.
@@ -817,6 +817,147 @@ GrOffScreen1BPPFlush(void *pvDisplayData, const tRectangle *pRect)
     ASSERT(pRect);
 }
 
+//*****************************************************************************
+//
+//! Enables the off-screen buffer.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//!
+//! This function is a no operation for the off-screen display buffer driver.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrOffScreen1BPPEnable(void *pvDisplayData)
+{
+}
+
+//*****************************************************************************
+//
+//! Disables the off-screen buffer.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//!
+//! This function is a no operation for the off-screen display buffer driver.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrOffScreen1BPPDisable(void *pvDisplayData)
+{
+}
+
+//*****************************************************************************
+//
+//! Sets the backlight state of the off-screen buffer.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//! \param usNewState is the state of the backlight.
+//!
+//! An off-screen buffer has no backlight, so this is a no operation.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrOffScreen1BPPBacklightStateSet(void *pvDisplayData,
+                                 unsigned short usNewState)
+{
+}
+
+//*****************************************************************************
+//
+//! Gets the backlight state of the off-screen buffer.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//!
+//! \return Always returns zero.
+//
+//*****************************************************************************
+static unsigned short
+GrOffScreen1BPPBacklightStateGet(void *pvDisplayData)
+{
+    return(0);
+}
+
+//*****************************************************************************
+//
+//! Sets the orientation of the off-screen buffer.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//! \param usNewOrientation is the orientation of the display.
+//!
+//! An off-screen buffer is always drawn in its natural orientation, so this is
+//! a no operation.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrOffScreen1BPPOrientationSet(void *pvDisplayData,
+                              unsigned short usNewOrientation)
+{
+}
+
+//*****************************************************************************
+//
+//! Gets the orientation of the off-screen buffer.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//!
+//! \return Always returns zero.
+//
+//*****************************************************************************
+static unsigned short
+GrOffScreen1BPPOrientationGet(void *pvDisplayData)
+{
+    return(0);
+}
+
+//*****************************************************************************
+//
+//! Gets the width of the off-screen buffer.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//!
+//! \return Returns the width of the image buffer in pixels.
+//
+//*****************************************************************************
+static unsigned short
+GrOffScreen1BPPWidthGet(void *pvDisplayData)
+{
+    ASSERT(pvDisplayData);
+
+    return(*(unsigned short *)((unsigned char *)pvDisplayData + 1));
+}
+
+//*****************************************************************************
+//
+//! Gets the height of the off-screen buffer.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//!
+//! \return Returns the height of the image buffer in pixels.
+//
+//*****************************************************************************
+static unsigned short
+GrOffScreen1BPPHeightGet(void *pvDisplayData)
+{
+    ASSERT(pvDisplayData);
+
+    return(*(unsigned short *)((unsigned char *)pvDisplayData + 3));
+}
+
 //*****************************************************************************
 //
 //! Initializes a 1 BPP off-screen buffer.
@@ -848,10 +989,15 @@ GrOffScreen1BPPInit(tDisplay *pDisplay, unsigned char *pucImage, long lWidth,
     //
     // Initialize the display structure.
     //
-    pDisplay->lSize = sizeof(tDisplay);
     pDisplay->pvDisplayData = pucImage;
-    pDisplay->usWidth = lWidth;
-    pDisplay->usHeight = lHeight;
+    pDisplay->pfnEnable = GrOffScreen1BPPEnable;
+    pDisplay->pfnDisable = GrOffScreen1BPPDisable;
+    pDisplay->pfnBacklightStateSet = GrOffScreen1BPPBacklightStateSet;
+    pDisplay->pfnBacklightStateGet = GrOffScreen1BPPBacklightStateGet;
+    pDisplay->pfnOrientationSet = GrOffScreen1BPPOrientationSet;
+    pDisplay->pfnOrientationGet = GrOffScreen1BPPOrientationGet;
+    pDisplay->pfnWidthGet = GrOffScreen1BPPWidthGet;
+    pDisplay->pfnHeightGet = GrOffScreen1BPPHeightGet;
     pDisplay->pfnPixelDraw = GrOffScreen1BPPPixelDraw;
     pDisplay->pfnPixelDrawMultiple = GrOffScreen1BPPPixelDrawMultiple;
     pDisplay->pfnLineDrawH = GrOffScreen1BPPLineDrawH;
@@ -859,6 +1005,8 @@ GrOffScreen1BPPInit(tDisplay *pDisplay, unsigned char *pucImage, long lWidth,
     pDisplay->pfnRectFill = GrOffScreen1BPPRectFill;
     pDisplay->pfnColorTranslate = GrOffScreen1BPPColorTranslate;
     pDisplay->pfnFlush = GrOffScreen1BPPFlush;
+    pDisplay->pfnPixelBlend = 0;
+    pDisplay->pfnPixelRead = 0;
 
     //
     // Initialize the image buffer.
@@ -653,7 +653,7 @@ GrOffScreen4BPPLineDrawV(void *pvDisplayData, long lX, long lY1, long lY2,
 //
 //*****************************************************************************
 static void
-GrOffScreen4BPPRectFill(void *pvDisplayData, const tRectangle *pRect,
+GrOffScreen4BPPRectFill(void *pvDisplayData, tRectangle *pRect,
                         unsigned long ulValue)
 {
     unsigned char *pucData, *pucColumn;
@@ -837,7 +837,7 @@ GrOffScreen4BPPRectFill(void *pvDisplayData, const tRectangle *pRect,
 //
 //*****************************************************************************
 static void
-GrOffScreen4BPPFlush(void *pvDisplayData, const tRectangle *pRect)
+GrOffScreen4BPPFlush(void *pvDisplayData, tRectangle *pRect)
 {
     //
     // Check the arguments.
@@ -846,6 +846,147 @@ GrOffScreen4BPPFlush(void *pvDisplayData, const tRectangle *pRect)
     ASSERT(pRect);
 }
 
+//*****************************************************************************
+//
+//! Enables the off-screen buffer.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//!
+//! This function is a no operation for the off-screen display buffer driver.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrOffScreen4BPPEnable(void *pvDisplayData)
+{
+}
+
+//*****************************************************************************
+//
+//! Disables the off-screen buffer.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//!
+//! This function is a no operation for the off-screen display buffer driver.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrOffScreen4BPPDisable(void *pvDisplayData)
+{
+}
+
+//*****************************************************************************
+//
+//! Sets the backlight state of the off-screen buffer.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//! \param usNewState is the state of the backlight.
+//!
+//! An off-screen buffer has no backlight, so this is a no operation.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrOffScreen4BPPBacklightStateSet(void *pvDisplayData,
+                                 unsigned short usNewState)
+{
+}
+
+//*****************************************************************************
+//
+//! Gets the backlight state of the off-screen buffer.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//!
+//! \return Always returns zero.
+//
+//*****************************************************************************
+static unsigned short
+GrOffScreen4BPPBacklightStateGet(void *pvDisplayData)
+{
+    return(0);
+}
+
+//*****************************************************************************
+//
+//! Sets the orientation of the off-screen buffer.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//! \param usNewOrientation is the orientation of the display.
+//!
+//! An off-screen buffer is always drawn in its natural orientation, so this is
+//! a no operation.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrOffScreen4BPPOrientationSet(void *pvDisplayData,
+                              unsigned short usNewOrientation)
+{
+}
+
+//*****************************************************************************
+//
+//! Gets the orientation of the off-screen buffer.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//!
+//! \return Always returns zero.
+//
+//*****************************************************************************
+static unsigned short
+GrOffScreen4BPPOrientationGet(void *pvDisplayData)
+{
+    return(0);
+}
+
+//*****************************************************************************
+//
+//! Gets the width of the off-screen buffer.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//!
+//! \return Returns the width of the image buffer in pixels.
+//
+//*****************************************************************************
+static unsigned short
+GrOffScreen4BPPWidthGet(void *pvDisplayData)
+{
+    ASSERT(pvDisplayData);
+
+    return(*(unsigned short *)((unsigned char *)pvDisplayData + 1));
+}
+
+//*****************************************************************************
+//
+//! Gets the height of the off-screen buffer.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//!
+//! \return Returns the height of the image buffer in pixels.
+//
+//*****************************************************************************
+static unsigned short
+GrOffScreen4BPPHeightGet(void *pvDisplayData)
+{
+    ASSERT(pvDisplayData);
+
+    return(*(unsigned short *)((unsigned char *)pvDisplayData + 3));
+}
+
 //*****************************************************************************
 //
 //! Initializes a 4 BPP off-screen buffer.
@@ -877,10 +1018,15 @@ GrOffScreen4BPPInit(tDisplay *pDisplay, unsigned char *pucImage, long lWidth,
     //
     // Initialize the display structure.
     //
-    pDisplay->lSize = sizeof(tDisplay);
     pDisplay->pvDisplayData = pucImage;
-    pDisplay->usWidth = lWidth;
-    pDisplay->usHeight = lHeight;
+    pDisplay->pfnEnable = GrOffScreen4BPPEnable;
+    pDisplay->pfnDisable = GrOffScreen4BPPDisable;
+    pDisplay->pfnBacklightStateSet = GrOffScreen4BPPBacklightStateSet;
+    pDisplay->pfnBacklightStateGet = GrOffScreen4BPPBacklightStateGet;
+    pDisplay->pfnOrientationSet = GrOffScreen4BPPOrientationSet;
+    pDisplay->pfnOrientationGet = GrOffScreen4BPPOrientationGet;
+    pDisplay->pfnWidthGet = GrOffScreen4BPPWidthGet;
+    pDisplay->pfnHeightGet = GrOffScreen4BPPHeightGet;
     pDisplay->pfnPixelDraw = GrOffScreen4BPPPixelDraw;
     pDisplay->pfnPixelDrawMultiple = GrOffScreen4BPPPixelDrawMultiple;
     pDisplay->pfnLineDrawH = GrOffScreen4BPPLineDrawH;
@@ -888,6 +1034,8 @@ GrOffScreen4BPPInit(tDisplay *pDisplay, unsigned char *pucImage, long lWidth,
     pDisplay->pfnRectFill = GrOffScreen4BPPRectFill;
     pDisplay->pfnColorTranslate = GrOffScreen4BPPColorTranslate;
     pDisplay->pfnFlush = GrOffScreen4BPPFlush;
+    pDisplay->pfnPixelBlend = 0;
+    pDisplay->pfnPixelRead = 0;
 
     //
     // Initialize the image buffer.
@@ -538,7 +538,7 @@ GrOffScreen8BPPLineDrawV(void *pvDisplayData, long lX, long lY1, long lY2,
 //
 //*****************************************************************************
 static void
-GrOffScreen8BPPRectFill(void *pvDisplayData, const tRectangle *pRect,
+GrOffScreen8BPPRectFill(void *pvDisplayData, tRectangle *pRect,
                         unsigned long ulValue)
 {
     unsigned char *pucData, *pucPtr;
@@ -683,7 +683,7 @@ GrOffScreen8BPPRectFill(void *pvDisplayData, const tRectangle *pRect,
 //
 //*****************************************************************************
 static void
-GrOffScreen8BPPFlush(void *pvDisplayData, const tRectangle *pRect)
+GrOffScreen8BPPFlush(void *pvDisplayData, tRectangle *pRect)
 {
     //
     // Check the arguments.
@@ -692,6 +692,147 @@ GrOffScreen8BPPFlush(void *pvDisplayData, const tRectangle *pRect)
     ASSERT(pRect);
 }
 
+//*****************************************************************************
+//
+//! Enables the off-screen buffer.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//!
+//! This function is a no operation for the off-screen display buffer driver.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrOffScreen8BPPEnable(void *pvDisplayData)
+{
+}
+
+//*****************************************************************************
+//
+//! Disables the off-screen buffer.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//!
+//! This function is a no operation for the off-screen display buffer driver.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrOffScreen8BPPDisable(void *pvDisplayData)
+{
+}
+
+//*****************************************************************************
+//
+//! Sets the backlight state of the off-screen buffer.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//! \param usNewState is the state of the backlight.
+//!
+//! An off-screen buffer has no backlight, so this is a no operation.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrOffScreen8BPPBacklightStateSet(void *pvDisplayData,
+                                 unsigned short usNewState)
+{
+}
+
+//*****************************************************************************
+//
+//! Gets the backlight state of the off-screen buffer.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//!
+//! \return Always returns zero.
+//
+//*****************************************************************************
+static unsigned short
+GrOffScreen8BPPBacklightStateGet(void *pvDisplayData)
+{
+    return(0);
+}
+
+//*****************************************************************************
+//
+//! Sets the orientation of the off-screen buffer.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//! \param usNewOrientation is the orientation of the display.
+//!
+//! An off-screen buffer is always drawn in its natural orientation, so this is
+//! a no operation.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+GrOffScreen8BPPOrientationSet(void *pvDisplayData,
+                              unsigned short usNewOrientation)
+{
+}
+
+//*****************************************************************************
+//
+//! Gets the orientation of the off-screen buffer.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//!
+//! \return Always returns zero.
+//
+//*****************************************************************************
+static unsigned short
+GrOffScreen8BPPOrientationGet(void *pvDisplayData)
+{
+    return(0);
+}
+
+//*****************************************************************************
+//
+//! Gets the width of the off-screen buffer.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//!
+//! \return Returns the width of the image buffer in pixels.
+//
+//*****************************************************************************
+static unsigned short
+GrOffScreen8BPPWidthGet(void *pvDisplayData)
+{
+    ASSERT(pvDisplayData);
+
+    return(*(unsigned short *)((unsigned char *)pvDisplayData + 1));
+}
+
+//*****************************************************************************
+//
+//! Gets the height of the off-screen buffer.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//!
+//! \return Returns the height of the image buffer in pixels.
+//
+//*****************************************************************************
+static unsigned short
+GrOffScreen8BPPHeightGet(void *pvDisplayData)
+{
+    ASSERT(pvDisplayData);
+
+    return(*(unsigned short *)((unsigned char *)pvDisplayData + 3));
+}
+
 //*****************************************************************************
 //
 //! Initializes an 8 BPP off-screen buffer.
@@ -723,10 +864,15 @@ GrOffScreen8BPPInit(tDisplay *pDisplay, unsigned char *pucImage, long lWidth,
     //
     // Initialize the display structure.
     //
-    pDisplay->lSize = sizeof(tDisplay);
     pDisplay->pvDisplayData = pucImage;
-    pDisplay->usWidth = lWidth;
-    pDisplay->usHeight = lHeight;
+    pDisplay->pfnEnable = GrOffScreen8BPPEnable;
+    pDisplay->pfnDisable = GrOffScreen8BPPDisable;
+    pDisplay->pfnBacklightStateSet = GrOffScreen8BPPBacklightStateSet;
+    pDisplay->pfnBacklightStateGet = GrOffScreen8BPPBacklightStateGet;
+    pDisplay->pfnOrientationSet = GrOffScreen8BPPOrientationSet;
+    pDisplay->pfnOrientationGet = GrOffScreen8BPPOrientationGet;
+    pDisplay->pfnWidthGet = GrOffScreen8BPPWidthGet;
+    pDisplay->pfnHeightGet = GrOffScreen8BPPHeightGet;
     pDisplay->pfnPixelDraw = GrOffScreen8BPPPixelDraw;
     pDisplay->pfnPixelDrawMultiple = GrOffScreen8BPPPixelDrawMultiple;
     pDisplay->pfnLineDrawH = GrOffScreen8BPPLineDrawH;
@@ -734,6 +880,8 @@ GrOffScreen8BPPInit(tDisplay *pDisplay, unsigned char *pucImage, long lWidth,
     pDisplay->pfnRectFill = GrOffScreen8BPPRectFill;
     pDisplay->pfnColorTranslate = GrOffScreen8BPPColorTranslate;
     pDisplay->pfnFlush = GrOffScreen8BPPFlush;
+    pDisplay->pfnPixelBlend = 0;
+    pDisplay->pfnPixelRead = 0;
 
     //
     // Initialize the image buffer.
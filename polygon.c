@@ -0,0 +1,350 @@
+//*****************************************************************************
+//
+// polygon.c - Routines for filling polygons.
+//
+//*****************************************************************************
+
+#include "debug.h"
+#include "grlib.h"
+
+//*****************************************************************************
+//
+//! \addtogroup primitives_api
+//! @{
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// The largest number of vertices of a polygon filled by GrPolygonFill().  The
+// edges of the polygon are kept on the stack while it is filled.
+//
+//*****************************************************************************
+#ifndef GRLIB_POLYGON_MAX_POINTS
+#define GRLIB_POLYGON_MAX_POINTS        32
+#endif
+
+//*****************************************************************************
+//
+// This structure holds an edge of a polygon, with the X coordinate where it
+// crosses the current row.  The crossing is kept as an integer and a
+// remainder in 1/lDY of a pixel, so that it is stepped from row to row
+// exactly.
+//
+//*****************************************************************************
+typedef struct
+{
+    //
+    // The integer part of the X coordinate of the crossing, and its remainder,
+    // from 0 to lDY - 1.
+    //
+    long lX;
+    long lRem;
+
+    //
+    // The integer part of the change of the X coordinate from one row to the
+    // next, and its remainder.
+    //
+    long lStep;
+    long lRemStep;
+
+    //
+    // The height of the edge.
+    //
+    long lDY;
+
+    //
+    // The first row the edge crosses, and the row after the last one.
+    //
+    short sYMin;
+    short sYMax;
+}
+tPolygonEdge;
+
+//*****************************************************************************
+//
+//! Divides two integers, rounding the quotient down.
+//!
+//! \param lNum is the dividend.
+//! \param lDen is the divisor, which must be positive.
+//! \param plRem is a pointer to the remainder, from 0 to \e lDen - 1.
+//!
+//! \return Returns the largest integer not above \e lNum / \e lDen.
+//
+//*****************************************************************************
+static long
+GrPolygonDivFloor(long lNum, long lDen, long *plRem)
+{
+    long lQuot;
+
+    lQuot = lNum / lDen;
+    *plRem = lNum - (lQuot * lDen);
+
+    if(*plRem < 0)
+    {
+        lQuot--;
+        *plRem += lDen;
+    }
+
+    return(lQuot);
+}
+
+//*****************************************************************************
+//
+//! Gets the first pixel on or after the crossing of an edge with a row.
+//!
+//! \param psEdge is a pointer to the edge.
+//!
+//! A pixel is on or after the crossing exactly when it is on or after this
+//! pixel, so the edges are sorted, and the rows filled, by this pixel.
+//!
+//! \return Returns the X coordinate of the pixel.
+//
+//*****************************************************************************
+static long
+GrPolygonEdgeXGet(const tPolygonEdge *psEdge)
+{
+    return(psEdge->lX + ((psEdge->lRem > 0) ? 1 : 0));
+}
+
+//*****************************************************************************
+//
+//! Fills a polygon.
+//!
+//! \param pContext is a pointer to the drawing context to use.
+//! \param psPoints is a pointer to the vertices of the polygon, in order
+//! around it.
+//! \param ulCount is the number of vertices, from three to
+//! GRLIB_POLYGON_MAX_POINTS.
+//!
+//! This function fills a polygon, which may be convex or concave, with the
+//! even-odd rule: a pixel is filled when a ray from its center crosses the
+//! edges of the polygon an odd number of times.  The last vertex is joined to
+//! the first one.
+//!
+//! The edges of the polygon are listed in an edge table, sorted by their
+//! first row.  Each row of the clipping region the polygon crosses is then
+//! filled with one horizontal line between each pair of the edges that cross
+//! it, which are kept in an active edge list sorted by where they cross it;
+//! the number of calls to the display driver grows with the height of the
+//! polygon, not its area.
+//!
+//! The pixels whose center is exactly on the right or bottom edge of the
+//! polygon are not filled, so that polygons sharing an edge do not overlap.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+GrPolygonFill(const tContext *pContext, const tPoint *psPoints,
+              unsigned long ulCount)
+{
+    tPolygonEdge psEdges[GRLIB_POLYGON_MAX_POINTS], sEdge;
+    unsigned char pucActive[GRLIB_POLYGON_MAX_POINTS], ucTemp;
+    const tPoint *psFrom, *psTo;
+    long lY, lYMin, lYMax, lXMin, lXMax, lX1, lX2;
+    unsigned long ulIdx, ulEdges, ulNext, ulActive, ulPos, ulRows, ulRem;
+
+    //
+    // Check the arguments.
+    //
+    ASSERT(pContext);
+    ASSERT(psPoints);
+    ASSERT(ulCount <= GRLIB_POLYGON_MAX_POINTS);
+
+    if((ulCount < 3) || (ulCount > GRLIB_POLYGON_MAX_POINTS))
+    {
+        return;
+    }
+
+    //
+    // Build the edge table, sorted by first row, leaving out the horizontal
+    // edges, which cross no row.
+    //
+    ulEdges = 0;
+    lXMin = lXMax = psPoints[0].sX;
+    lYMin = lYMax = psPoints[0].sY;
+
+    for(ulIdx = 0; ulIdx < ulCount; ulIdx++)
+    {
+        psFrom = &psPoints[ulIdx];
+        psTo = &psPoints[(ulIdx + 1) % ulCount];
+
+        lXMin = (psFrom->sX < lXMin) ? psFrom->sX : lXMin;
+        lXMax = (psFrom->sX > lXMax) ? psFrom->sX : lXMax;
+        lYMin = (psFrom->sY < lYMin) ? psFrom->sY : lYMin;
+        lYMax = (psFrom->sY > lYMax) ? psFrom->sY : lYMax;
+
+        if(psFrom->sY == psTo->sY)
+        {
+            continue;
+        }
+
+        if(psFrom->sY > psTo->sY)
+        {
+            psTo = psFrom;
+            psFrom = &psPoints[(ulIdx + 1) % ulCount];
+        }
+
+        sEdge.sYMin = psFrom->sY;
+        sEdge.sYMax = psTo->sY;
+        sEdge.lDY = psTo->sY - psFrom->sY;
+        sEdge.lX = psFrom->sX;
+        sEdge.lRem = 0;
+        sEdge.lStep = GrPolygonDivFloor(psTo->sX - psFrom->sX, sEdge.lDY,
+                                        &sEdge.lRemStep);
+
+        for(ulPos = ulEdges;
+            (ulPos > 0) && (psEdges[ulPos - 1].sYMin > sEdge.sYMin); ulPos--)
+        {
+            psEdges[ulPos] = psEdges[ulPos - 1];
+        }
+
+        psEdges[ulPos] = sEdge;
+        ulEdges++;
+    }
+
+    //
+    // Return without drawing anything if the polygon is entirely out of the
+    // clipping region.
+    //
+    if((lXMin > pContext->sClipRegion.sXMax) ||
+       (lXMax < pContext->sClipRegion.sXMin) ||
+       (lYMin > pContext->sClipRegion.sYMax) ||
+       (lYMax < pContext->sClipRegion.sYMin))
+    {
+        return;
+    }
+
+    //
+    // Only the rows within the clipping region are filled.  The bottom row of
+    // the polygon is on its bottom edge, and is not filled.
+    //
+    lY = (lYMin > pContext->sClipRegion.sYMin) ?
+         lYMin : pContext->sClipRegion.sYMin;
+
+    if(lYMax > (pContext->sClipRegion.sYMax + 1))
+    {
+        lYMax = pContext->sClipRegion.sYMax + 1;
+    }
+
+    ulNext = 0;
+    ulActive = 0;
+
+    for(; lY < lYMax; lY++)
+    {
+        //
+        // Move the edges that start on or above this row to the active edge
+        // list.  An edge that starts above the clipping region is advanced to
+        // this row at once.
+        //
+        for(; (ulNext < ulEdges) && (psEdges[ulNext].sYMin <= lY); ulNext++)
+        {
+            if(psEdges[ulNext].sYMax <= lY)
+            {
+                continue;
+            }
+
+            if(psEdges[ulNext].sYMin < lY)
+            {
+                //
+                // Skip the rows by whole steps and by remainders apart.  The
+                // number of rows and the remainder step are both below lDY,
+                // itself below 65536, so their product fits in an unsigned
+                // long, and the whole steps add up to less than the width of
+                // the edge.
+                //
+                ulRows = lY - psEdges[ulNext].sYMin;
+                ulRem = ulRows * psEdges[ulNext].lRemStep;
+                psEdges[ulNext].lX += ((long)ulRows * psEdges[ulNext].lStep) +
+                                      (long)(ulRem / psEdges[ulNext].lDY);
+                psEdges[ulNext].lRem = (long)(ulRem % psEdges[ulNext].lDY);
+            }
+
+            pucActive[ulActive++] = ulNext;
+        }
+
+        //
+        // Drop the edges that end on this row.
+        //
+        for(ulIdx = 0, ulPos = 0; ulIdx < ulActive; ulIdx++)
+        {
+            if(psEdges[pucActive[ulIdx]].sYMax > lY)
+            {
+                pucActive[ulPos++] = pucActive[ulIdx];
+            }
+        }
+        ulActive = ulPos;
+
+        //
+        // Sort the active edges by where they cross this row.  They keep
+        // their order from one row to the next unless they cross each other,
+        // so this is mostly a single pass.
+        //
+        for(ulIdx = 1; ulIdx < ulActive; ulIdx++)
+        {
+            ucTemp = pucActive[ulIdx];
+
+            for(ulPos = ulIdx;
+                (ulPos > 0) &&
+                (GrPolygonEdgeXGet(&psEdges[pucActive[ulPos - 1]]) >
+                 GrPolygonEdgeXGet(&psEdges[ucTemp]));
+                ulPos--)
+            {
+                pucActive[ulPos] = pucActive[ulPos - 1];
+            }
+
+            pucActive[ulPos] = ucTemp;
+        }
+
+        //
+        // Fill the pixels between each pair of edges: those whose center is
+        // on or after the first crossing, and before the second one.
+        //
+        for(ulIdx = 0; (ulIdx + 1) < ulActive; ulIdx += 2)
+        {
+            lX1 = GrPolygonEdgeXGet(&psEdges[pucActive[ulIdx]]);
+            lX2 = GrPolygonEdgeXGet(&psEdges[pucActive[ulIdx + 1]]) - 1;
+
+            if(lX1 < pContext->sClipRegion.sXMin)
+            {
+                lX1 = pContext->sClipRegion.sXMin;
+            }
+            if(lX2 > pContext->sClipRegion.sXMax)
+            {
+                lX2 = pContext->sClipRegion.sXMax;
+            }
+
+            if(lX1 <= lX2)
+            {
+                DpyLineDrawH(pContext->pDisplay, lX1, lX2, lY,
+                             pContext->ulForeground);
+            }
+        }
+
+        //
+        // Step the active edges to the next row.
+        //
+        for(ulIdx = 0; ulIdx < ulActive; ulIdx++)
+        {
+            psEdges[pucActive[ulIdx]].lX += psEdges[pucActive[ulIdx]].lStep;
+            psEdges[pucActive[ulIdx]].lRem +=
+                psEdges[pucActive[ulIdx]].lRemStep;
+
+            if(psEdges[pucActive[ulIdx]].lRem >=
+               psEdges[pucActive[ulIdx]].lDY)
+            {
+                psEdges[pucActive[ulIdx]].lX++;
+                psEdges[pucActive[ulIdx]].lRem -=
+                    psEdges[pucActive[ulIdx]].lDY;
+            }
+        }
+    }
+}
+
+//*****************************************************************************
+//
+// Close the Doxygen group.
+//! @}
+//
+//*****************************************************************************
@@ -190,7 +190,7 @@ GrRectFill(const tContext *pContext, const tRectangle *pRect)
     //
     // Call the low level rectangle fill routine.
     //
-    DisplayRectFill(&sTemp, pContext->ulForeground);
+    DpyRectFill(pContext->pDisplay, &sTemp, pContext->ulForeground);
 }
 
 //*****************************************************************************
@@ -275,108 +275,6 @@ GrRectIntersectGet(tRectangle *psRect1, tRectangle *psRect2,
 }
 
 
-//*****************************************************************************
-//
-//! Draws a rectangle filled by linear gradient.
-//!
-//! \param pContext is a pointer to the drawing context to use.
-//! \param pRect is a pointer to the structure containing the extents of the
-//! rectangle.
-//! \param ulColor1 is a first color of gradient filling.
-//! \param ulColor2 is a second color of gradient filling.
-//!
-//! This function draws a rectangle filled by gradient.
-//!
-//! \return None.
-//
-//*****************************************************************************
-void
-GrRectGradientFill( tContext *pContext, const tRectangle *pRect )
-{
-	tRectangle    sTemp;
-	unsigned long ulCurrColor;
-	         long lColorRedDiff;
-	         long lColorGreenDiff;
-	         long lColorBlueDiff;
-	         long lColorRed;
-	         long lColorGreen;
-	         long lColorBlue;
-
-	 //
-	 // Check the arguments.
-	 //
-	 ASSERT(pContext);
-	 ASSERT(pRect);
-
-	 //
-	 // Swap the X coordinates if sXMin is greater than sXMax.
-	 //
-	 if(pRect->sXMin > pRect->sXMax)
-	 {
-		 sTemp.sXMin = pRect->sXMax;
-		 sTemp.sXMax = pRect->sXMin;
-	 }
-	 else
-	 {
-		 sTemp.sXMin = pRect->sXMin;
-		 sTemp.sXMax = pRect->sXMax;
-	 }
-
-	 //
-	 // Swap the Y coordinates if sYMin is greater than sYMax.
-	 //
-	 if(pRect->sYMin > pRect->sYMax)
-	 {
-		 sTemp.sYMin = pRect->sYMax;
-		 sTemp.sYMax = pRect->sYMin;
-	 }
-	 else
-	 {
-		 sTemp.sYMin = pRect->sYMin;
-		 sTemp.sYMax = pRect->sYMax;
-	 }
-
-	 //
-	 // Now that the coordinates are ordered, return without drawing anything if
-	 // the entire rectangle is out of the clipping region.
-	 //
-	 if((sTemp.sXMin > pContext->sClipRegion.sXMax) ||
-		(sTemp.sXMax < pContext->sClipRegion.sXMin) ||
-		(sTemp.sYMin > pContext->sClipRegion.sYMax) ||
-		(sTemp.sYMax < pContext->sClipRegion.sYMin))
-	 {
-		 return;
-	 }
-
-
-	lColorRed   = ((pContext->ulGradient1 & 0x00FF0000) >> 16) * 255;
-	lColorGreen = ((pContext->ulGradient1 & 0x0000FF00) >> 8)  * 255;
-	lColorBlue  = ((pContext->ulGradient1 & 0x000000FF) >> 0)  * 255;
-
-	lColorRedDiff   = (((pContext->ulGradient2 & 0x00FF0000) >> 16) - ((pContext->ulGradient1 & 0x00FF0000) >> 16)) * 255;
-	lColorGreenDiff = (((pContext->ulGradient2 & 0x0000FF00) >>  8) - ((pContext->ulGradient1 & 0x0000FF00) >>  8)) * 255;
-	lColorBlueDiff  = (((pContext->ulGradient2 & 0x000000FF) >>  0) - ((pContext->ulGradient1 & 0x000000FF) >>  0)) * 255;
-
-	lColorRedDiff   /= sTemp.sYMax - sTemp.sYMin + 1;
-	lColorGreenDiff /= sTemp.sYMax - sTemp.sYMin + 1;
-	lColorBlueDiff  /= sTemp.sYMax - sTemp.sYMin + 1;
-
-	for( short sRow = sTemp.sYMin; sRow <= sTemp.sYMax; sRow++ )
-	{
-		lColorRed   += lColorRedDiff;
-		lColorGreen += lColorGreenDiff;
-		lColorBlue  += lColorBlueDiff;
-
-		ulCurrColor  = ((lColorRed   / 255) & 0xFF) << 16;
-		ulCurrColor |= ((lColorGreen / 255) & 0xFF) << 8;
-		ulCurrColor |= ((lColorBlue  / 255) & 0xFF) << 0;
-
-		GrContextForegroundSet(pContext, ulCurrColor);
-		GrLineDrawH(pContext, sTemp.sXMin, sTemp.sXMax, sRow);
-	}
-}
-
-
 //*****************************************************************************
 //
 // Close the Doxygen group.
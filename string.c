@@ -667,7 +667,7 @@ GrStringDraw(const tContext *pContext, const char *pcString, long lLength,
                        ((lX + lX0) <= sCon.sClipRegion.sXMax) &&
                        ((lY + lY0) >= sCon.sClipRegion.sYMin) && bOpaque)
                     {
-                        DisplayPixelDraw(lX + lX0, lY + lY0,
+                        DpyPixelDraw(pContext->pDisplay, lX + lX0, lY + lY0,
                                      pContext->ulBackground);
                     }
 
@@ -768,7 +768,7 @@ GrStringDraw(const tContext *pContext, const char *pcString, long lLength,
                        ((lX + lX0) <= sCon.sClipRegion.sXMax) &&
                        ((lY + lY0) >= sCon.sClipRegion.sYMin))
                     {
-                        DisplayPixelDraw(lX + lX0, lY + lY0,
+                        DpyPixelDraw(pContext->pDisplay, lX + lX0, lY + lY0,
                                      pContext->ulForeground);
                     }
 
@@ -1365,7 +1365,7 @@ GrFontGlyphRender(const tContext *pContext, const unsigned char *pucData,
                         lClipX2 = lX + lX0 + lCount - 1;
                     }
 
-                    DisplayLineDrawH(lClipX1, lClipX2,
+                    DpyLineDrawH(pContext->pDisplay, lClipX1, lClipX2,
                                  lY + lY0, pContext->ulBackground);
                 }
 
@@ -1395,7 +1395,7 @@ GrFontGlyphRender(const tContext *pContext, const unsigned char *pucData,
                    ((lX + lX0) <= pContext->sClipRegion.sXMax) &&
                    ((lY + lY0) >= pContext->sClipRegion.sYMin) && bOpaque)
                 {
-                    DisplayPixelDraw(lX + lX0, lY + lY0,
+                    DpyPixelDraw(pContext->pDisplay, lX + lX0, lY + lY0,
                                  pContext->ulBackground);
                 }
 
@@ -1483,7 +1483,7 @@ GrFontGlyphRender(const tContext *pContext, const unsigned char *pucData,
                         lClipX2 = lX + lX0 + lCount - 1;
                     }
 
-                    DisplayLineDrawH(lClipX1, lClipX2,
+                    DpyLineDrawH(pContext->pDisplay, lClipX1, lClipX2,
                                  lY + lY0, pContext->ulForeground);
                 }
 
@@ -1513,7 +1513,7 @@ GrFontGlyphRender(const tContext *pContext, const unsigned char *pucData,
                    ((lX + lX0) <= pContext->sClipRegion.sXMax) &&
                    ((lY + lY0) >= pContext->sClipRegion.sYMin))
                 {
-                    DisplayPixelDraw(lX + lX0, lY + lY0,
+                    DpyPixelDraw(pContext->pDisplay, lX + lX0, lY + lY0,
                                  pContext->ulForeground);
                 }
 
@@ -16,9 +16,10 @@ Tree::Tree()
 	//
 	// Set initial values
 	//
-	this->pParent = 0;
-	this->pNext   = 0;
-	this->pChild  = 0;
+	this->pParent    = 0;
+	this->pNext      = 0;
+	this->pPrev      = 0;
+	this->pChild     = 0;
 }
 
 //*****************************************************************************
@@ -29,12 +30,27 @@ Tree::Tree()
 void
 Tree::AppendChild(Tree *pChild)
 {
-	Tree *pTemp;
+    //
+    // Our child is allready present in the tree, just return
+    //
+    if(pChild->pParent == this)
+    {
+        return;
+    }
+
+    //
+    // Detach our child from its previous parent, if any
+    //
+    if(pChild->pParent)
+    {
+        pChild->Cut();
+    }
 
     //
     // Make this tree be a parent of our child that to be appended
     //
     pChild->pParent = this;
+    pChild->pNext = 0;
 
     //
     // See if this tree already has children
@@ -42,40 +58,26 @@ Tree::AppendChild(Tree *pChild)
     if(this->pChild)
     {
         //
-        // Find the last child of this tree and also check that our child
-    	// is not already present at this level of the tree
-        //
-        for(pTemp = this->pChild; pTemp->pNext; pTemp = pTemp->pNext)
-        {
-            //
-            // Our child is allready present in the tree, just return
-            //
-            if(pTemp == pChild)
-            {
-                return;
-            }
-        }
-
-        //
-        // Check again
-        //
-        if(pTemp == pChild)
-        {
-            return;
-        }
-
-        //
-        // Add our child to the end of the list of children of this tree
+        // Add our child to the end of the list of children of this tree, after
+        // the last child, which the first child points back to
         //
-        pTemp->pNext = pChild;
+        pChild->pPrev = this->pChild->pPrev;
+        pChild->pPrev->pNext = pChild;
+        this->pChild->pPrev = pChild;
     }
     else
     {
         //
         // Make our child be the first (and only) child of this tree
         //
+        pChild->pPrev = pChild;
         this->pChild = pChild;
     }
+
+    //
+    // Let our child know that it has a new parent
+    //
+    pChild->ParentChanged();
 }
 
 //*****************************************************************************
@@ -86,46 +88,49 @@ Tree::AppendChild(Tree *pChild)
 void
 Tree::Cut()
 {
-    Tree *pTemp;
-
     //
     // Make sure that this tree has a parent
     //
     if(this->pParent)
     {
         //
-        // See if this tree is the first child of its parent
+        // Make the previous sibling (or the parent, if this tree is the first
+        // child) point to the next sibling, removing this tree from the
+        // sibling chain
         //
         if(this->pParent->pChild == this)
         {
-            //
-            // Make the first child of this tree's parent be this tree's
-            // sibling
-            //
             this->pParent->pChild = this->pNext;
         }
         else
         {
-            //
-            // Find the sibling directly before this tree
-            //
-            for(pTemp = this->pParent->pChild; pTemp->pNext != this;
-                pTemp = pTemp->pNext)
-            {
-            }
+            this->pPrev->pNext = this->pNext;
+        }
 
-            //
-            // Make the previous sibling point to the next sibling, removing
-            // this tree from the sibling chain
-            //
-            pTemp->pNext = this->pNext;
+        //
+        // Make the next sibling (or the first child, if this tree is the last
+        // child) point back to the previous sibling
+        //
+        if(this->pNext)
+        {
+            this->pNext->pPrev = this->pPrev;
+        }
+        else if(this->pParent->pChild)
+        {
+            this->pParent->pChild->pPrev = this->pPrev;
         }
 
         //
-        // Clear the parent and next point
+        // Clear the parent and sibling pointers
         //
         this->pParent = 0;
         this->pNext = 0;
+        this->pPrev = 0;
+
+        //
+        // Let this tree know that it has no parent anymore
+        //
+        this->ParentChanged();
     }
 }
 
@@ -196,14 +201,16 @@ Tree::PreOrderSearch(Tree *pLastSearch)
 
 //*****************************************************************************
 //
-// Post-order, depth-first search
+// Post-order, depth-first search.  The children of a tree are visited from the
+// last one to the first one, so that the tree drawn last (on top) is found
+// first.  Each step takes constant time, apart from descending to the
+// deepest tree, which is paid once per tree over a whole search.
 //
 //*****************************************************************************
 Tree*
 Tree::PostOrderSearch(Tree *pLastSearch)
 {
 	Tree *pTemp;
-	Tree *pPrev;
 
 	//
 	// See if this is a first search
@@ -211,90 +218,46 @@ Tree::PostOrderSearch(Tree *pLastSearch)
     if(!pLastSearch)
     {
     	pTemp = this;
-
-		//
-		// Find a deepest tree
-		//
-		while(pTemp->pChild)
-		{
-			//
-			// Go to this tree's child first.
-			//
-			pTemp = pTemp->pChild;
-
-			//
-			// Go to the last siblig tree at this level
-			//
-			while(pTemp->pNext)
-			{
-				pTemp = pTemp->pNext;
-			}
-		}
-
-		return pTemp;
     }
     else
     {
-    	pTemp = pLastSearch;
+        //
+        // Check for search complete
+        //
+        if(pLastSearch == this)
+        {
+            //
+            // Search finished, no any trees found
+            //
+            return 0;
+        }
+
+        //
+        // Check if this tree is not a first child of his parent
+        //
+        if(!pLastSearch->PrevGet())
+        {
+            //
+            // This tree has no siblings, so go to its parent
+            //
+            return pLastSearch->pParent;
+        }
+
+        //
+        // Visit to the previous sibling of this tree
+        //
+        pTemp = pLastSearch->pPrev;
     }
 
     //
-    // Check for search complete
+    // Find a deepest tree, going through the last child at each level
     //
-    if(pTemp != this)
+    while(pTemp->pChild)
     {
-    	//
-    	// Check if this tree is not a first child of his parent
-    	//
-    	if((pTemp->pParent) && (pTemp->pParent->pChild != pTemp))
-    	{
-    		//
-    		// Find the sibling directly before this tree (previous)
-    		//
-    		for(pPrev = pTemp->pParent->pChild; pPrev->pNext != pTemp;
-    			pPrev = pPrev->pNext)
-    		{
-    		}
-
-    		//
-    		// Visit to the previous sibling of this tree
-    		//
-    		pTemp = pPrev;
-
-    		//
-    		// Find a deepest tree
-    		//
-    		while(pTemp->pChild)
-    		{
-    			//
-    			// Go to this tree's child first
-    			//
-    			pTemp = pTemp->pChild;
-
-    			//
-    			// Go to the last siblig tree at this level
-    			//
-    			while(pTemp->pNext)
-    			{
-    				pTemp = pTemp->pNext;
-    			}
-    		}
-
-    		return pTemp;
-    	}
-    	else
-    	{
-    		//
-    		// This tree has no siblings, so go to its parent
-    		//
-    		return pTemp->pParent;
-    	}
+        pTemp = pTemp->pChild->pPrev;
     }
 
-    //
-    // Search finished, no any trees found
-    //
-    return 0;
+    return pTemp;
 }
 
 //*****************************************************************************
@@ -46,6 +46,15 @@ public:
 		return this->pNext;
 	}
 
+	//
+	// Gets a pointer to the previous sibling of this tree
+	//
+	Tree *PrevGet()
+	{
+		return (this->pParent && (this->pParent->pChild != this)) ?
+		       this->pPrev : 0;
+	}
+
 	//
 	// Gets a pointer to the child of this tree
 	//
@@ -54,6 +63,14 @@ public:
 		return this->pChild;
 	}
 
+	//
+	// Gets a pointer to the last child of this tree
+	//
+	Tree *LastChildGet()
+	{
+		return this->pChild ? this->pChild->pPrev : 0;
+	}
+
 	//
 	// Appneds a child to this tree
 	//
@@ -79,6 +96,24 @@ public:
 	//
 	virtual ~Tree();
 
+#ifdef WIDGET_NO_HEAP
+	//
+	// Frees a tree object; trees are only deleted through the classes derived
+	// from it, which do not use the heap either
+	//
+	static void operator delete(void *pvTree)
+	{
+	}
+#endif
+
+protected:
+	//
+	// Called after this tree has been appended to or cut from a parent
+	//
+	virtual void ParentChanged()
+	{
+	}
+
 private:
 	//
 	// A pointer to the parent of this tree
@@ -90,6 +125,12 @@ private:
 	//
 	Tree *pNext;
 
+	//
+	// A pointer to the previous sibling of this tree, or to the last sibling
+	// if this tree is the first child of its parent
+	//
+	Tree *pPrev;
+
 	//
 	// A pointer to the child of this tree
 	//
@@ -0,0 +1,589 @@
+//*****************************************************************************
+//
+// animation.cpp - Widget animations.
+//
+//*****************************************************************************
+
+#include "grlib.h"
+#include "widget.h"
+#include "animation.h"
+
+//*****************************************************************************
+//
+//! \addtogroup widget_api
+//! @{
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// The fixed-point format of the animation progress: 1.0 is 1 << 15, so that
+// the square of a progress fits in 32 bits.
+//
+//*****************************************************************************
+#define ANIMATION_ONE_BITS      15
+#define ANIMATION_ONE           (1UL << ANIMATION_ONE_BITS)
+
+//*****************************************************************************
+//
+//! The running animations.
+//
+//*****************************************************************************
+Animation *Animation::pFirst = 0;
+
+//*****************************************************************************
+//
+//! The time of the last frame.
+//
+//*****************************************************************************
+unsigned long Animation::ulFrameTime;
+
+//*****************************************************************************
+//
+//! The time between two frames.
+//
+//*****************************************************************************
+unsigned long Animation::ulFramePeriod = ANIMATION_FRAME_PERIOD;
+
+//*****************************************************************************
+//
+//! The number of frames skipped since the previous one was not flushed yet.
+//
+//*****************************************************************************
+unsigned long Animation::ulFramesSkipped;
+
+//*****************************************************************************
+//
+// Applies an easing curve to a progress.
+//
+// The progress and the result go from 0 to ANIMATION_ONE.
+//
+//*****************************************************************************
+static unsigned long
+AnimationEase(unsigned long ulEasing, unsigned long ulT)
+{
+	switch(ulEasing)
+	{
+		//
+		// t^2.
+		//
+		case ANIMATION_EASE_IN:
+		{
+			return((ulT * ulT) >> ANIMATION_ONE_BITS);
+		}
+
+		//
+		// 1 - (1 - t)^2.
+		//
+		case ANIMATION_EASE_OUT:
+		{
+			ulT = ANIMATION_ONE - ulT;
+
+			return(ANIMATION_ONE - ((ulT * ulT) >> ANIMATION_ONE_BITS));
+		}
+
+		//
+		// t^2 * (3 - 2t).
+		//
+		case ANIMATION_EASE_IN_OUT:
+		{
+			return((((ulT * ulT) >> ANIMATION_ONE_BITS) *
+			        ((3 * ANIMATION_ONE) - (2 * ulT))) >> ANIMATION_ONE_BITS);
+		}
+
+		//
+		// t.
+		//
+		default:
+		{
+			return(ulT);
+		}
+	}
+}
+
+//*****************************************************************************
+//
+// Scales a distance by an eased progress, without overflowing 32 bits for any
+// distance.
+//
+//*****************************************************************************
+static long
+AnimationScale(long lDelta, unsigned long ulE)
+{
+	unsigned long ulDelta, ulResult;
+
+	ulDelta = (lDelta < 0) ? -lDelta : lDelta;
+
+	ulResult = ((ulDelta >> ANIMATION_ONE_BITS) * ulE) +
+	           (((ulDelta & (ANIMATION_ONE - 1)) * ulE) >> ANIMATION_ONE_BITS);
+
+	return((lDelta < 0) ? -(long)ulResult : (long)ulResult);
+}
+
+//*****************************************************************************
+//
+// Adds an absolute rectangle to the area changed during a frame.
+//
+//*****************************************************************************
+static void
+AnimationFrameAdd(tRectangle *psFrame, long *pbFrame, const tRectangle *psRect)
+{
+	if(!*pbFrame)
+	{
+		*psFrame = *psRect;
+		*pbFrame = 1;
+		return;
+	}
+
+	if(psRect->sXMin < psFrame->sXMin)
+	{
+		psFrame->sXMin = psRect->sXMin;
+	}
+	if(psRect->sYMin < psFrame->sYMin)
+	{
+		psFrame->sYMin = psRect->sYMin;
+	}
+	if(psRect->sXMax > psFrame->sXMax)
+	{
+		psFrame->sXMax = psRect->sXMax;
+	}
+	if(psRect->sYMax > psFrame->sYMax)
+	{
+		psFrame->sYMax = psRect->sYMax;
+	}
+}
+
+//*****************************************************************************
+//
+//! Constructs an animation.
+//!
+//! This function constructs a stopped animation.
+//!
+//! \return None.
+//
+//*****************************************************************************
+Animation::Animation(void)
+{
+	this->pNext      = 0;
+	this->ppPrev     = 0;
+	this->pWidget    = 0;
+	this->pvValue    = 0;
+	this->ulProperty = ANIMATION_PROP_X;
+	this->ulEasing   = ANIMATION_EASE_LINEAR;
+	this->lFrom      = 0;
+	this->lTo        = 0;
+	this->lCurrent   = 0;
+	this->ulStart    = 0;
+	this->ulDuration = 0;
+}
+
+//*****************************************************************************
+//
+//! Starts this animation.
+//!
+//! \param pWidget is a pointer to the widget that is animated.
+//! \param ulProperty is the property that is animated; this is one of the
+//! \b ANIMATION_PROP_xxx values.
+//! \param pvValue is a pointer to the variable that is animated, which is a
+//! long for \b #ANIMATION_PROP_VALUE and an unsigned long for
+//! \b #ANIMATION_PROP_COLOR.  It is not used for the other properties.
+//! \param lTo is the distance the widget is moved by, for
+//! \b #ANIMATION_PROP_X and \b #ANIMATION_PROP_Y, or the final value of the
+//! variable.
+//! \param ulDuration is the duration of the animation, in milliseconds.
+//! \param ulEasing is the easing curve; this is one of the
+//! \b ANIMATION_EASE_xxx values.
+//!
+//! This function starts this animation, or restarts it from the current
+//! state of the property if it is running.  The property is changed on the
+//! next frames, until it reaches \e lTo after \e ulDuration milliseconds.
+//! With \b #ANIMATION_PROP_VALUE and \b #ANIMATION_PROP_COLOR, \e pWidget may
+//! be zero if the variable does not need a repaint.
+//!
+//! The animation must be stopped before the widget or the variable is
+//! destroyed; the easiest way is to make the animation a member of the
+//! widget.  This function must be called from the same context as
+//! Widget::MessageQueueProcess().
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+Animation::Start(Widget *pWidget, unsigned long ulProperty, void *pvValue,
+                 long lTo, unsigned long ulDuration, unsigned long ulEasing)
+{
+	this->Stop();
+
+	this->pWidget    = pWidget;
+	this->pvValue    = pvValue;
+	this->ulProperty = ulProperty;
+	this->ulEasing   = ulEasing;
+	this->lTo        = lTo;
+	this->ulStart    = GrTimerGet();
+	this->ulDuration = ulDuration;
+
+	//
+	// Start from the current value of the property; the moves are relative
+	// to the current position of the widget.
+	//
+	switch(ulProperty)
+	{
+		case ANIMATION_PROP_VALUE:
+		{
+			this->lFrom = *(long *)pvValue;
+			break;
+		}
+
+		case ANIMATION_PROP_COLOR:
+		{
+			this->lFrom = (long)*(unsigned long *)pvValue;
+			break;
+		}
+
+		default:
+		{
+			this->lFrom = 0;
+			break;
+		}
+	}
+
+	this->lCurrent = this->lFrom;
+
+	//
+	// Add this animation to the running animations.
+	//
+	this->pNext = Animation::pFirst;
+	if(this->pNext)
+	{
+		this->pNext->ppPrev = &this->pNext;
+	}
+	this->ppPrev = &Animation::pFirst;
+	Animation::pFirst = this;
+}
+
+//*****************************************************************************
+//
+//! Stops this animation.
+//!
+//! This function stops this animation, if it is running.  The property keeps
+//! the value reached on the last frame.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+Animation::Stop(void)
+{
+	if(this->ppPrev)
+	{
+		this->Remove();
+	}
+}
+
+//*****************************************************************************
+//
+//! Removes this animation from the running animations.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+Animation::Remove(void)
+{
+	*this->ppPrev = this->pNext;
+	if(this->pNext)
+	{
+		this->pNext->ppPrev = this->ppPrev;
+	}
+
+	this->pNext = 0;
+	this->ppPrev = 0;
+}
+
+//*****************************************************************************
+//
+//! Computes the value of this animation at a given time.
+//!
+//! \param ulTime is the time, in milliseconds.
+//!
+//! \return Returns the value of the property at \e ulTime.
+//
+//*****************************************************************************
+long
+Animation::ValueGet(unsigned long ulTime)
+{
+	unsigned long ulElapsed, ulDuration, ulE, ulShift, ulColor;
+	long lFrom, lTo;
+
+	ulElapsed = ulTime - this->ulStart;
+	ulDuration = this->ulDuration;
+
+	if(ulElapsed >= ulDuration)
+	{
+		return(this->lTo);
+	}
+
+	//
+	// Get the eased progress, scaling both times down so that the progress
+	// can be computed in 32 bits.
+	//
+	while(ulDuration >= (1UL << (32 - ANIMATION_ONE_BITS - 1)))
+	{
+		ulDuration >>= 1;
+		ulElapsed >>= 1;
+	}
+
+	ulE = AnimationEase(this->ulEasing,
+	                    (ulElapsed << ANIMATION_ONE_BITS) / ulDuration);
+
+	//
+	// A color goes from its start to its end one component at a time.
+	//
+	if(this->ulProperty == ANIMATION_PROP_COLOR)
+	{
+		ulColor = 0;
+
+		for(ulShift = 0; ulShift < 24; ulShift += 8)
+		{
+			lFrom = ((unsigned long)this->lFrom >> ulShift) & 0xff;
+			lTo = ((unsigned long)this->lTo >> ulShift) & 0xff;
+
+			ulColor |= (lFrom + AnimationScale(lTo - lFrom, ulE)) << ulShift;
+		}
+
+		return((long)ulColor);
+	}
+
+	return(this->lFrom + AnimationScale(this->lTo - this->lFrom, ulE));
+}
+
+//*****************************************************************************
+//
+//! Applies the value of this animation at a given time.
+//!
+//! \param ulTime is the time of the frame, in milliseconds.
+//! \param psFrame is a pointer to the absolute area changed during the frame.
+//! \param pbFrame is a pointer to a flag that is non-zero if \e psFrame holds
+//! an area.
+//!
+//! This function changes the property to its value at \e ulTime, and adds the
+//! area that needs a repaint to \e psFrame, without invalidating it.
+//!
+//! \return Returns 1 if this animation has reached its end, and 0 otherwise.
+//
+//*****************************************************************************
+long
+Animation::Step(unsigned long ulTime, tRectangle *psFrame, long *pbFrame)
+{
+	tRectangle sPosition;
+	long lValue;
+
+	lValue = this->ValueGet(ulTime);
+
+	if(lValue != this->lCurrent)
+	{
+		//
+		// A moved widget needs a repaint of both the area it leaves and the
+		// area it goes to.
+		//
+		if((this->ulProperty == ANIMATION_PROP_X) ||
+		   (this->ulProperty == ANIMATION_PROP_Y))
+		{
+			this->pWidget->AbsolutePositionGet(&sPosition);
+			AnimationFrameAdd(psFrame, pbFrame, &sPosition);
+
+			if(this->ulProperty == ANIMATION_PROP_X)
+			{
+				this->pWidget->Move(lValue - this->lCurrent, 0);
+			}
+			else
+			{
+				this->pWidget->Move(0, lValue - this->lCurrent);
+			}
+		}
+		else if(this->ulProperty == ANIMATION_PROP_VALUE)
+		{
+			*(long *)this->pvValue = lValue;
+		}
+		else
+		{
+			*(unsigned long *)this->pvValue = (unsigned long)lValue;
+		}
+
+		if(this->pWidget)
+		{
+			this->pWidget->AbsolutePositionGet(&sPosition);
+			AnimationFrameAdd(psFrame, pbFrame, &sPosition);
+		}
+
+		this->lCurrent = lValue;
+	}
+
+	return((ulTime - this->ulStart) >= this->ulDuration);
+}
+
+//*****************************************************************************
+//
+//! Steps the running animations, if a frame is due.
+//!
+//! This function is called by Widget::MessageQueueProcess().  Once every frame
+//! period (see Animation::FramePeriodSet()), it changes the property of every
+//! running animation to its value at the current time of GrTimerGet(), and
+//! invalidates the bounding rectangle of all the changed areas at once, so
+//! that they are repainted and flushed in a single pass.
+//!
+//! A frame is skipped if the previous one has not been repainted and flushed
+//! yet, such as when the repaint is spread over several calls by the budget
+//! of Widget::MessageQueueProcess().  Since the properties follow the time
+//! rather than the frames, a skipped frame only makes the next step larger,
+//! and the animations still end on time.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+Animation::Process(void)
+{
+	tRectangle sFrame, sRoot;
+	Animation *pAnimation, *pNext;
+	unsigned long ulTime;
+	long bFrame;
+
+	//
+	// Nothing to do if no animation is running.
+	//
+	if(!Animation::pFirst)
+	{
+		return;
+	}
+
+	//
+	// See if a frame is due.
+	//
+	ulTime = GrTimerGet();
+
+	if((ulTime - Animation::ulFrameTime) < Animation::ulFramePeriod)
+	{
+		return;
+	}
+
+	//
+	// Skip this frame if the previous one is still being repainted.
+	//
+	if(Widget::RepaintPending() || GrDirtyRectCountGet())
+	{
+		Animation::ulFramesSkipped++;
+		return;
+	}
+
+	Animation::ulFrameTime = ulTime;
+
+	//
+	// Step every running animation, removing the ones that have ended.
+	//
+	bFrame = 0;
+
+	for(pAnimation = Animation::pFirst; pAnimation; pAnimation = pNext)
+	{
+		pNext = pAnimation->pNext;
+
+		if(pAnimation->Step(ulTime, &sFrame, &bFrame))
+		{
+			pAnimation->Remove();
+		}
+	}
+
+	//
+	// Invalidate the area changed by all the animations at once.
+	//
+	if(bFrame && g_pcRootWidget)
+	{
+		g_pcRootWidget->AbsolutePositionGet(&sRoot);
+
+		sFrame.sXMin -= sRoot.sXMin;
+		sFrame.sYMin -= sRoot.sYMin;
+		sFrame.sXMax -= sRoot.sXMin;
+		sFrame.sYMax -= sRoot.sYMin;
+
+		g_pcRootWidget->Invalidate(&sFrame);
+	}
+}
+
+//*****************************************************************************
+//
+//! Sets the time between two animation frames.
+//!
+//! \param ulPeriod is the time between two frames, in milliseconds.
+//!
+//! This function sets the frame period of the animations, which is
+//! \b ANIMATION_FRAME_PERIOD by default.  A shorter period gives smoother
+//! animations at the cost of more repaints.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+Animation::FramePeriodSet(unsigned long ulPeriod)
+{
+	Animation::ulFramePeriod = ulPeriod;
+}
+
+//*****************************************************************************
+//
+//! Gets the number of frames skipped since the previous one was not flushed
+//! yet.
+//!
+//! \return Returns the number of frames skipped since the start.
+//
+//*****************************************************************************
+unsigned long
+Animation::FramesSkippedGet(void)
+{
+	return(Animation::ulFramesSkipped);
+}
+
+//*****************************************************************************
+//
+//! Gets the time until the next animation frame.
+//!
+//! \return Returns the number of milliseconds until the next frame is due,
+//! zero if it is already due, or \b #ANIMATION_NONE if no animation is
+//! running.
+//
+//*****************************************************************************
+unsigned long
+Animation::NextFrameGet(void)
+{
+	unsigned long ulElapsed;
+
+	if(!Animation::pFirst)
+	{
+		return(ANIMATION_NONE);
+	}
+
+	ulElapsed = GrTimerGet() - Animation::ulFrameTime;
+
+	return((ulElapsed < Animation::ulFramePeriod) ?
+	       (Animation::ulFramePeriod - ulElapsed) : 0);
+}
+
+//*****************************************************************************
+//
+//! Destroys an animation.
+//!
+//! This function stops the animation before it is destroyed.
+//!
+//! \return None.
+//
+//*****************************************************************************
+Animation::~Animation(void)
+{
+	this->Stop();
+}
+
+//*****************************************************************************
+//
+// Close the Doxygen group.
+//! @}
+//
+//*****************************************************************************
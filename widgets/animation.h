@@ -0,0 +1,244 @@
+//*****************************************************************************
+//
+// animation.h - Prototypes for the widget animations.
+//
+//*****************************************************************************
+
+#ifndef __ANIMATION_H__
+#define __ANIMATION_H__
+
+#include "grlib.h"
+
+//*****************************************************************************
+//
+//! \addtogroup widget_api
+//! @{
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// If building with a C++ compiler, make all of the definitions in this header
+// have a C binding.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+class Widget;
+
+//*****************************************************************************
+//
+//! The properties an animation can change.  With ANIMATION_PROP_X and
+//! ANIMATION_PROP_Y the widget is moved by the given distance, horizontally or
+//! vertically.  With ANIMATION_PROP_VALUE a long variable goes to the given
+//! value, and with ANIMATION_PROP_COLOR an unsigned long variable holding a
+//! 24-bit RGB color goes to the given color, one component at a time; the
+//! widget is repainted whenever the variable changes.
+//
+//*****************************************************************************
+#define ANIMATION_PROP_X        0x00000000
+#define ANIMATION_PROP_Y        0x00000001
+#define ANIMATION_PROP_VALUE    0x00000002
+#define ANIMATION_PROP_COLOR    0x00000003
+
+//*****************************************************************************
+//
+//! The easing curves of an animation, which tell how the property goes from
+//! its start to its end over the duration of the animation: at a constant
+//! speed, speeding up, slowing down, or speeding up then slowing down.
+//
+//*****************************************************************************
+#define ANIMATION_EASE_LINEAR   0x00000000
+#define ANIMATION_EASE_IN       0x00000001
+#define ANIMATION_EASE_OUT      0x00000002
+#define ANIMATION_EASE_IN_OUT   0x00000003
+
+//*****************************************************************************
+//
+//! The default time between two animation frames, in milliseconds.
+//
+//*****************************************************************************
+#ifndef ANIMATION_FRAME_PERIOD
+#define ANIMATION_FRAME_PERIOD  20
+#endif
+
+//*****************************************************************************
+//
+//! The value returned by Animation::NextFrameGet() when no animation is
+//! running.
+//
+//*****************************************************************************
+#define ANIMATION_NONE          0xffffffff
+
+//*****************************************************************************
+//
+//! This class describes an animation, which changes a property of a widget
+//! over time.
+//!
+//! The running animations are stepped together, once per frame, by
+//! Animation::Process(), which is called by Widget::MessageQueueProcess().
+//! The area changed by all of them during a frame is invalidated at once, so
+//! that it is repainted and flushed in a single pass.
+//
+//*****************************************************************************
+class Animation
+{
+public:
+	//
+	//! Constructor.
+	//
+	Animation(void);
+
+	//
+	//! Starts this animation.
+	//
+	void Start(Widget *pWidget, unsigned long ulProperty, void *pvValue,
+	           long lTo, unsigned long ulDuration, unsigned long ulEasing);
+
+	//
+	//! Stops this animation.
+	//
+	void Stop(void);
+
+	//
+	//! Determines if this animation is running.
+	//
+	long IsRunning(void)
+	{
+		return(this->ppPrev != 0);
+	}
+
+	//
+	//! Steps the running animations, if a frame is due.
+	//
+	static void Process(void);
+
+	//
+	//! Sets the time between two animation frames.
+	//
+	static void FramePeriodSet(unsigned long ulPeriod);
+
+	//
+	//! Gets the number of frames skipped since the previous one was not
+	//! flushed yet.
+	//
+	static unsigned long FramesSkippedGet(void);
+
+	//
+	//! Gets the time until the next animation frame.
+	//
+	static unsigned long NextFrameGet(void);
+
+	//
+	//! Destructor.
+	//
+	~Animation(void);
+
+private:
+	//
+	//! Computes the value of this animation at a given time.
+	//
+	long ValueGet(unsigned long ulTime);
+
+	//
+	//! Applies the value of this animation at a given time.
+	//
+	long Step(unsigned long ulTime, tRectangle *psFrame, long *pbFrame);
+
+	//
+	//! Removes this animation from the running animations.
+	//
+	void Remove(void);
+
+	//
+	//! The next running animation.
+	//
+	Animation *pNext;
+
+	//
+	//! The pointer that points to this animation, either the list head or the
+	//! pNext member of the previous animation, or zero if this animation is
+	//! stopped.
+	//
+	Animation **ppPrev;
+
+	//
+	//! The widget that is animated.
+	//
+	Widget *pWidget;
+
+	//
+	//! The variable that is animated, for ANIMATION_PROP_VALUE and
+	//! ANIMATION_PROP_COLOR.
+	//
+	void *pvValue;
+
+	//
+	//! The property that is animated; this is one of the ANIMATION_PROP_xxx
+	//! values.
+	//
+	unsigned long ulProperty;
+
+	//
+	//! The easing curve; this is one of the ANIMATION_EASE_xxx values.
+	//
+	unsigned long ulEasing;
+
+	//
+	//! The value of the property at the start and at the end.
+	//
+	long lFrom;
+	long lTo;
+
+	//
+	//! The value of the property applied so far.
+	//
+	long lCurrent;
+
+	//
+	//! The time at which this animation started, and its duration.
+	//
+	unsigned long ulStart;
+	unsigned long ulDuration;
+
+	//
+	//! The running animations.
+	//
+	static Animation *pFirst;
+
+	//
+	//! The time of the last frame.
+	//
+	static unsigned long ulFrameTime;
+
+	//
+	//! The time between two frames.
+	//
+	static unsigned long ulFramePeriod;
+
+	//
+	//! The number of frames skipped.
+	//
+	static unsigned long ulFramesSkipped;
+};
+
+//*****************************************************************************
+//
+// Mark the end of the C bindings section for C++ compilers.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+}
+#endif
+
+//*****************************************************************************
+//
+// Close the Doxygen group.
+//! @}
+//
+//*****************************************************************************
+
+#endif // __ANIMATION_H__
@@ -15,6 +15,57 @@
 //
 //*****************************************************************************
 
+//*****************************************************************************
+//
+//! Constructs a canvas widget from its description.
+//!
+//! \param lX is the X coordinate of the upper left corner of the canvas.
+//! \param lY is the Y coordinate of the upper left corner of the canvas.
+//! \param lWidth is the width of the canvas.
+//! \param lHeight is the height of the canvas.
+//! \param psDesc is a pointer to the description of the canvas contents.
+//!
+//! This function constructs a canvas widget whose contents are described by
+//! \e psDesc, which is referenced rather than copied, and must stay valid as
+//! long as the canvas exists.
+//!
+//! \return None.
+//
+//*****************************************************************************
+CanvasView::CanvasView(unsigned char ucID, Widget *pParent, long lX, long lY,
+                       long lWidth, long lHeight, const tCanvasDesc *psDesc) :
+	        Widget(ucID, pParent, lX, lY, lWidth, lHeight)
+{
+	this->psDesc = psDesc;
+
+	//
+	// A canvas only handles paint requests.
+	//
+	this->MessageMaskSet(WIDGET_MSG_MASK(WIDGET_MSG_UPDATE));
+}
+
+//*****************************************************************************
+//
+//! Creates a canvas widget of a widget tree description.
+//!
+//! \param pvDesc is a pointer to the tCanvasDesc structure that describes the
+//! canvas contents.
+//!
+//! This function is called by Widget::TreeCreate() for the entries declared
+//! with CANVAS_DESC().  The other parameters are those of the constructor.
+//!
+//! \return Returns a pointer to the new canvas, or zero if it could not be
+//! allocated.
+//
+//*****************************************************************************
+Widget *
+CanvasView::Create(unsigned char ucID, Widget *pParent, long lX, long lY,
+                   long lWidth, long lHeight, const void *pvDesc)
+{
+	return(new CanvasView(ucID, pParent, lX, lY, lWidth, lHeight,
+	                      (const tCanvasDesc *)pvDesc));
+}
+
 //*****************************************************************************
 //
 //! Constructs a canvas widget.
@@ -24,14 +75,20 @@
 //! \param lWidth is the width of the canvas.
 //! \param lHeight is the height of the canvas.
 //!
-//! This function constructs a canvas widget.
+//! This function constructs a canvas widget, whose contents are set through
+//! its fields.
 //!
 //! \return None.
 //
 //*****************************************************************************
 Canvas::Canvas(unsigned char ucID, Widget *pParent, long lX, long lY, long lWidth, long lHeight) :
-	    Widget(ucID, pParent, lX, lY, lWidth, lHeight)
+	    CanvasView(ucID, pParent, lX, lY, lWidth, lHeight, 0)
 {
+    //
+    // This canvas is described by its own fields.
+    //
+    this->psDesc = this;
+
     //
     // Set initial values for all variables
     //
@@ -44,6 +101,7 @@ Canvas::Canvas(unsigned char ucID, Widget *pParent, long lX, long lY, long lWidt
     this->pFont            = 0;
     this->pcText           = 0;
     this->pucImage         = 0;
+    this->pStyle           = 0;
 }
 
 //*****************************************************************************
@@ -62,7 +120,7 @@ Canvas::Canvas(unsigned char ucID, Widget *pParent, long lX, long lY, long lWidt
 //
 //*****************************************************************************
 long
-Canvas::MessageProc(unsigned long ulMsg, unsigned long ulParam1,
+CanvasView::MessageProc(unsigned long ulMsg, unsigned long ulParam1,
 		            unsigned long ulParam2)
 {
     //
@@ -114,12 +172,51 @@ Canvas::MessageProc(unsigned long ulMsg, unsigned long ulParam1,
 //
 //*****************************************************************************
 void
-Canvas::Draw(void)
+CanvasView::Draw(void)
 {
-	tRectangle sPosition;
+	const WidgetStyle *pStyle;
+	WidgetStyle sStyle;
+	tRectangle sPosition, sRect;
     tContext sCtx;
     long lX, lY, lWidth, lHeight;
-    long lColor1, lColor2;
+    unsigned long ulColor1, ulColor2, ulStyle, ulUse;
+
+    //
+    // Use the style of this canvas, or else translate the colors of its
+    // description that this paint uses: the fill color, which is also the
+    // background of the image and the text, with its shades for an edge, the
+    // outline color, and the text color.
+    //
+    pStyle = this->psDesc->pStyle;
+
+    if(!pStyle)
+    {
+        ulStyle = this->psDesc->ulStyle;
+        ulUse = 0;
+
+        if(ulStyle & (CANVAS_STYLE_FILL | CANVAS_STYLE_IMG |
+                      CANVAS_STYLE_TEXT))
+        {
+            ulUse |= WIDGET_STYLE_USE_FILL;
+        }
+        if(ulStyle & (CANVAS_STYLE_FALLING_EDGE | CANVAS_STYLE_RISING_EDGE))
+        {
+            ulUse |= WIDGET_STYLE_USE_FILL | WIDGET_STYLE_USE_SHADES;
+        }
+        if(ulStyle & CANVAS_STYLE_OUTLINE)
+        {
+            ulUse |= WIDGET_STYLE_USE_OUTLINE;
+        }
+        if(ulStyle & (CANVAS_STYLE_IMG | CANVAS_STYLE_TEXT))
+        {
+            ulUse |= WIDGET_STYLE_USE_TEXT;
+        }
+
+        sStyle.Set(Widget::DisplayGet(), this->psDesc->ulFillColor,
+                   this->psDesc->ulFillColor, this->psDesc->ulOutlineColor,
+                   this->psDesc->ulTextColor, this->psDesc->pFont, ulUse);
+        pStyle = &sStyle;
+    }
 
     //
     // Remap position of this canvas
@@ -129,22 +226,23 @@ Canvas::Draw(void)
     //
     // Initialize a drawing context.
     //
-    GrContextInit(&sCtx);
+    this->ContextInit(&sCtx);
 
     //
     // Initialize the clipping region based on the extents of this canvas.
     //
-    GrContextClipRegionSet(&sCtx, &sPosition);
+    sRect = sPosition;
+    this->ClipRegionSet(&sCtx, &sRect);
 
     //
     // See if the canvas outline style is selected.
     //
-    if(this->ulStyle & CANVAS_STYLE_OUTLINE)
+    if(this->psDesc->ulStyle & CANVAS_STYLE_OUTLINE)
     {
         //
         // Outline the canvas with the outline color.
         //
-        GrContextForegroundSet(&sCtx, this->ulOutlineColor);
+        GrContextForegroundSetTranslated(&sCtx, pStyle->ulOutline);
         GrRectDraw(&sCtx, &sPosition);
 
         //
@@ -152,109 +250,107 @@ Canvas::Draw(void)
         // region by one pixel on each side so that the outline is not
         // overwritten by the text or image.
         //
-		sCtx.sClipRegion.sXMin++;
-		sCtx.sClipRegion.sYMin++;
-		sCtx.sClipRegion.sXMax--;
-		sCtx.sClipRegion.sYMax--;
+		sRect.sXMin++;
+		sRect.sYMin++;
+		sRect.sXMax--;
+		sRect.sYMax--;
+		this->ClipRegionSet(&sCtx, &sRect);
     }
 
     //
     // See if any of canvas edge styles are selected.
     //
-	if(this->ulStyle & (CANVAS_STYLE_FALLING_EDGE |
+	if(this->psDesc->ulStyle & (CANVAS_STYLE_FALLING_EDGE |
 			            CANVAS_STYLE_RISING_EDGE))
 	{
 		//
 		// Draw left and top edges
 		//
-		lColor1 = this->ulFillColor;
-		lColor2 = this->ulFillColor;
-
-    	if( this->ulStyle & CANVAS_STYLE_FALLING_EDGE )
+    	if( this->psDesc->ulStyle & CANVAS_STYLE_FALLING_EDGE )
     	{
-//    		ColorValueAdjust(&lColor1, 30);
-    		ColorValueAdjust(&lColor2, 30);
+    		ulColor1 = pStyle->pulFill[WIDGET_STYLE_SHADE_BASE];
+    		ulColor2 = pStyle->pulFill[WIDGET_STYLE_SHADE_LIGHT];
     	}
-		else if( this->ulStyle & CANVAS_STYLE_RISING_EDGE )
+		else
 		{
-    		ColorValueAdjust(&lColor1, -15);
-    		ColorValueAdjust(&lColor2, -50);
+    		ulColor1 = pStyle->pulFill[WIDGET_STYLE_SHADE_DARK];
+    		ulColor2 = pStyle->pulFill[WIDGET_STYLE_SHADE_DARKER];
 		}
 
-		GrContextForegroundSet(&sCtx, lColor1);
-		GrLineDrawH(&sCtx, sCtx.sClipRegion.sXMin,
-				           sCtx.sClipRegion.sXMax - 1,
-				           sCtx.sClipRegion.sYMin);
-		GrLineDrawV(&sCtx, sCtx.sClipRegion.sXMin,
-				           sCtx.sClipRegion.sYMin,
-				           sCtx.sClipRegion.sYMax - 1);
-
-		GrContextForegroundSet(&sCtx, lColor2);
-		GrLineDrawH(&sCtx, sCtx.sClipRegion.sXMin + 1,
-				           sCtx.sClipRegion.sXMax - 2,
-				           sCtx.sClipRegion.sYMin + 1);
-		GrLineDrawV(&sCtx, sCtx.sClipRegion.sXMin + 1,
-				           sCtx.sClipRegion.sYMin + 1,
-				           sCtx.sClipRegion.sYMax - 2);
+		GrContextForegroundSetTranslated(&sCtx, ulColor1);
+		GrLineDrawH(&sCtx, sRect.sXMin,
+				           sRect.sXMax - 1,
+				           sRect.sYMin);
+		GrLineDrawV(&sCtx, sRect.sXMin,
+				           sRect.sYMin,
+				           sRect.sYMax - 1);
+
+		GrContextForegroundSetTranslated(&sCtx, ulColor2);
+		GrLineDrawH(&sCtx, sRect.sXMin + 1,
+				           sRect.sXMax - 2,
+				           sRect.sYMin + 1);
+		GrLineDrawV(&sCtx, sRect.sXMin + 1,
+				           sRect.sYMin + 1,
+				           sRect.sYMax - 2);
 
 		//
 		// Draw right and bottom edges
 		//
-		lColor1 = this->ulFillColor;
-		lColor2 = this->ulFillColor;
-
-    	if( this->ulStyle & CANVAS_STYLE_FALLING_EDGE )
+    	if( this->psDesc->ulStyle & CANVAS_STYLE_FALLING_EDGE )
     	{
-    		ColorValueAdjust(&lColor1, -50);
-    		ColorValueAdjust(&lColor2, -15);
+    		ulColor1 = pStyle->pulFill[WIDGET_STYLE_SHADE_DARKER];
+    		ulColor2 = pStyle->pulFill[WIDGET_STYLE_SHADE_DARK];
     	}
-		else if( this->ulStyle & CANVAS_STYLE_RISING_EDGE )
+		else
 		{
-    		ColorValueAdjust(&lColor1,  30);
-    		ColorValueAdjust(&lColor2,   0);
+    		ulColor1 = pStyle->pulFill[WIDGET_STYLE_SHADE_LIGHT];
+    		ulColor2 = pStyle->pulFill[WIDGET_STYLE_SHADE_BASE];
 		}
 
-    	GrContextForegroundSet(&sCtx, lColor1);
-    	GrLineDrawH(&sCtx, sCtx.sClipRegion.sXMin,
-    			           sCtx.sClipRegion.sXMax,
-    			           sCtx.sClipRegion.sYMax);
-    	GrLineDrawV(&sCtx, sCtx.sClipRegion.sXMax,
-    			           sCtx.sClipRegion.sYMin,
-    			           sCtx.sClipRegion.sYMax);
-
-    	GrContextForegroundSet(&sCtx, lColor2);
-    	GrLineDrawH(&sCtx, sCtx.sClipRegion.sXMin + 1,
-    			           sCtx.sClipRegion.sXMax - 1,
-    			           sCtx.sClipRegion.sYMax - 1);
-    	GrLineDrawV(&sCtx, sCtx.sClipRegion.sXMax - 1,
-    			           sCtx.sClipRegion.sYMin + 1,
-    			           sCtx.sClipRegion.sYMax - 1);
+    	GrContextForegroundSetTranslated(&sCtx, ulColor1);
+    	GrLineDrawH(&sCtx, sRect.sXMin,
+    			           sRect.sXMax,
+    			           sRect.sYMax);
+    	GrLineDrawV(&sCtx, sRect.sXMax,
+    			           sRect.sYMin,
+    			           sRect.sYMax);
+
+    	GrContextForegroundSetTranslated(&sCtx, ulColor2);
+    	GrLineDrawH(&sCtx, sRect.sXMin + 1,
+    			           sRect.sXMax - 1,
+    			           sRect.sYMax - 1);
+    	GrLineDrawV(&sCtx, sRect.sXMax - 1,
+    			           sRect.sYMin + 1,
+    			           sRect.sYMax - 1);
 
     	//
     	// Cut clipping region
     	//
-		sCtx.sClipRegion.sXMin += 2;
-		sCtx.sClipRegion.sYMin += 2;
-		sCtx.sClipRegion.sXMax -= 2;
-		sCtx.sClipRegion.sYMax -= 2;
+		sRect.sXMin += 2;
+		sRect.sYMin += 2;
+		sRect.sXMax -= 2;
+		sRect.sYMax -= 2;
+		this->ClipRegionSet(&sCtx, &sRect);
 	}
 
     //
     // See if the canvas fill style is selected.
     //
-    if(this->ulStyle & CANVAS_STYLE_FILL)
+    if(this->psDesc->ulStyle & CANVAS_STYLE_FILL)
     {
         //
         // Fill the canvas with the fill color.
         //
-        GrContextForegroundSet(&sCtx, this->ulFillColor);
+        GrContextForegroundSetTranslated(&sCtx,
+                                         pStyle->pulFill[WIDGET_STYLE_SHADE_BASE]);
         GrRectFill(&sCtx, &sPosition);
     }
 
     //
     // See if the canvas text or image style is selected.
     //
-    if(this->ulStyle & (CANVAS_STYLE_TEXT | CANVAS_STYLE_IMG | CANVAS_STYLE_GRADIENT))
+    if(this->psDesc->ulStyle & (CANVAS_STYLE_TEXT | CANVAS_STYLE_IMG |
+                                CANVAS_STYLE_GRADIENT))
     {
         //
         // Compute the center of the canvas.
@@ -264,41 +360,43 @@ Canvas::Draw(void)
         lY = (sPosition.sYMin +
               ((sPosition.sYMax - sPosition.sYMin + 1) / 2));
 
-        if(this->ulStyle & CANVAS_STYLE_GRADIENT)
+        if(this->psDesc->ulStyle & CANVAS_STYLE_GRADIENT)
         {
-    		GrContextGradientSet(&sCtx, this->ulGradientColor1,
-    				                    this->ulGradientColor2);
+    		GrContextGradientSet(&sCtx, this->psDesc->ulGradientColor1,
+    				                    this->psDesc->ulGradientColor2);
 
         	GrRectGradientFill(&sCtx, &sPosition);
         }
-        else if(this->ulStyle & CANVAS_STYLE_IMG)
+        else if(this->psDesc->ulStyle & CANVAS_STYLE_IMG)
         {
             //
             // Set the foreground and background colors to use for 1 BPP
             // images.
             //
-            GrContextForegroundSet(&sCtx, this->ulTextColor);
-            GrContextBackgroundSet(&sCtx, this->ulFillColor);
+            GrContextForegroundSetTranslated(&sCtx, pStyle->ulText);
+            GrContextBackgroundSetTranslated(&sCtx,
+                                             pStyle->pulFill[WIDGET_STYLE_SHADE_BASE]);
 
             //
             // Draw the image centered in the canvas.
             //
-            GrImageDraw(&sCtx, this->pucImage,
-                        lX - (GrImageWidthGet(this->pucImage) / 2),
-                        lY - (GrImageHeightGet(this->pucImage) / 2));
+            GrImageDraw(&sCtx, this->psDesc->pucImage,
+                        lX - (GrImageWidthGet(this->psDesc->pucImage) / 2),
+                        lY - (GrImageHeightGet(this->psDesc->pucImage) / 2));
         }
 
         //
         // See if the canvas text style is selected.
         //
-        if(this->ulStyle & CANVAS_STYLE_TEXT)
+        if(this->psDesc->ulStyle & CANVAS_STYLE_TEXT)
         {
             //
             // Set the relevant font and colors.
             //
-            GrContextFontSet(&sCtx, this->pFont);
-            GrContextForegroundSet(&sCtx, this->ulTextColor);
-            GrContextBackgroundSet(&sCtx, this->ulFillColor);
+            GrContextFontSet(&sCtx, pStyle->pFont);
+            GrContextForegroundSetTranslated(&sCtx, pStyle->ulText);
+            GrContextBackgroundSetTranslated(&sCtx,
+                                             pStyle->pulFill[WIDGET_STYLE_SHADE_BASE]);
 
             //
             // Determine the drawing position for the string based on the
@@ -309,29 +407,29 @@ Canvas::Draw(void)
             //
             // How wide is the string?
             //
-            lWidth = GrStringWidthGet(&sCtx, this->pcText, -1);
+            lWidth = GrStringWidthGet(&sCtx, this->psDesc->pcText, -1);
 
-            if(this->ulStyle & CANVAS_STYLE_TEXT_LEFT)
+            if(this->psDesc->ulStyle & CANVAS_STYLE_TEXT_LEFT)
             {
                 //
                 // The string is to be aligned with the left edge of
-                // the widget.  Use the clipping rectangle as reference
+                // the widget.  Use the inner rectangle as reference
                 // since this will ensure that the string doesn't
                 // encroach on any border that is set.
                 //
-                lX = sCtx.sClipRegion.sXMin;
+                lX = sRect.sXMin;
             }
             else
             {
-                if(this->ulStyle & CANVAS_STYLE_TEXT_RIGHT)
+                if(this->psDesc->ulStyle & CANVAS_STYLE_TEXT_RIGHT)
                 {
                     //
                     // The string is to be aligned with the right edge of
-                    // the widget.  Use the clipping rectangle as reference
+                    // the widget.  Use the inner rectangle as reference
                     // since this will ensure that the string doesn't
                     // encroach on any border that is set.
                     //
-                    lX = sCtx.sClipRegion.sXMax - lWidth;
+                    lX = sRect.sXMax - lWidth;
                 }
                 else
                 {
@@ -350,29 +448,29 @@ Canvas::Draw(void)
             //
             // How tall is the string?
             //
-            lHeight = GrStringHeightGet(&sCtx);
+            lHeight = pStyle->lFontHeight;
 
-            if(this->ulStyle & CANVAS_STYLE_TEXT_TOP)
+            if(this->psDesc->ulStyle & CANVAS_STYLE_TEXT_TOP)
             {
                 //
                 // The string is to be aligned with the top edge of
-                // the widget.  Use the clipping rectangle as reference
+                // the widget.  Use the inner rectangle as reference
                 // since this will ensure that the string doesn't
                 // encroach on any border that is set.
                 //
-                lY = sCtx.sClipRegion.sYMin;
+                lY = sRect.sYMin;
             }
             else
             {
-                if(this->ulStyle & CANVAS_STYLE_TEXT_BOTTOM)
+                if(this->psDesc->ulStyle & CANVAS_STYLE_TEXT_BOTTOM)
                 {
                     //
                     // The string is to be aligned with the bottom edge of
-                    // the widget.  Use the clipping rectangle as reference
+                    // the widget.  Use the inner rectangle as reference
                     // since this will ensure that the string doesn't
                     // encroach on any border that is set.
                     //
-                    lY = sCtx.sClipRegion.sYMax - lHeight;
+                    lY = sRect.sYMax - lHeight;
                 }
                 else
                 {
@@ -388,15 +486,15 @@ Canvas::Draw(void)
             //
             // Now draw the string.
             //
-            GrStringDraw(&sCtx, this->pcText, -1, lX, lY,
-                         this->ulStyle & CANVAS_STYLE_TEXT_OPAQUE);
+            GrStringDraw(&sCtx, this->psDesc->pcText, -1, lX, lY,
+                         this->psDesc->ulStyle & CANVAS_STYLE_TEXT_OPAQUE);
         }
     }
 
     //
     // See if this widget have CANVAS_STYLE_PAINT_NOTIFY style.
     //
-    if(this->ulStyle & CANVAS_STYLE_PAINT_NOTIFY)
+    if(this->psDesc->ulStyle & CANVAS_STYLE_PAINT_NOTIFY)
     {
     	//
     	// Send message to parent
@@ -405,6 +503,21 @@ Canvas::Draw(void)
     }
 }
 
+//*****************************************************************************
+//
+//! Destroys a canvas widget.
+//!
+//! This function destroys a canvas widget described by a tCanvasDesc
+//! structure.
+//!
+//! \return None.
+//
+//*****************************************************************************
+CanvasView::~CanvasView(void)
+{
+
+}
+
 //*****************************************************************************
 //
 //! Destroys a canvas widget.
@@ -27,33 +27,13 @@ extern "C"
 
 //*****************************************************************************
 //
-//! The class that describes a canvas widget.
+//! This structure describes the contents of a canvas widget.  It can be
+//! declared \b const, so that a canvas described by it (see CanvasView) keeps
+//! it in flash.
 //
 //*****************************************************************************
-class Canvas : public Widget
+typedef struct
 {
-public:
-	//
-	//! Constructs a canvas widget
-	//
-	Canvas(unsigned char ucID, Widget *pParent, long lX, long lY, long lWidth, long lHeight);
-
-	//
-	//! Draws the contents of a canvas.
-	//
-	void Draw(void);
-
-	//
-	//! Handles messages for a canvas widget.
-	//
-	long MessageProc(unsigned long ulMsg, unsigned long ulParam1,
-			         unsigned long ulParam2);
-
-	//
-	//! Destroys a canvas widget
-	//
-	~Canvas(void);
-
     //
     //! The style for this widget.  This is a set of flags defined by
     //! CANVAS_STYLE_xxx.
@@ -101,15 +81,98 @@ public:
     //! A pointer to the text to draw on this canvas, if CANVAS_STYLE_TEXT is
     //! selected.
     //
-    char *pcText;
+    const char *pcText;
 
     //
     //! A pointer to the image to be drawn onto this canvas, if
     //! CANVAS_STYLE_IMG is selected.
     //
     const unsigned char *pucImage;
+
+    //
+    //! A pointer to the style this canvas is drawn with, or zero to draw it
+    //! with the colors and font above.  The style can be shared by any number
+    //! of widgets.
+    //
+    const WidgetStyle *pStyle;
+}
+tCanvasDesc;
+
+//*****************************************************************************
+//
+//! The class that describes a canvas widget whose contents are described by a
+//! tCanvasDesc structure, which is not copied.
+//
+//*****************************************************************************
+class CanvasView : public Widget
+{
+public:
+	//
+	//! Constructs a canvas widget from its description
+	//
+	CanvasView(unsigned char ucID, Widget *pParent, long lX, long lY,
+	           long lWidth, long lHeight, const tCanvasDesc *psDesc);
+
+	//
+	//! Creates a canvas widget of a widget tree description
+	//
+	static Widget *Create(unsigned char ucID, Widget *pParent, long lX,
+	                      long lY, long lWidth, long lHeight,
+	                      const void *pvDesc);
+
+	//
+	//! Draws the contents of a canvas.
+	//
+	void Draw(void);
+
+	//
+	//! Handles messages for a canvas widget.
+	//
+	long MessageProc(unsigned long ulMsg, unsigned long ulParam1,
+			         unsigned long ulParam2);
+
+	//
+	//! Destroys a canvas widget
+	//
+	~CanvasView(void);
+
+	//
+	//! A pointer to the description of this canvas.
+	//
+	const tCanvasDesc *psDesc;
 };
 
+//*****************************************************************************
+//
+//! The class that describes a canvas widget whose contents are set at run
+//! time, through the fields of tCanvasDesc.
+//
+//*****************************************************************************
+class Canvas : public CanvasView, public tCanvasDesc
+{
+public:
+	//
+	//! Constructs a canvas widget
+	//
+	Canvas(unsigned char ucID, Widget *pParent, long lX, long lY, long lWidth, long lHeight);
+
+	//
+	//! Destroys a canvas widget
+	//
+	~Canvas(void);
+};
+
+//*****************************************************************************
+//
+//! Declares a canvas widget of a widget tree description (see
+//! Widget::TreeCreate()), whose contents are described by the tCanvasDesc
+//! structure pointed to by \e psDesc.
+//
+//*****************************************************************************
+#define CANVAS_DESC(ucDepth, ucID, lX, lY, lWidth, lHeight, psDesc)          \
+        WIDGET_DESC(CanvasView::Create, ucDepth, ucID, lX, lY, lWidth,       \
+                    lHeight, psDesc)
+
 //*****************************************************************************
 //
 //! This flag indicates that the canvas should be filled by gradient.
@@ -16,6 +16,64 @@
 //
 //*****************************************************************************
 
+//*****************************************************************************
+//
+//! Constructs a circular button widget from its description.
+//!
+//! \param lX is the X coordinate of the upper left corner of the circular button.
+//! \param lY is the Y coordinate of the upper left corner of the circular button.
+//! \param lR is the radius of the circular button.
+//! \param psDesc is a pointer to the description of the circular button
+//! contents.
+//!
+//! This function constructs a circular button widget whose contents are
+//! described by \e psDesc, which is referenced rather than copied, and must
+//! stay valid as long as the circular button exists.
+//!
+//! \return None.
+//
+//*****************************************************************************
+CircularButtonView::CircularButtonView(unsigned char ucID, Widget *pParent,
+                                       long lX, long lY, long lR,
+                                       const tCircularButtonDesc *psDesc) :
+	                                   Widget(ucID, pParent, lX-lR, lY-lR, lR*2, lR*2)
+{
+	this->psDesc  = psDesc;
+	this->usState = 0;
+
+	//
+	// A button handles paint requests, the pointer, and its timer.
+	//
+	this->MessageMaskSet(WIDGET_MSG_MASK(WIDGET_MSG_UPDATE) |
+	                     WIDGET_MSG_MASK(WIDGET_MSG_PTR_DOWN) |
+	                     WIDGET_MSG_MASK(WIDGET_MSG_PTR_MOVE) |
+	                     WIDGET_MSG_MASK(WIDGET_MSG_PTR_UP) |
+	                     WIDGET_MSG_MASK(WIDGET_MSG_TIMER));
+}
+
+//*****************************************************************************
+//
+//! Creates a circular button widget of a widget tree description.
+//!
+//! \param pvDesc is a pointer to the tCircularButtonDesc structure that
+//! describes the circular button contents.
+//!
+//! This function is called by Widget::TreeCreate() for the entries declared
+//! with CIRCULAR_BUTTON_DESC().  The other parameters are those of the
+//! constructor, with \e lWidth as the radius.
+//!
+//! \return Returns a pointer to the new circular button, or zero if it could
+//! not be allocated.
+//
+//*****************************************************************************
+Widget *
+CircularButtonView::Create(unsigned char ucID, Widget *pParent, long lX, long lY,
+                           long lWidth, long lHeight, const void *pvDesc)
+{
+	return(new CircularButtonView(ucID, pParent, lX, lY, lWidth,
+	                              (const tCircularButtonDesc *)pvDesc));
+}
+
 //*****************************************************************************
 //
 //! Constructs a circular button widget.
@@ -24,14 +82,21 @@
 //! \param lY is the Y coordinate of the upper left corner of the circular button.
 //! \param lR is the radius of the circular button.
 //!
-//! This function constructs a circular button widget.
+//! This function constructs a circular button widget, whose contents are set
+//! through its fields.
 //!
 //! \return None.
 //
 //*****************************************************************************
-CircularButton::CircularButton(unsigned char ucID, Widget *pParent, long lX, long lY, long lR) :
-		        Widget(ucID, pParent, lX-lR, lY-lR, lR*2, lR*2)
+CircularButton::CircularButton(unsigned char ucID, Widget *pParent,
+                               long lX, long lY, long lR) :
+                               CircularButtonView(ucID, pParent, lX, lY, lR, 0)
 {
+	//
+	// This circular button is described by its own fields.
+	//
+	this->psDesc = this;
+
 	//
 	// Set initial values for all variables
 	//
@@ -46,8 +111,26 @@ CircularButton::CircularButton(unsigned char ucID, Widget *pParent, long lX, lon
 	this->pucPressImage     = 0;
 	this->usAutoRepeatDelay = 0;
 	this->usAutoRepeatRate  = 0;
-	this->ulAutoRepeatTimer = 0;
-	this->bAutoRepeat       = 0;
+	this->pStyle            = 0;
+}
+
+//*****************************************************************************
+//
+//! Gets the style of this circular button, including its state.
+//!
+//! This function returns the style of the description of this circular button,
+//! with the flags of its state added.  \b #CB_STYLE_PRESSED is only taken from
+//! the state, since the circular button sets and clears it itself as it is
+//! pressed and released; \b #CB_STYLE_DISABLED is taken from either, so that
+//! the circular button can also be disabled through its description.
+//!
+//! \return Returns the \b CB_STYLE_xxx flags of this circular button.
+//
+//*****************************************************************************
+unsigned long
+CircularButtonView::StyleGet(void)
+{
+	return((this->psDesc->ulStyle & ~CB_STYLE_PRESSED) | this->usState);
 }
 
 //*****************************************************************************
@@ -61,13 +144,63 @@ CircularButton::CircularButton(unsigned char ucID, Widget *pParent, long lX, lon
 //
 //*****************************************************************************
 void
-CircularButton::Draw(void)
+CircularButtonView::Draw(void)
 {
+    const WidgetStyle *pStyle;
+    const unsigned long *pulFill;
+    WidgetStyle sStyle;
+    unsigned long ulStyle, ulUse;
     const unsigned char *pucImage;
-	tRectangle sPosition;
+	tRectangle sPosition, sRect;
     tContext sCtx;
     long lX, lY, lR;
 
+    ulStyle = this->StyleGet();
+
+    //
+    // Use the style of this circular button, or else translate the colors
+    // of its description that this paint uses: the fill color of the current
+    // state, which is also the background of the image and the text, the
+    // outline color, and the text color.
+    //
+    pStyle = this->psDesc->pStyle;
+
+    if(!pStyle)
+    {
+        ulUse = 0;
+
+        if(ulStyle & (CB_STYLE_FILL | CB_STYLE_IMG | CB_STYLE_TEXT))
+        {
+            ulUse |= ((ulStyle & CB_STYLE_PRESSED) ?
+                      WIDGET_STYLE_USE_PRESS_FILL : WIDGET_STYLE_USE_FILL);
+        }
+        if(ulStyle & CB_STYLE_OUTLINE)
+        {
+            ulUse |= WIDGET_STYLE_USE_OUTLINE;
+        }
+        if((ulStyle & CB_STYLE_IMG) ||
+           ((ulStyle & (CB_STYLE_TEXT | CB_STYLE_DISABLED)) == CB_STYLE_TEXT))
+        {
+            ulUse |= WIDGET_STYLE_USE_TEXT;
+        }
+        if((ulStyle & (CB_STYLE_TEXT | CB_STYLE_DISABLED)) ==
+           (CB_STYLE_TEXT | CB_STYLE_DISABLED))
+        {
+            ulUse |= WIDGET_STYLE_USE_DISABLED;
+        }
+
+        sStyle.Set(Widget::DisplayGet(), this->psDesc->ulFillColor,
+                   this->psDesc->ulPressFillColor, this->psDesc->ulOutlineColor,
+                   this->psDesc->ulTextColor, this->psDesc->pFont, ulUse);
+        pStyle = &sStyle;
+    }
+
+    //
+    // Get the shades of the fill color of the current state.
+    //
+    pulFill = ((ulStyle & CB_STYLE_PRESSED) ? pStyle->pulPressFill :
+               pStyle->pulFill);
+
     //
     // Remap position of this canvas
     //
@@ -76,13 +209,14 @@ CircularButton::Draw(void)
     //
     // Initialize a drawing context.
     //
-    GrContextInit(&sCtx);
+    this->ContextInit(&sCtx);
 
     //
     // Initialize the clipping region based on the extents of this circular
     // circular button.
     //
-    GrContextClipRegionSet(&sCtx, &sPosition);
+    sRect = sPosition;
+    this->ClipRegionSet(&sCtx, &sRect);
 
     //
     // Get the radius of the circular button, along with the X and Y
@@ -95,28 +229,28 @@ CircularButton::Draw(void)
     //
     // See if the circular button outline style is selected.
     //
-    if(this->ulStyle & CB_STYLE_OUTLINE)
+    if(ulStyle & CB_STYLE_OUTLINE)
     {
         //
         // Outline the circular button with the outline color.
         //
-        GrContextForegroundSet(&sCtx, this->ulOutlineColor);
+        GrContextForegroundSetTranslated(&sCtx, pStyle->ulOutline);
         GrCircleDraw(&sCtx, lX, lY, lR);
 
-        sCtx.sClipRegion.sXMin++;
-        sCtx.sClipRegion.sYMin++;
-        sCtx.sClipRegion.sXMax--;
-        sCtx.sClipRegion.sYMax--;
+        sRect.sXMin++;
+        sRect.sYMin++;
+        sRect.sXMax--;
+        sRect.sYMax--;
+        this->ClipRegionSet(&sCtx, &sRect);
     }
 
-    if(this->ulStyle & CB_STYLE_FILL)
+    if(ulStyle & CB_STYLE_FILL)
     {
         //
         // Fill the circular button with the fill color.
         //
-        GrContextForegroundSet(&sCtx, ((this->ulStyle & CB_STYLE_PRESSED) ?
-                                       this->ulPressFillColor :
-                                       this->ulFillColor));
+        GrContextForegroundSetTranslated(&sCtx,
+                                         pulFill[WIDGET_STYLE_SHADE_BASE]);
         GrCircleFill(&sCtx, lX, lY, lR);
     }
 
@@ -124,29 +258,27 @@ CircularButton::Draw(void)
     //
     // See if the circular button text or image style is selected.
     //
-    if(this->ulStyle & (CB_STYLE_TEXT | CB_STYLE_IMG))
+    if(ulStyle & (CB_STYLE_TEXT | CB_STYLE_IMG))
     {
         //
         // See if the circular button image style is selected.
         //
-        if(this->ulStyle & CB_STYLE_IMG)
+        if(ulStyle & CB_STYLE_IMG)
         {
             //
             // Set the foreground and background colors to use for 1 BPP
             // images.
             //
-            GrContextForegroundSet(&sCtx, this->ulTextColor);
-            GrContextBackgroundSet(&sCtx,
-                                   ((this->ulStyle & CB_STYLE_PRESSED) ?
-                                    this->ulPressFillColor :
-                                    this->ulFillColor));
+            GrContextForegroundSetTranslated(&sCtx, pStyle->ulText);
+            GrContextBackgroundSetTranslated(&sCtx,
+                                     pulFill[WIDGET_STYLE_SHADE_BASE]);
 
             //
             // Get the image to be drawn.
             //
-            pucImage = (((this->ulStyle & CB_STYLE_PRESSED) &&
-                         this->pucPressImage) ?
-                        this->pucPressImage : this->pucImage);
+            pucImage = (((ulStyle & CB_STYLE_PRESSED) &&
+                         this->psDesc->pucPressImage) ?
+                        this->psDesc->pucPressImage : this->psDesc->pucImage);
 
             //
             // Draw the image centered in the circular button.
@@ -158,31 +290,29 @@ CircularButton::Draw(void)
         //
         // See if the circular button text style is selected.
         //
-        if(this->ulStyle & CB_STYLE_TEXT)
+        if(ulStyle & CB_STYLE_TEXT)
         {
             //
             // Draw the text centered in the middle of the circular button.
             //
-            GrContextFontSet(&sCtx, this->pFont);
+            GrContextFontSet(&sCtx, pStyle->pFont);
 
-            if(this->ulStyle & CB_STYLE_DISABLED)
+            if(ulStyle & CB_STYLE_DISABLED)
             {
-            	GrContextForegroundSet(&sCtx, ClrGray);
+            	GrContextForegroundSetTranslated(&sCtx, pStyle->ulDisabledText);
             }
             else
             {
-            	GrContextForegroundSet(&sCtx, this->ulTextColor);
+            	GrContextForegroundSetTranslated(&sCtx, pStyle->ulText);
             }
 
-            GrContextBackgroundSet(&sCtx,
-                                   ((this->ulStyle & CB_STYLE_PRESSED) ?
-                                    this->ulPressFillColor :
-                                    this->ulFillColor));
-//            GrStringDrawCentered(&sCtx, this->pcText, -1, lX, lY,
-//                                 this->ulStyle & CB_STYLE_TEXT_OPAQUE);
+            GrContextBackgroundSetTranslated(&sCtx,
+                                     pulFill[WIDGET_STYLE_SHADE_BASE]);
+//            GrStringDrawCentered(&sCtx, this->psDesc->pcText, -1, lX, lY,
+//                                 ulStyle & CB_STYLE_TEXT_OPAQUE);
 
-            GrStringDrawCentered(&sCtx, this->pcText, -1, &sPosition,
-                                 this->ulStyle & CB_STYLE_TEXT_OPAQUE);
+            GrStringDrawCentered(&sCtx, this->psDesc->pcText, -1, &sPosition,
+                                 ulStyle & CB_STYLE_TEXT_OPAQUE);
         }
     }
 }
@@ -204,7 +334,7 @@ CircularButton::Draw(void)
 //
 //*****************************************************************************
 long
-CircularButton::Click(unsigned long ulMsg, long lX, long lY)
+CircularButtonView::Click(unsigned long ulMsg, long lX, long lY)
 {
 	tRectangle sPosition;
     long lXc, lYc, lR;
@@ -216,14 +346,16 @@ CircularButton::Click(unsigned long ulMsg, long lX, long lY)
 	lXc = sPosition.sXMin + lR;
 	lYc = sPosition.sYMin + lR;
 
-    if(!(this->ulStyle & CB_STYLE_DISABLED))
+    if(!(this->StyleGet() & CB_STYLE_DISABLED))
     {
         switch(ulMsg)
         {
         case WIDGET_MSG_PTR_UP:
-        	if(this->ulStyle & CB_STYLE_PRESSED)
+        	if(this->StyleGet() & CB_STYLE_PRESSED)
         	{
-    			this->ulStyle &= ~(CB_STYLE_PRESSED);
+    			this->usState &= ~(CB_STYLE_PRESSED);
+
+    			Widget::AutoRepeatStop();
 
             	if(((((lX - lXc) * (lX - lXc)) + ((lY - lYc) * (lY - lYc))) <= (lR * lR)))
     			{
@@ -238,10 +370,17 @@ CircularButton::Click(unsigned long ulMsg, long lX, long lY)
         case WIDGET_MSG_PTR_DOWN:
         	if(((((lX - lXc) * (lX - lXc)) + ((lY - lYc) * (lY - lYc))) <= (lR * lR)))
         	{
-                this->ulStyle |= CB_STYLE_PRESSED;
+                this->usState |= CB_STYLE_PRESSED;
 
-    			this->ulAutoRepeatTimer = GrTimerGet();
-    			this->bAutoRepeat = 0;
+    			//
+    			// Start generating the auto-repeat events, if needed.
+    			//
+    			if(this->StyleGet() & CB_STYLE_AUTO_REPEAT)
+    			{
+    				this->AutoRepeatStart(this->psDesc->usAutoRepeatDelay,
+    				                      this->psDesc->usAutoRepeatRate ?
+    				                      this->psDesc->usAutoRepeatRate : 1);
+    			}
 
     			Widget::ParentNotify(this, WIDGET_NOTIFY_BTN_PRESSED);
 
@@ -251,32 +390,8 @@ CircularButton::Click(unsigned long ulMsg, long lX, long lY)
         	break;
 
         case WIDGET_MSG_PTR_MOVE:
-        	if(this->ulStyle & CB_STYLE_PRESSED)
+        	if(this->StyleGet() & CB_STYLE_PRESSED)
         	{
-        		if(this->ulStyle & CB_STYLE_AUTO_REPEAT)
-        		{
-    				if(!bAutoRepeat)
-    				{
-    					if((GrTimerGet() - this->ulAutoRepeatTimer) >= this->usAutoRepeatDelay)
-    					{
-    						bAutoRepeat = 1;
-
-    						this->ulAutoRepeatTimer = GrTimerGet();
-
-    						Widget::ParentNotify(this, WIDGET_NOTIFY_BTN_PRESSED);
-    					}
-    				}
-    				else
-    				{
-    					if((GrTimerGet() - this->ulAutoRepeatTimer) >= this->usAutoRepeatRate)
-    					{
-    						this->ulAutoRepeatTimer = GrTimerGet();
-
-    						Widget::ParentNotify(this, WIDGET_NOTIFY_BTN_PRESSED);
-    					}
-    				}
-        		}
-
         		lRet = 1;
         	}
 
@@ -303,7 +418,7 @@ CircularButton::Click(unsigned long ulMsg, long lX, long lY)
 //
 //*****************************************************************************
 long
-CircularButton::MessageProc(unsigned long ulMsg, unsigned long ulParam1,
+CircularButtonView::MessageProc(unsigned long ulMsg, unsigned long ulParam1,
 		                    unsigned long ulParam2)
 {
     //
@@ -333,6 +448,26 @@ CircularButton::MessageProc(unsigned long ulMsg, unsigned long ulParam1,
             return(1);
         }
 
+        //
+        // A timer of this widget has expired.
+        //
+        case WIDGET_MSG_TIMER:
+        {
+            //
+            // Generate an auto-repeat event if the button is still pressed.
+            //
+            if(this->AutoRepeatIs(ulParam1) &&
+               ((this->StyleGet() & (CB_STYLE_PRESSED | CB_STYLE_DISABLED)) ==
+                CB_STYLE_PRESSED))
+            {
+            	Widget::ParentNotify(this, WIDGET_NOTIFY_BTN_PRESSED);
+
+            	return(1);
+            }
+
+            return(0);
+        }
+
         //
         // One of the pointer requests has been sent.
         //
@@ -356,6 +491,21 @@ CircularButton::MessageProc(unsigned long ulMsg, unsigned long ulParam1,
     }
 }
 
+//*****************************************************************************
+//
+//! Destroys a circular button widget.
+//!
+//! This function destroys a circular button widget described by a
+//! tCircularButtonDesc structure.
+//!
+//! \return None.
+//
+//*****************************************************************************
+CircularButtonView::~CircularButtonView(void)
+{
+
+}
+
 //*****************************************************************************
 //
 //! Destroys a circular button widget.
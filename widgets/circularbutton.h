@@ -27,38 +27,13 @@ extern "C"
 
 //*****************************************************************************
 //
-//! The class that describes a circular button widget.
+//! This structure describes the contents of a circular button widget.  It can
+//! be declared \b const, so that a circular button described by it (see
+//! CircularButtonView) keeps it in flash.
 //
 //*****************************************************************************
-class CircularButton : public Widget
+typedef struct
 {
-public:
-	//
-	//! Constructs a CircularButton widget
-	//
-	CircularButton(unsigned char ucID, Widget *pParent, long lX, long lY, long lR);
-
-	//
-	//! Draws the contents of a circular button.
-	//
-	void Draw(void);
-
-	//
-	//! Handles pointer events for a circular button.
-	//
-	long Click(unsigned long ulMsg, long lX, long lY);
-
-	//
-	//! Handles messages for a circular button widget.
-	//
-	long MessageProc(unsigned long ulMsg, unsigned long ulParam1,
-			         unsigned long ulParam2);
-
-	//
-	//! Destroys a CircularButton widget
-	//
-	~CircularButton(void);
-
     //
     //! The style for this widget.  This is a set of flags defined by
     //! CB_STYLE_xxx.
@@ -101,7 +76,7 @@ public:
     //! A pointer to the text to draw on this circular button, if CB_STYLE_TEXT is
     //! selected.
     //
-    char *pcText;
+    const char *pcText;
 
     //
     //! A pointer to the image to be drawn onto this circular button, if
@@ -116,33 +91,120 @@ public:
     const unsigned char *pucPressImage;
 
     //
-    //! The number of pointer events to delay before starting to auto-repeat,
-    //! if CB_STYLE_AUTO_REPEAT is selected.  The amount of time to which this
-    //! corresponds is dependent upon the rate at which pointer events are
-    //! generated by the pointer driver.
+    //! The time, in milliseconds, to delay before starting to auto-repeat, if
+    //! CB_STYLE_AUTO_REPEAT is selected.
     //
     unsigned short usAutoRepeatDelay;
 
     //
-    //! The number of pointer events between button presses generated by the
-    //! auto-repeat function, if CB_STYLE_AUTO_REPEAT is selected.  The amount
-    //! of time to which this corresponds is dependent up on the rate at which
-    //! pointer events are generated by the pointer driver.
+    //! The time, in milliseconds, between button presses generated by the
+    //! auto-repeat function, if CB_STYLE_AUTO_REPEAT is selected.
     //
     unsigned short usAutoRepeatRate;
 
     //
-    //! The number of pointer events that have occurred.  This is used when
-    //! CB_STYLE_AUTO_REPEAT is selected to generate the auto-repeat events.
+    //! A pointer to the style this circular button is drawn with, or zero to draw it
+    //! with the colors and font above.  The style can be shared by any number
+    //! of widgets.
     //
-    unsigned long ulAutoRepeatTimer;
+    const WidgetStyle *pStyle;
+}
+tCircularButtonDesc;
 
-    //
-    //! Indicate that button is in autorepeat state.
-    //
-    unsigned char bAutoRepeat;
+//*****************************************************************************
+//
+//! The class that describes a circular button widget whose contents are
+//! described by a tCircularButtonDesc structure, which is not copied.
+//
+//*****************************************************************************
+class CircularButtonView : public Widget
+{
+public:
+	//
+	//! Constructs a CircularButton widget from its description
+	//
+	CircularButtonView(unsigned char ucID, Widget *pParent, long lX, long lY, long lR,
+	                   const tCircularButtonDesc *psDesc);
+
+	//
+	//! Creates a circular button widget of a widget tree description
+	//
+	static Widget *Create(unsigned char ucID, Widget *pParent, long lX,
+	                      long lY, long lWidth, long lHeight,
+	                      const void *pvDesc);
+
+	//
+	//! Gets the style of this circular button, including its state.
+	//
+	unsigned long StyleGet(void);
+
+	//
+	//! Draws the contents of a circular button.
+	//
+	void Draw(void);
+
+	//
+	//! Handles pointer events for a circular button.
+	//
+	long Click(unsigned long ulMsg, long lX, long lY);
+
+	//
+	//! Handles messages for a circular button widget.
+	//
+	long MessageProc(unsigned long ulMsg, unsigned long ulParam1,
+			         unsigned long ulParam2);
+
+	//
+	//! Destroys a CircularButton widget
+	//
+	~CircularButtonView(void);
+
+	//
+	//! The flags of the style that change at run time, which are added to the
+	//! style of the description (see StyleGet()): CB_STYLE_PRESSED, which
+	//! is never taken from the description, and CB_STYLE_DISABLED if the
+	//! application disables this circular button.
+	//
+	unsigned short usState;
+
+	//
+	//! A pointer to the description of this circular button.
+	//
+	const tCircularButtonDesc *psDesc;
 };
 
+//*****************************************************************************
+//
+//! The class that describes a circular button widget whose contents are set at
+//! run time, through the fields of tCircularButtonDesc.
+//
+//*****************************************************************************
+class CircularButton : public CircularButtonView, public tCircularButtonDesc
+{
+public:
+	//
+	//! Constructs a CircularButton widget
+	//
+	CircularButton(unsigned char ucID, Widget *pParent, long lX, long lY, long lR);
+
+	//
+	//! Destroys a CircularButton widget
+	//
+	~CircularButton(void);
+};
+
+//*****************************************************************************
+//
+//! Declares a circular button widget of a widget tree description (see
+//! Widget::TreeCreate()), whose contents are described by the
+//! tCircularButtonDesc structure pointed to by \e psDesc.  \e lX and \e lY
+//! are the center of the button, and \e lR its radius.
+//
+//*****************************************************************************
+#define CIRCULAR_BUTTON_DESC(ucDepth, ucID, lX, lY, lR, psDesc) \
+        WIDGET_DESC(CircularButtonView::Create, ucDepth, ucID, lX, lY, lR, \
+                    lR, psDesc)
+
 //*****************************************************************************
 //
 //! This flag indicates that the circular button should be outlined.
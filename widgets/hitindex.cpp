@@ -0,0 +1,372 @@
+//*****************************************************************************
+//
+// hitindex.cpp - Pointer hit-test index.
+//
+//*****************************************************************************
+
+#include "grlib.h"
+#include "widget.h"
+#include "hitindex.h"
+
+//*****************************************************************************
+//
+//! \addtogroup widget_api
+//! @{
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+//! The number of cells of the hit-test grid.
+//
+//*****************************************************************************
+#define HIT_INDEX_CELLS         (HIT_INDEX_COLUMNS * HIT_INDEX_ROWS)
+
+//*****************************************************************************
+//
+//! Constructs a hit-test index.
+//!
+//! This function constructs an empty hit-test index.  It is built from the
+//! widget tree on the first pointer message.  If the library is built with
+//! \b WIDGET_NO_HEAP defined, the index holds up to \b HIT_INDEX_CAPACITY
+//! entries.
+//!
+//! \return None.
+//
+//*****************************************************************************
+HitIndex::HitIndex(void)
+{
+#ifdef WIDGET_NO_HEAP
+	this->ppWidgets   = this->ppStorage;
+	this->ulCapacity  = HIT_INDEX_CAPACITY;
+#else
+	this->ppWidgets   = 0;
+	this->ulCapacity  = 0;
+#endif
+	this->lCellWidth  = 1;
+	this->lCellHeight = 1;
+	this->pRoot       = 0;
+	this->bValid      = 0;
+	this->bOverflow   = 0;
+}
+
+//*****************************************************************************
+//
+//! Gets the range of cells covered by a rectangle.
+//!
+//! \param psRect is a pointer to the absolute rectangle.
+//! \param plCol1 is a pointer to the first column covered.
+//! \param plRow1 is a pointer to the first row covered.
+//! \param plCol2 is a pointer to the last column covered.
+//! \param plRow2 is a pointer to the last row covered.
+//!
+//! \return Returns 0 if the rectangle lies outside of the display, and 1
+//! otherwise.
+//
+//*****************************************************************************
+long
+HitIndex::CellsGet(const tRectangle *psRect, long *plCol1, long *plRow1,
+                   long *plCol2, long *plRow2)
+{
+	long lXMin, lYMin, lXMax, lYMax, lMax;
+
+	//
+	// Clip the rectangle to the display.
+	//
+	lXMin = (psRect->sXMin < 0) ? 0 : psRect->sXMin;
+	lYMin = (psRect->sYMin < 0) ? 0 : psRect->sYMin;
+
+	lMax = (this->lCellWidth * HIT_INDEX_COLUMNS) - 1;
+	lXMax = (psRect->sXMax > lMax) ? lMax : psRect->sXMax;
+
+	lMax = (this->lCellHeight * HIT_INDEX_ROWS) - 1;
+	lYMax = (psRect->sYMax > lMax) ? lMax : psRect->sYMax;
+
+	if((lXMin > lXMax) || (lYMin > lYMax))
+	{
+		return(0);
+	}
+
+	*plCol1 = lXMin / this->lCellWidth;
+	*plRow1 = lYMin / this->lCellHeight;
+	*plCol2 = lXMax / this->lCellWidth;
+	*plRow2 = lYMax / this->lCellHeight;
+
+	return(1);
+}
+
+//*****************************************************************************
+//
+//! Rebuilds the index for a widget tree.
+//!
+//! \param pRoot is a pointer to the root of the widget tree.
+//! \param pDisplay is a pointer to the display the widget tree is drawn onto.
+//!
+//! This function lists, for every cell of the grid, the widgets of the tree
+//! whose absolute rectangle overlaps the cell and which handle
+//! \b #WIDGET_MSG_PTR_DOWN.  The tree is walked twice in post-order: once to
+//! count the widgets of each cell, and once to store them.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+HitIndex::Build(Widget *pRoot, const tDisplay *pDisplay)
+{
+	unsigned long ulCell, ulTotal;
+	long lCol, lRow, lCol1, lRow1, lCol2, lRow2;
+	unsigned long ulMask;
+	tRectangle sPosition;
+	Widget *pWidget;
+
+	//
+	// Only the widgets that handle pointer presses are indexed.
+	//
+	ulMask = WIDGET_MSG_MASK(WIDGET_MSG_PTR_DOWN);
+
+	//
+	// Size the cells so that the grid covers the display.
+	//
+	this->lCellWidth = (DpyWidthGet(pDisplay) + HIT_INDEX_COLUMNS - 1) /
+	                   HIT_INDEX_COLUMNS;
+	this->lCellHeight = (DpyHeightGet(pDisplay) + HIT_INDEX_ROWS - 1) /
+	                    HIT_INDEX_ROWS;
+
+	if(this->lCellWidth < 1)
+	{
+		this->lCellWidth = 1;
+	}
+
+	if(this->lCellHeight < 1)
+	{
+		this->lCellHeight = 1;
+	}
+
+	//
+	// Count the widgets of each cell, in ulCellStart[ulCell + 1].
+	//
+	for(ulCell = 0; ulCell <= HIT_INDEX_CELLS; ulCell++)
+	{
+		this->ulCellStart[ulCell] = 0;
+	}
+
+	for(pWidget = pRoot->SubscriberPostOrderSearch(0, ulMask); pWidget;
+	    pWidget = pRoot->SubscriberPostOrderSearch(pWidget, ulMask))
+	{
+		pWidget->AbsolutePositionGet(&sPosition);
+
+		if(this->CellsGet(&sPosition, &lCol1, &lRow1, &lCol2, &lRow2))
+		{
+			for(lRow = lRow1; lRow <= lRow2; lRow++)
+			{
+				for(lCol = lCol1; lCol <= lCol2; lCol++)
+				{
+					this->ulCellStart[(lRow * HIT_INDEX_COLUMNS) + lCol + 1]++;
+				}
+			}
+		}
+	}
+
+	//
+	// Turn the counts into the index of the first widget of each cell.
+	//
+	for(ulCell = 0; ulCell < HIT_INDEX_CELLS; ulCell++)
+	{
+		this->ulCellStart[ulCell + 1] += this->ulCellStart[ulCell];
+	}
+
+	//
+	// Grow the widget list if needed.
+	//
+	ulTotal = this->ulCellStart[HIT_INDEX_CELLS];
+
+	if(ulTotal > this->ulCapacity)
+	{
+#ifdef WIDGET_NO_HEAP
+		//
+		// The widget list cannot grow without the heap, so the whole tree
+		// will be searched until it fits again.
+		//
+		this->pRoot = pRoot;
+		this->bValid = 1;
+		this->bOverflow = 1;
+		return;
+#else
+		delete[] this->ppWidgets;
+
+		this->ppWidgets = new Widget *[ulTotal];
+		this->ulCapacity = ulTotal;
+#endif
+	}
+
+	//
+	// Store the widgets, using the start of each cell as a cursor, which
+	// leaves it pointing at the start of the next cell.
+	//
+	for(pWidget = pRoot->SubscriberPostOrderSearch(0, ulMask); pWidget;
+	    pWidget = pRoot->SubscriberPostOrderSearch(pWidget, ulMask))
+	{
+		pWidget->AbsolutePositionGet(&sPosition);
+
+		if(this->CellsGet(&sPosition, &lCol1, &lRow1, &lCol2, &lRow2))
+		{
+			for(lRow = lRow1; lRow <= lRow2; lRow++)
+			{
+				for(lCol = lCol1; lCol <= lCol2; lCol++)
+				{
+					ulCell = (lRow * HIT_INDEX_COLUMNS) + lCol;
+					this->ppWidgets[this->ulCellStart[ulCell]++] = pWidget;
+				}
+			}
+		}
+	}
+
+	//
+	// Shift the cursors back to the start of their own cell.
+	//
+	for(ulCell = HIT_INDEX_CELLS; ulCell > 0; ulCell--)
+	{
+		this->ulCellStart[ulCell] = this->ulCellStart[ulCell - 1];
+	}
+	this->ulCellStart[0] = 0;
+
+	this->pRoot = pRoot;
+	this->bValid = 1;
+	this->bOverflow = 0;
+}
+
+//*****************************************************************************
+//
+//! Sends a pointer message to the widgets under the pointer.
+//!
+//! \param pRoot is a pointer to the root of the widget tree.
+//! \param ulMessage is the pointer message to send.
+//! \param lX is the X coordinate of the pointer.
+//! \param lY is the Y coordinate of the pointer.
+//! \param ppWidget is a pointer to storage for the widget that accepted the
+//! message, which is left unchanged if no widget accepted it.
+//!
+//! This function offers a pointer message to the widgets whose absolute
+//! rectangle contains the pointer, in the post-order of the widget tree, until
+//! one of them accepts it.  This is the same order a post-order search of the
+//! whole tree would use, without visiting the widgets elsewhere on the
+//! display.  The index is rebuilt first if the widget tree has changed.
+//!
+//! \return Returns the value returned by the widget that accepted the
+//! message, or 0 if no widget accepted it.
+//
+//*****************************************************************************
+long
+HitIndex::MessageSend(Widget *pRoot, unsigned long ulMessage, long lX,
+                      long lY, Widget **ppWidget)
+{
+	unsigned long ulIdx, ulEnd, ulMask;
+	tRectangle sPosition;
+	Widget *pWidget;
+	long lRet;
+
+	//
+	// Rebuild the index if it is out of date.
+	//
+	if(!this->bValid || (this->pRoot != pRoot))
+	{
+		this->Build(pRoot, Widget::DisplayGet());
+	}
+
+	//
+	// Search the whole tree, in post-order, if it does not fit in the index.
+	//
+	if(this->bOverflow)
+	{
+		ulMask = WIDGET_MSG_MASK(ulMessage);
+
+		for(pWidget = pRoot->SubscriberPostOrderSearch(0, ulMask); pWidget;
+		    pWidget = pRoot->SubscriberPostOrderSearch(pWidget, ulMask))
+		{
+			lRet = pWidget->MessageProc(ulMessage, lX, lY);
+
+			if(lRet != 0)
+			{
+				*ppWidget = pWidget;
+				return(lRet);
+			}
+		}
+
+		return(0);
+	}
+
+	//
+	// Nothing can be hit outside of the grid.
+	//
+	if((lX < 0) || (lY < 0) ||
+	   (lX >= (this->lCellWidth * HIT_INDEX_COLUMNS)) ||
+	   (lY >= (this->lCellHeight * HIT_INDEX_ROWS)))
+	{
+		return(0);
+	}
+
+	//
+	// Loop through the widgets of the cell under the pointer.
+	//
+	ulIdx = ((lY / this->lCellHeight) * HIT_INDEX_COLUMNS) +
+	        (lX / this->lCellWidth);
+	ulEnd = this->ulCellStart[ulIdx + 1];
+
+	for(ulIdx = this->ulCellStart[ulIdx]; ulIdx < ulEnd; ulIdx++)
+	{
+		pWidget = this->ppWidgets[ulIdx];
+
+		//
+		// Skip the widgets that do not contain the pointer.
+		//
+		pWidget->AbsolutePositionGet(&sPosition);
+
+		if(!GrRectContainsPoint(&sPosition, lX, lY))
+		{
+			continue;
+		}
+
+		//
+		// Send the message to this widget and return if it succeeded.
+		//
+		lRet = pWidget->MessageProc(ulMessage, lX, lY);
+
+		if(lRet != 0)
+		{
+			*ppWidget = pWidget;
+			return(lRet);
+		}
+
+		//
+		// Stop if the widget changed the tree, since the rest of the list may
+		// refer to widgets that no longer exist.
+		//
+		if(!this->bValid)
+		{
+			break;
+		}
+	}
+
+	return(0);
+}
+
+//*****************************************************************************
+//
+//! Destroys a hit-test index.
+//!
+//! \return None.
+//
+//*****************************************************************************
+HitIndex::~HitIndex(void)
+{
+#ifndef WIDGET_NO_HEAP
+	delete[] this->ppWidgets;
+#endif
+}
+
+//*****************************************************************************
+//
+// Close the Doxygen group.
+//! @}
+//
+//*****************************************************************************
@@ -0,0 +1,167 @@
+//*****************************************************************************
+//
+// hitindex.h - Prototypes for the pointer hit-test index.
+//
+//*****************************************************************************
+
+#ifndef __HITINDEX_H__
+#define __HITINDEX_H__
+
+#include "grlib.h"
+#include "widget.h"
+
+//*****************************************************************************
+//
+//! \addtogroup widget_api
+//! @{
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// If building with a C++ compiler, make all of the definitions in this header
+// have a C binding.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+//! The number of columns and rows of the hit-test grid.  The display is split
+//! into this many cells, and each cell lists the widgets that overlap it.
+//
+//*****************************************************************************
+#ifndef HIT_INDEX_COLUMNS
+#define HIT_INDEX_COLUMNS       8
+#endif
+
+#ifndef HIT_INDEX_ROWS
+#define HIT_INDEX_ROWS          8
+#endif
+
+//*****************************************************************************
+//
+//! The number of entries of the widget list of the hit-test index, when the
+//! library is built with \b WIDGET_NO_HEAP defined.  A widget counts once for
+//! every cell it overlaps.  If the widget tree needs more entries, pointer
+//! presses are sent to the whole widget tree instead.
+//
+//*****************************************************************************
+#ifndef HIT_INDEX_CAPACITY
+#define HIT_INDEX_CAPACITY      256
+#endif
+
+//*****************************************************************************
+//
+//! This class describes a uniform grid over the absolute widget rectangles,
+//! used to find the widgets under a pointer without searching the whole
+//! widget tree.
+//
+//*****************************************************************************
+class HitIndex
+{
+public:
+	//
+	//! Constructor.
+	//
+	HitIndex(void);
+
+	//
+	//! Marks the index as out of date.
+	//
+	void Invalidate(void)
+	{
+		this->bValid = 0;
+	}
+
+	//
+	//! Sends a pointer message to the widgets under the pointer.
+	//
+	long MessageSend(Widget *pRoot, unsigned long ulMessage, long lX, long lY,
+	                 Widget **ppWidget);
+
+	//
+	//! Destructor.
+	//
+	~HitIndex(void);
+
+private:
+	//
+	//! Rebuilds the index for a widget tree.
+	//
+	void Build(Widget *pRoot, const tDisplay *pDisplay);
+
+	//
+	//! Gets the range of cells covered by a rectangle.
+	//
+	long CellsGet(const tRectangle *psRect, long *plCol1, long *plRow1,
+	              long *plCol2, long *plRow2);
+
+	//
+	//! The widgets of each cell, stored one cell after another.  Within a
+	//! cell the widgets are in the post-order of the widget tree, so that the
+	//! deepest widget drawn last comes first.
+	//
+	Widget **ppWidgets;
+
+	//
+	//! The number of entries ppWidgets can hold.
+	//
+	unsigned long ulCapacity;
+
+#ifdef WIDGET_NO_HEAP
+	//
+	//! The storage of the widget list, since the heap is not used.
+	//
+	Widget *ppStorage[HIT_INDEX_CAPACITY];
+#endif
+
+	//
+	//! The index in ppWidgets of the first widget of each cell; the widgets
+	//! of cell N are in [ulCellStart[N], ulCellStart[N + 1]).
+	//
+	unsigned long ulCellStart[(HIT_INDEX_COLUMNS * HIT_INDEX_ROWS) + 1];
+
+	//
+	//! The width and height of a cell in pixels.
+	//
+	long lCellWidth;
+	long lCellHeight;
+
+	//
+	//! The root of the widget tree the index was built for.
+	//
+	Widget *pRoot;
+
+	//
+	//! Non-zero if the index matches the widget tree.
+	//
+	char bValid;
+
+	//
+	//! Non-zero if the widget tree does not fit in the index, in which case
+	//! the whole tree is searched.
+	//
+	char bOverflow;
+};
+
+//*****************************************************************************
+//
+// Mark the end of the C bindings section for C++ compilers.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+}
+#endif
+
+//*****************************************************************************
+//
+// Close the Doxygen group.
+//! @}
+//
+//*****************************************************************************
+
+#endif // __HITINDEX_H__
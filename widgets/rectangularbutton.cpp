@@ -16,6 +16,66 @@
 //
 //*****************************************************************************
 
+//*****************************************************************************
+//
+//! Constructs a rectangular button widget from its description.
+//!
+//! \param lX is the X coordinate of the upper left corner of the rectangular button.
+//! \param lY is the Y coordinate of the upper left corner of the rectangular button.
+//! \param lWidth is the width of the rectangular button.
+//! \param lHeight is the height of the rectangular button.
+//! \param psDesc is a pointer to the description of the rectangular button
+//! contents.
+//!
+//! This function constructs a rectangular button widget whose contents are
+//! described by \e psDesc, which is referenced rather than copied, and must
+//! stay valid as long as the rectangular button exists.
+//!
+//! \return None.
+//
+//*****************************************************************************
+RectangularButtonView::RectangularButtonView(unsigned char ucID,
+                                             Widget *pParent, long lX, long lY,
+                                             long lWidth, long lHeight,
+                                             const tRectangularButtonDesc *psDesc) :
+	                                         Widget(ucID, pParent, lX, lY, lWidth, lHeight)
+{
+	this->psDesc  = psDesc;
+	this->usState = 0;
+
+	//
+	// A button handles paint requests, the pointer, and its timer.
+	//
+	this->MessageMaskSet(WIDGET_MSG_MASK(WIDGET_MSG_UPDATE) |
+	                     WIDGET_MSG_MASK(WIDGET_MSG_PTR_DOWN) |
+	                     WIDGET_MSG_MASK(WIDGET_MSG_PTR_MOVE) |
+	                     WIDGET_MSG_MASK(WIDGET_MSG_PTR_UP) |
+	                     WIDGET_MSG_MASK(WIDGET_MSG_TIMER));
+}
+
+//*****************************************************************************
+//
+//! Creates a rectangular button widget of a widget tree description.
+//!
+//! \param pvDesc is a pointer to the tRectangularButtonDesc structure that
+//! describes the rectangular button contents.
+//!
+//! This function is called by Widget::TreeCreate() for the entries declared
+//! with RECTANGULAR_BUTTON_DESC().  The other parameters are those of the
+//! constructor.
+//!
+//! \return Returns a pointer to the new rectangular button, or zero if it could
+//! not be allocated.
+//
+//*****************************************************************************
+Widget *
+RectangularButtonView::Create(unsigned char ucID, Widget *pParent, long lX, long lY,
+                              long lWidth, long lHeight, const void *pvDesc)
+{
+	return(new RectangularButtonView(ucID, pParent, lX, lY, lWidth, lHeight,
+	                                 (const tRectangularButtonDesc *)pvDesc));
+}
+
 //*****************************************************************************
 //
 //! Constructs a rectangular button widget.
@@ -25,15 +85,23 @@
 //! \param lWidth is the width of the rectangular button.
 //! \param lHeight is the height of the rectangular button.
 //!
-//! This function constructs a rectangular button widget.
+//! This function constructs a rectangular button widget, whose contents are set
+//! through its fields.
 //!
 //! \return None.
 //
 //*****************************************************************************
 RectangularButton::RectangularButton(unsigned char ucID, Widget *pParent,
-		                             long lX, long lY, long lWidth, long lHeight) :
-	                                 Widget(ucID, pParent, lX, lY, lWidth, lHeight)
+                                     long lX, long lY, long lWidth,
+                                     long lHeight) :
+                                     RectangularButtonView(ucID, pParent, lX, lY,
+                                                           lWidth, lHeight, 0)
 {
+	//
+	// This rectangular button is described by its own fields.
+	//
+	this->psDesc = this;
+
 	//
 	// Set initial values for all variables
 	//
@@ -48,8 +116,26 @@ RectangularButton::RectangularButton(unsigned char ucID, Widget *pParent,
 	this->pucPressImage     = 0;
 	this->usAutoRepeatDelay = 0;
 	this->usAutoRepeatRate  = 0;
-	this->ulAutoRepeatTimer = 0;
-	this->bAutoRepeat       = 0;
+	this->pStyle            = 0;
+}
+
+//*****************************************************************************
+//
+//! Gets the style of this rectangular button, including its state.
+//!
+//! This function returns the style of the description of this rectangular
+//! button, with the flags of its state added.  \b #RB_STYLE_PRESSED is only
+//! taken from the state, since the rectangular button sets and clears it itself
+//! as it is pressed and released; \b #RB_STYLE_DISABLED is taken from either,
+//! so that the rectangular button can also be disabled through its description.
+//!
+//! \return Returns the \b RB_STYLE_xxx flags of this rectangular button.
+//
+//*****************************************************************************
+unsigned long
+RectangularButtonView::StyleGet(void)
+{
+	return((this->psDesc->ulStyle & ~RB_STYLE_PRESSED) | this->usState);
 }
 
 //*****************************************************************************
@@ -63,13 +149,68 @@ RectangularButton::RectangularButton(unsigned char ucID, Widget *pParent,
 //
 //*****************************************************************************
 void
-RectangularButton::Draw(void)
+RectangularButtonView::Draw(void)
 {
+    const WidgetStyle *pStyle;
+    const unsigned long *pulFill;
+    WidgetStyle sStyle;
+    unsigned long ulStyle, ulUse;
     const unsigned char *pucImage;
-    tRectangle sPosition;
+    tRectangle sPosition, sRect;
     tContext sCtx;
     long lX, lY;
-    long lColor1, lColor2;
+    unsigned long ulColor1, ulColor2;
+
+    ulStyle = this->StyleGet();
+
+    //
+    // Use the style of this rectangular button, or else translate the colors
+    // of its description that this paint uses: the fill color of the current
+    // state, which is also the background of the image and the text, with its
+    // shades for a falling edge, the outline color, and the text color.
+    //
+    pStyle = this->psDesc->pStyle;
+
+    if(!pStyle)
+    {
+        ulUse = 0;
+
+        if(ulStyle & (RB_STYLE_FILL | RB_STYLE_IMG | RB_STYLE_TEXT))
+        {
+            ulUse |= ((ulStyle & RB_STYLE_PRESSED) ?
+                      WIDGET_STYLE_USE_PRESS_FILL : WIDGET_STYLE_USE_FILL);
+        }
+        if((ulStyle & (RB_STYLE_FILL | RB_STYLE_FALLING_EDGE)) ==
+           (RB_STYLE_FILL | RB_STYLE_FALLING_EDGE))
+        {
+            ulUse |= WIDGET_STYLE_USE_SHADES;
+        }
+        if(ulStyle & RB_STYLE_OUTLINE)
+        {
+            ulUse |= WIDGET_STYLE_USE_OUTLINE;
+        }
+        if((ulStyle & RB_STYLE_IMG) ||
+           ((ulStyle & (RB_STYLE_TEXT | RB_STYLE_DISABLED)) == RB_STYLE_TEXT))
+        {
+            ulUse |= WIDGET_STYLE_USE_TEXT;
+        }
+        if((ulStyle & (RB_STYLE_TEXT | RB_STYLE_DISABLED)) ==
+           (RB_STYLE_TEXT | RB_STYLE_DISABLED))
+        {
+            ulUse |= WIDGET_STYLE_USE_DISABLED;
+        }
+
+        sStyle.Set(Widget::DisplayGet(), this->psDesc->ulFillColor,
+                   this->psDesc->ulPressFillColor, this->psDesc->ulOutlineColor,
+                   this->psDesc->ulTextColor, this->psDesc->pFont, ulUse);
+        pStyle = &sStyle;
+    }
+
+    //
+    // Get the shades of the fill color of the current state.
+    //
+    pulFill = ((ulStyle & RB_STYLE_PRESSED) ? pStyle->pulPressFill :
+               pStyle->pulFill);
 
     //
     // Remap position of this canvas
@@ -79,138 +220,128 @@ RectangularButton::Draw(void)
     //
     // Initialize a drawing context.
     //
-    GrContextInit(&sCtx);
+    this->ContextInit(&sCtx);
 
     //
     // Initialize the clipping region based on the extents of this rectangular
     // rectangular button.
     //
-    GrContextClipRegionSet(&sCtx, &sPosition);
+    sRect = sPosition;
+    this->ClipRegionSet(&sCtx, &sRect);
 
     //
     // See if the rectangular button outline style is selected.
     //
-    if(this->ulStyle & RB_STYLE_OUTLINE)
+    if(ulStyle & RB_STYLE_OUTLINE)
     {
         //
         // Outline the rectangular button with the outline color.
         //
-        GrContextForegroundSet(&sCtx, this->ulOutlineColor);
+        GrContextForegroundSetTranslated(&sCtx, pStyle->ulOutline);
         GrRectDraw(&sCtx, &sPosition);
 
-        sCtx.sClipRegion.sXMin++;
-        sCtx.sClipRegion.sYMin++;
-        sCtx.sClipRegion.sXMax--;
-        sCtx.sClipRegion.sYMax--;
+        sRect.sXMin++;
+        sRect.sYMin++;
+        sRect.sXMax--;
+        sRect.sYMax--;
+        this->ClipRegionSet(&sCtx, &sRect);
     }
 
     //
     // See if the rectangular button fill style is selected.
     //
-    if(this->ulStyle & RB_STYLE_FILL)
+    if(ulStyle & RB_STYLE_FILL)
     {
-    	if(this->ulStyle & RB_STYLE_FALLING_EDGE)
+    	if(ulStyle & RB_STYLE_FALLING_EDGE)
     	{
     		//
     		// Draw left and top edges
     		//
-			if(this->ulStyle & RB_STYLE_PRESSED)
+			if(ulStyle & RB_STYLE_PRESSED)
 			{
-				lColor1 = this->ulPressFillColor;
-				lColor2 = this->ulPressFillColor;
-
-	        	ColorValueAdjust(&lColor1, -50);
-	        	ColorValueAdjust(&lColor2, -15);
+				ulColor1 = pulFill[WIDGET_STYLE_SHADE_DARKER];
+				ulColor2 = pulFill[WIDGET_STYLE_SHADE_DARK];
 			}
 			else
 			{
-				lColor1 = this->ulFillColor;
-				lColor2 = this->ulFillColor;
-
-				ColorValueAdjust(&lColor1, 30);
-//				ColorValueAdjust(&lColor2, 30);
+				ulColor1 = pulFill[WIDGET_STYLE_SHADE_LIGHT];
+				ulColor2 = pulFill[WIDGET_STYLE_SHADE_BASE];
 			}
 
-    		GrContextForegroundSet(&sCtx, lColor1);
-    		GrLineDrawH(&sCtx, sCtx.sClipRegion.sXMin,
-    				           sCtx.sClipRegion.sXMax - 1,
-    				           sCtx.sClipRegion.sYMin);
-    		GrLineDrawV(&sCtx, sCtx.sClipRegion.sXMin,
-    				           sCtx.sClipRegion.sYMin,
-    				           sCtx.sClipRegion.sYMax - 1);
-
-    		GrContextForegroundSet(&sCtx, lColor2);
-    		GrLineDrawH(&sCtx, sCtx.sClipRegion.sXMin + 1,
-    				           sCtx.sClipRegion.sXMax - 2,
-    				           sCtx.sClipRegion.sYMin + 1);
-    		GrLineDrawV(&sCtx, sCtx.sClipRegion.sXMin + 1,
-    				           sCtx.sClipRegion.sYMin + 1,
-    				           sCtx.sClipRegion.sYMax - 2);
+    		GrContextForegroundSetTranslated(&sCtx, ulColor1);
+    		GrLineDrawH(&sCtx, sRect.sXMin,
+    				           sRect.sXMax - 1,
+    				           sRect.sYMin);
+    		GrLineDrawV(&sCtx, sRect.sXMin,
+    				           sRect.sYMin,
+    				           sRect.sYMax - 1);
+
+    		GrContextForegroundSetTranslated(&sCtx, ulColor2);
+    		GrLineDrawH(&sCtx, sRect.sXMin + 1,
+    				           sRect.sXMax - 2,
+    				           sRect.sYMin + 1);
+    		GrLineDrawV(&sCtx, sRect.sXMin + 1,
+    				           sRect.sYMin + 1,
+    				           sRect.sYMax - 2);
 
     		//
     		// Draw right and bottom edges
     		//
-			if(this->ulStyle & RB_STYLE_PRESSED)
+			if(ulStyle & RB_STYLE_PRESSED)
 			{
-				lColor1 = this->ulPressFillColor;
-				lColor2 = this->ulPressFillColor;
-
-				ColorValueAdjust(&lColor1, 30);
-//				ColorValueAdjust(&lColor2, 30);
+				ulColor1 = pulFill[WIDGET_STYLE_SHADE_LIGHT];
+				ulColor2 = pulFill[WIDGET_STYLE_SHADE_BASE];
 			}
 			else
 			{
-				lColor1 = this->ulFillColor;
-				lColor2 = this->ulFillColor;
-
-				ColorValueAdjust(&lColor1, -50);
-				ColorValueAdjust(&lColor2, -15);
+				ulColor1 = pulFill[WIDGET_STYLE_SHADE_DARKER];
+				ulColor2 = pulFill[WIDGET_STYLE_SHADE_DARK];
 			}
 
-        	GrContextForegroundSet(&sCtx, lColor1);
-        	GrLineDrawH(&sCtx, sCtx.sClipRegion.sXMin,
-        			           sCtx.sClipRegion.sXMax,
-        			           sCtx.sClipRegion.sYMax);
-        	GrLineDrawV(&sCtx, sCtx.sClipRegion.sXMax,
-        			           sCtx.sClipRegion.sYMin,
-        			           sCtx.sClipRegion.sYMax);
-
-        	GrContextForegroundSet(&sCtx, lColor2);
-        	GrLineDrawH(&sCtx, sCtx.sClipRegion.sXMin + 1,
-        			           sCtx.sClipRegion.sXMax - 1,
-        			           sCtx.sClipRegion.sYMax - 1);
-        	GrLineDrawV(&sCtx, sCtx.sClipRegion.sXMax - 1,
-        			           sCtx.sClipRegion.sYMin + 1,
-        			           sCtx.sClipRegion.sYMax - 1);
+        	GrContextForegroundSetTranslated(&sCtx, ulColor1);
+        	GrLineDrawH(&sCtx, sRect.sXMin,
+        			           sRect.sXMax,
+        			           sRect.sYMax);
+        	GrLineDrawV(&sCtx, sRect.sXMax,
+        			           sRect.sYMin,
+        			           sRect.sYMax);
+
+        	GrContextForegroundSetTranslated(&sCtx, ulColor2);
+        	GrLineDrawH(&sCtx, sRect.sXMin + 1,
+        			           sRect.sXMax - 1,
+        			           sRect.sYMax - 1);
+        	GrLineDrawV(&sCtx, sRect.sXMax - 1,
+        			           sRect.sYMin + 1,
+        			           sRect.sYMax - 1);
 
         	//
         	// Cut clipping region
         	//
-    		sCtx.sClipRegion.sXMin += 2;
-    		sCtx.sClipRegion.sYMin += 2;
-    		sCtx.sClipRegion.sXMax -= 2;
-    		sCtx.sClipRegion.sYMax -= 2;
+    		sRect.sXMin += 2;
+    		sRect.sYMin += 2;
+    		sRect.sXMax -= 2;
+    		sRect.sYMax -= 2;
+    		this->ClipRegionSet(&sCtx, &sRect);
     	}
 
         //
         // Fill the rectangular button with the fill color.
         //
-        GrContextForegroundSet(&sCtx, ((this->ulStyle & RB_STYLE_PRESSED) ?
-                                       this->ulPressFillColor :
-                                       this->ulFillColor));
+        GrContextForegroundSetTranslated(&sCtx,
+                                         pulFill[WIDGET_STYLE_SHADE_BASE]);
         GrRectFill(&sCtx, &sPosition);
     }
-    else if(this->ulStyle & RB_STYLE_GRADIENT)
+    else if(ulStyle & RB_STYLE_GRADIENT)
     {
-    	if( this->ulStyle & RB_STYLE_PRESSED )
+    	if( ulStyle & RB_STYLE_PRESSED )
     	{
-    		GrContextGradientSet(&sCtx, this->ulPressFillColor,
-				                        this->ulFillColor);
+    		GrContextGradientSet(&sCtx, pStyle->ulPressFillColor,
+				                        pStyle->ulFillColor);
     	}
     	else
     	{
-    		GrContextGradientSet(&sCtx, this->ulFillColor,
-				                        this->ulPressFillColor);
+    		GrContextGradientSet(&sCtx, pStyle->ulFillColor,
+				                        pStyle->ulPressFillColor);
     	}
 
     	GrRectGradientFill(&sCtx, &sPosition);
@@ -219,24 +350,22 @@ RectangularButton::Draw(void)
 	//
 	// See if the rectangular button image style is selected.
 	//
-	if(this->ulStyle & RB_STYLE_IMG)
+	if(ulStyle & RB_STYLE_IMG)
 	{
 		//
 		// Set the foreground and background colors to use for 1 BPP
 		// images.
 		//
-		GrContextForegroundSet(&sCtx, this->ulTextColor);
-		GrContextBackgroundSet(&sCtx,
-							   ((this->ulStyle & RB_STYLE_PRESSED) ?
-								this->ulPressFillColor :
-								this->ulFillColor));
+		GrContextForegroundSetTranslated(&sCtx, pStyle->ulText);
+		GrContextBackgroundSetTranslated(&sCtx,
+							     pulFill[WIDGET_STYLE_SHADE_BASE]);
 
 		//
 		// Get the image to be drawn.
 		//
-		pucImage = (((this->ulStyle & RB_STYLE_PRESSED) &&
-					 this->pucPressImage) ?
-					this->pucPressImage : this->pucImage);
+		pucImage = (((ulStyle & RB_STYLE_PRESSED) &&
+					 this->psDesc->pucPressImage) ?
+					this->psDesc->pucPressImage : this->psDesc->pucImage);
 
 		//
 		// Compute the coordinates for center image.
@@ -247,7 +376,7 @@ RectangularButton::Draw(void)
 		//
 		// Shift image if button is pressed.
 		//
-		if( this->ulStyle & RB_STYLE_PRESSED )
+		if( ulStyle & RB_STYLE_PRESSED )
 		{
 			lX++;
 			lY++;
@@ -262,43 +391,41 @@ RectangularButton::Draw(void)
 	//
 	// See if the rectangular button text style is selected.
 	//
-	if(this->ulStyle & RB_STYLE_TEXT)
+	if(ulStyle & RB_STYLE_TEXT)
 	{
 		//
 		// Set font, foreground and background colors.
 		//
-		GrContextFontSet(&sCtx, this->pFont);
+		GrContextFontSet(&sCtx, pStyle->pFont);
 
-		if(this->ulStyle & RB_STYLE_DISABLED)
+		if(ulStyle & RB_STYLE_DISABLED)
 		{
-			GrContextForegroundSet(&sCtx, ClrGray);
+			GrContextForegroundSetTranslated(&sCtx, pStyle->ulDisabledText);
 		}
 		else
 		{
-			GrContextForegroundSet(&sCtx, this->ulTextColor);
+			GrContextForegroundSetTranslated(&sCtx, pStyle->ulText);
 		}
 
-		GrContextBackgroundSet(&sCtx,
-							   ((this->ulStyle & RB_STYLE_PRESSED) ?
-								this->ulPressFillColor :
-								this->ulFillColor));
+		GrContextBackgroundSetTranslated(&sCtx,
+							     pulFill[WIDGET_STYLE_SHADE_BASE]);
 
 		//
 		// Compute the coordinates for center text.
 		//
-		lX = sPosition.sXMin + (((sPosition.sXMax - sPosition.sXMin + 1 - GrStringWidthGet(&sCtx, this->pcText, -1)) / 2));
-		lY = sPosition.sYMin + (((sPosition.sYMax - sPosition.sYMin + 1 - GrStringHeightGet(&sCtx)) / 2));
+		lX = sPosition.sXMin + (((sPosition.sXMax - sPosition.sXMin + 1 - GrStringWidthGet(&sCtx, this->psDesc->pcText, -1)) / 2));
+		lY = sPosition.sYMin + (((sPosition.sYMax - sPosition.sYMin + 1 - pStyle->lFontHeight) / 2));
 
 		//
 		// Shift text if button is pressed.
 		//
-		if( this->ulStyle & RB_STYLE_PRESSED )
+		if( ulStyle & RB_STYLE_PRESSED )
 		{
 			lX++;
 			lY++;
 		}
 
-		GrStringDraw(&sCtx, this->pcText, -1, lX, lY, this->ulStyle & RB_STYLE_TEXT_OPAQUE);
+		GrStringDraw(&sCtx, this->psDesc->pcText, -1, lX, lY, ulStyle & RB_STYLE_TEXT_OPAQUE);
 	}
 }
 
@@ -319,21 +446,23 @@ RectangularButton::Draw(void)
 //
 //*****************************************************************************
 long
-RectangularButton::Click(unsigned long ulMsg, long lX, long lY)
+RectangularButtonView::Click(unsigned long ulMsg, long lX, long lY)
 {
 	tRectangle sPosition;
 	long       lRet = 0;
 
 	this->AbsolutePositionGet(&sPosition);
 
-    if(!(this->ulStyle & RB_STYLE_DISABLED))
+    if(!(this->StyleGet() & RB_STYLE_DISABLED))
     {
         switch(ulMsg)
         {
         case WIDGET_MSG_PTR_UP:
-        	if(this->ulStyle & RB_STYLE_PRESSED)
+        	if(this->StyleGet() & RB_STYLE_PRESSED)
         	{
-    			this->ulStyle &= ~(RB_STYLE_PRESSED);
+    			this->usState &= ~(RB_STYLE_PRESSED);
+
+    			Widget::AutoRepeatStop();
 
             	if(GrRectContainsPoint(&sPosition, lX, lY))
     			{
@@ -348,10 +477,17 @@ RectangularButton::Click(unsigned long ulMsg, long lX, long lY)
         case WIDGET_MSG_PTR_DOWN:
         	if(GrRectContainsPoint(&sPosition, lX, lY))
         	{
-                this->ulStyle |= RB_STYLE_PRESSED;
+                this->usState |= RB_STYLE_PRESSED;
 
-    			this->ulAutoRepeatTimer = GrTimerGet();
-    			this->bAutoRepeat = 0;
+    			//
+    			// Start generating the auto-repeat events, if needed.
+    			//
+    			if(this->StyleGet() & RB_STYLE_AUTO_REPEAT)
+    			{
+    				this->AutoRepeatStart(this->psDesc->usAutoRepeatDelay,
+    				                      this->psDesc->usAutoRepeatRate ?
+    				                      this->psDesc->usAutoRepeatRate : 1);
+    			}
 
     			Widget::ParentNotify(this, WIDGET_NOTIFY_BTN_PRESSED);
 
@@ -361,32 +497,8 @@ RectangularButton::Click(unsigned long ulMsg, long lX, long lY)
         	break;
 
         case WIDGET_MSG_PTR_MOVE:
-        	if(this->ulStyle & RB_STYLE_PRESSED)
+        	if(this->StyleGet() & RB_STYLE_PRESSED)
         	{
-        		if(this->ulStyle & RB_STYLE_AUTO_REPEAT)
-        		{
-    				if(!bAutoRepeat)
-    				{
-    					if((GrTimerGet() - this->ulAutoRepeatTimer) >= this->usAutoRepeatDelay)
-    					{
-    						bAutoRepeat = 1;
-
-    						this->ulAutoRepeatTimer = GrTimerGet();
-
-    						Widget::ParentNotify(this, WIDGET_NOTIFY_BTN_PRESSED);
-    					}
-    				}
-    				else
-    				{
-    					if((GrTimerGet() - this->ulAutoRepeatTimer) >= this->usAutoRepeatRate)
-    					{
-    						this->ulAutoRepeatTimer = GrTimerGet();
-
-    						Widget::ParentNotify(this, WIDGET_NOTIFY_BTN_PRESSED);
-    					}
-    				}
-        		}
-
         		lRet = 1;
         	}
 
@@ -413,7 +525,7 @@ RectangularButton::Click(unsigned long ulMsg, long lX, long lY)
 //
 //*****************************************************************************
 long
-RectangularButton::MessageProc(unsigned long ulMsg, unsigned long ulParam1,
+RectangularButtonView::MessageProc(unsigned long ulMsg, unsigned long ulParam1,
 		                       unsigned long ulParam2)
 {
     //
@@ -443,6 +555,26 @@ RectangularButton::MessageProc(unsigned long ulMsg, unsigned long ulParam1,
             return(1);
         }
 
+        //
+        // A timer of this widget has expired.
+        //
+        case WIDGET_MSG_TIMER:
+        {
+            //
+            // Generate an auto-repeat event if the button is still pressed.
+            //
+            if(this->AutoRepeatIs(ulParam1) &&
+               ((this->StyleGet() & (RB_STYLE_PRESSED | RB_STYLE_DISABLED)) ==
+                RB_STYLE_PRESSED))
+            {
+            	Widget::ParentNotify(this, WIDGET_NOTIFY_BTN_PRESSED);
+
+            	return(1);
+            }
+
+            return(0);
+        }
+
         //
         // One of the pointer requests has been sent.
         //
@@ -466,6 +598,21 @@ RectangularButton::MessageProc(unsigned long ulMsg, unsigned long ulParam1,
     }
 }
 
+//*****************************************************************************
+//
+//! Destroys a rectangular button widget.
+//!
+//! This function destroys a rectangular button widget described by a
+//! tRectangularButtonDesc structure.
+//!
+//! \return None.
+//
+//*****************************************************************************
+RectangularButtonView::~RectangularButtonView(void)
+{
+
+}
+
 //*****************************************************************************
 //
 //! Destroys a rectangular button widget.
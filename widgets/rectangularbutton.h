@@ -27,38 +27,13 @@ extern "C"
 
 //*****************************************************************************
 //
-//! The class that describes a rectangular button widget.
+//! This structure describes the contents of a rectangular button widget.  It can
+//! be declared \b const, so that a rectangular button described by it (see
+//! RectangularButtonView) keeps it in flash.
 //
 //*****************************************************************************
-class RectangularButton : public Widget
+typedef struct
 {
-public:
-	//
-	//! Constructs a RectangularButton widget
-	//
-	RectangularButton(unsigned char ucID, Widget *pParent, long lX, long lY, long lWidth, long lHeight);
-
-	//
-	//! Draws the contents of a rectangular button.
-	//
-	void Draw(void);
-
-	//
-	//! Handles pointer events for a rectangular button.
-	//
-	long Click(unsigned long ulMsg, long lX, long lY);
-
-	//
-	//! Handles messages for a rectangular button widget.
-	//
-	long MessageProc(unsigned long ulMsg, unsigned long ulParam1,
-			         unsigned long ulParam2);
-
-	//
-	//! Destroys a RectangularButton widget
-	//
-	~RectangularButton(void);
-
     //
     //! The style for this widget.  This is a set of flags defined by
     //! RB_STYLE_xxx.
@@ -101,7 +76,7 @@ public:
     //! A pointer to the text to draw on this rectangular button, if RB_STYLE_TEXT is
     //! selected.
     //
-    char *pcText;
+    const char *pcText;
 
     //
     //! A pointer to the image to be drawn onto this rectangular button, if
@@ -116,33 +91,121 @@ public:
     const unsigned char *pucPressImage;
 
     //
-    //! The number of pointer events to delay before starting to auto-repeat,
-    //! if RB_STYLE_AUTO_REPEAT is selected.  The amount of time to which this
-    //! corresponds is dependent upon the rate at which pointer events are
-    //! generated by the pointer driver.
+    //! The time, in milliseconds, to delay before starting to auto-repeat, if
+    //! RB_STYLE_AUTO_REPEAT is selected.
     //
     unsigned short usAutoRepeatDelay;
 
     //
-    //! The number of pointer events between button presses generated by the
-    //! auto-repeat function, if RB_STYLE_AUTO_REPEAT is selected.  The amount
-    //! of time to which this corresponds is dependent up on the rate at which
-    //! pointer events are generated by the pointer driver.
+    //! The time, in milliseconds, between button presses generated by the
+    //! auto-repeat function, if RB_STYLE_AUTO_REPEAT is selected.
     //
     unsigned short usAutoRepeatRate;
 
     //
-    //! The number of pointer events that have occurred.  This is used when
-    //! RB_STYLE_AUTO_REPEAT is selected to generate the auto-repeat events.
+    //! A pointer to the style this rectangular button is drawn with, or zero to draw it
+    //! with the colors and font above.  The style can be shared by any number
+    //! of widgets.
     //
-    unsigned long ulAutoRepeatTimer;
+    const WidgetStyle *pStyle;
+}
+tRectangularButtonDesc;
 
-    //
-    //! Indicate that button is in autorepeat state.
-    //
-    unsigned char bAutoRepeat;
+//*****************************************************************************
+//
+//! The class that describes a rectangular button widget whose contents are
+//! described by a tRectangularButtonDesc structure, which is not copied.
+//
+//*****************************************************************************
+class RectangularButtonView : public Widget
+{
+public:
+	//
+	//! Constructs a RectangularButton widget from its description
+	//
+	RectangularButtonView(unsigned char ucID, Widget *pParent, long lX, long lY,
+	                      long lWidth, long lHeight,
+	                      const tRectangularButtonDesc *psDesc);
+
+	//
+	//! Creates a rectangular button widget of a widget tree description
+	//
+	static Widget *Create(unsigned char ucID, Widget *pParent, long lX,
+	                      long lY, long lWidth, long lHeight,
+	                      const void *pvDesc);
+
+	//
+	//! Gets the style of this rectangular button, including its state.
+	//
+	unsigned long StyleGet(void);
+
+	//
+	//! Draws the contents of a rectangular button.
+	//
+	void Draw(void);
+
+	//
+	//! Handles pointer events for a rectangular button.
+	//
+	long Click(unsigned long ulMsg, long lX, long lY);
+
+	//
+	//! Handles messages for a rectangular button widget.
+	//
+	long MessageProc(unsigned long ulMsg, unsigned long ulParam1,
+			         unsigned long ulParam2);
+
+	//
+	//! Destroys a RectangularButton widget
+	//
+	~RectangularButtonView(void);
+
+	//
+	//! The flags of the style that change at run time, which are added to the
+	//! style of the description (see StyleGet()): RB_STYLE_PRESSED, which
+	//! is never taken from the description, and RB_STYLE_DISABLED if the
+	//! application disables this rectangular button.
+	//
+	unsigned short usState;
+
+	//
+	//! A pointer to the description of this rectangular button.
+	//
+	const tRectangularButtonDesc *psDesc;
+};
+
+//*****************************************************************************
+//
+//! The class that describes a rectangular button widget whose contents are set at
+//! run time, through the fields of tRectangularButtonDesc.
+//
+//*****************************************************************************
+class RectangularButton : public RectangularButtonView, public tRectangularButtonDesc
+{
+public:
+	//
+	//! Constructs a RectangularButton widget
+	//
+	RectangularButton(unsigned char ucID, Widget *pParent, long lX, long lY,
+	                  long lWidth, long lHeight);
+
+	//
+	//! Destroys a RectangularButton widget
+	//
+	~RectangularButton(void);
 };
 
+//*****************************************************************************
+//
+//! Declares a rectangular button widget of a widget tree description (see
+//! Widget::TreeCreate()), whose contents are described by the
+//! tRectangularButtonDesc structure pointed to by \e psDesc.
+//
+//*****************************************************************************
+#define RECTANGULAR_BUTTON_DESC(ucDepth, ucID, lX, lY, lWidth, lHeight, psDesc) \
+        WIDGET_DESC(RectangularButtonView::Create, ucDepth, ucID, lX, lY, \
+                    lWidth, lHeight, psDesc)
+
 //*****************************************************************************
 //
 //! This flag indicates that the rectangular button should be outlined.
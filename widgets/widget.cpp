@@ -4,8 +4,10 @@
 //
 //*****************************************************************************
 
+#include "debug.h"
 #include "mqueue.h"
 #include "widget.h"
+#include "hitindex.h"
 
 //*****************************************************************************
 //
@@ -52,10 +54,256 @@ typedef struct
 
 //*****************************************************************************
 //
-//! The pointer to the message queue object.
+// The number of messages the widget message queue can hold.  This must be a
+// power of two.
 //
 //*****************************************************************************
-MQueue *Widget::pMQueue;
+#ifndef WIDGET_MSG_QUEUE_SIZE
+#define WIDGET_MSG_QUEUE_SIZE   16
+#endif
+
+//*****************************************************************************
+//
+// The lanes of the widget message queue, from the highest priority to the
+// lowest.  Pointer messages go to the input lane, repaint messages to the
+// repaint lane, and all other messages (such as notifications) to the
+// notification lane.
+//
+//*****************************************************************************
+#define MSG_LANE_INPUT          0
+#define MSG_LANE_NOTIFY         1
+#define MSG_LANE_REPAINT        2
+#define MSG_LANES               3
+
+//*****************************************************************************
+//
+// The number of messages of higher priority lanes that may be processed while
+// a lane has messages waiting, before one message of that lane is processed
+// anyway.
+//
+//*****************************************************************************
+#ifndef WIDGET_MSG_LANE_STARVATION
+#define WIDGET_MSG_LANE_STARVATION 8
+#endif
+
+//*****************************************************************************
+//
+// The lanes of the widget message queue.  Messages may be posted from
+// interrupt handlers and from several threads, and are processed by
+// Widget::MessageQueueProcess().
+//
+//*****************************************************************************
+static MQueue<tMessageQueueItem, WIDGET_MSG_QUEUE_SIZE>
+    g_psMessageQueues[MSG_LANES];
+
+//*****************************************************************************
+//
+// The number of coalescing rules that can be set with
+// Widget::MessageCoalesceSet().
+//
+//*****************************************************************************
+#ifndef WIDGET_COALESCE_RULES
+#define WIDGET_COALESCE_RULES   8
+#endif
+
+//*****************************************************************************
+//
+// This structure describes how a message posted to a widget is coalesced.
+//
+//*****************************************************************************
+typedef struct
+{
+    //
+    // The message this rule applies to, or zero for an unused rule.
+    //
+    unsigned long ulMessage;
+
+    //
+    // The widget this rule applies to, or zero for any widget.
+    //
+    Widget *pWidget;
+
+    //
+    // How the message is coalesced; this is one of the MSG_COALESCE_xxx
+    // values.
+    //
+    unsigned long ulPolicy;
+
+} tCoalesceRule;
+
+//*****************************************************************************
+//
+// The coalescing rules.  Pointer moves are coalesced by default, since the
+// queue can very quickly overflow if the application is busy doing something
+// while the user keeps pressing the display.  Repaint requests are merged into
+// the bounding box of their areas.
+//
+//*****************************************************************************
+static tCoalesceRule g_psCoalesceRules[WIDGET_COALESCE_RULES] =
+{
+    { WIDGET_MSG_PTR_MOVE, 0, MSG_COALESCE_LATEST },
+    { WIDGET_MSG_UPDATE, 0, MSG_COALESCE_RECT }
+};
+
+//*****************************************************************************
+//
+// The counters of the widget message queue activity.
+//
+//*****************************************************************************
+static tMessageQueueStats g_sMessageQueueStats;
+
+//*****************************************************************************
+//
+// The number of times each lane of the widget message queue has been passed
+// over while it may have had messages waiting.
+//
+//*****************************************************************************
+static unsigned long g_pulLaneSkipped[MSG_LANES];
+
+//*****************************************************************************
+//
+// The clock used to measure the time budget of Widget::MessageQueueProcess().
+//
+//*****************************************************************************
+static unsigned long (*g_pfnClock)(void) = GrTimerGet;
+
+//*****************************************************************************
+//
+// The budget of the current call to Widget::MessageQueueProcess(): the time
+// it started, the time and the number of pixels it may use (zero for no
+// limit), and the number of pixels repainted so far.
+//
+//*****************************************************************************
+static unsigned long g_ulBudgetStart;
+static unsigned long g_ulTimeBudget;
+static unsigned long g_ulPixelBudget;
+static unsigned long g_ulPixelsRepainted;
+
+//*****************************************************************************
+//
+// The shortest time between two frames run by Widget::FrameProcess(), in
+// milliseconds.
+//
+//*****************************************************************************
+#ifndef WIDGET_FRAME_PERIOD
+#define WIDGET_FRAME_PERIOD     16
+#endif
+
+//*****************************************************************************
+//
+// The frame scheduler: the shortest time between two frames, the time of the
+// last frame (if g_bFrameRun is non-zero), and the function called when there
+// is nothing to do.
+//
+//*****************************************************************************
+static unsigned long g_ulFramePeriod = WIDGET_FRAME_PERIOD;
+static unsigned long g_ulFrameTime;
+static char g_bFrameRun;
+static void (*g_pfnIdleHook)(unsigned long ulIdleTime);
+
+//*****************************************************************************
+//
+// Determines if the budget of the current call to Widget::MessageQueueProcess()
+// is used up.
+//
+//*****************************************************************************
+static long
+BudgetSpent(void)
+{
+	if(g_ulPixelBudget && (g_ulPixelsRepainted >= g_ulPixelBudget))
+	{
+		return(1);
+	}
+
+	if(g_ulTimeBudget && ((g_pfnClock() - g_ulBudgetStart) >= g_ulTimeBudget))
+	{
+		return(1);
+	}
+
+	return(0);
+}
+
+//*****************************************************************************
+//
+//! The display the widgets are drawn onto.
+//
+//*****************************************************************************
+const tDisplay *Widget::pDisplay = &g_sDisplay;
+
+//*****************************************************************************
+//
+//! The pointer to the index used to find the widgets under the pointer.
+//
+//*****************************************************************************
+HitIndex *Widget::pHitIndex;
+
+#ifdef WIDGET_NO_HEAP
+//*****************************************************************************
+//
+// The index used to find the widgets under the pointer, when the heap is not
+// used.
+//
+//*****************************************************************************
+static HitIndex g_sHitIndex;
+#endif
+
+//*****************************************************************************
+//
+//! The widget that has captured the pointer, or zero if none has.
+//
+//*****************************************************************************
+Widget *Widget::pPointerWidget = 0;
+
+//*****************************************************************************
+//
+//! The timer that generates the auto-repeat events of the widget that has
+//! captured the pointer.
+//
+//*****************************************************************************
+WidgetTimer Widget::cAutoRepeatTimer;
+
+//*****************************************************************************
+//
+//! The absolute areas of the display that need a repaint.
+//
+//*****************************************************************************
+tDirtyRectSet Widget::sInvalidRects;
+
+//*****************************************************************************
+//
+//! The area being repainted, or zero outside of a repaint pass.
+//
+//*****************************************************************************
+const tRectangle *Widget::psRepaintRegion = 0;
+
+//*****************************************************************************
+//
+//! The areas of the repaint pass in progress.
+//
+//*****************************************************************************
+tDirtyRectSet Widget::sRepaintRects;
+
+//*****************************************************************************
+//
+//! The index in Widget::sRepaintRects of the area being repainted.
+//
+//*****************************************************************************
+unsigned long Widget::ulRepaintRect;
+
+//*****************************************************************************
+//
+//! The root of the widget tree of the repaint pass in progress.
+//
+//*****************************************************************************
+Widget *Widget::pRepaintRoot = 0;
+
+//*****************************************************************************
+//
+//! The next widget to visit in the repaint pass in progress, or zero if no
+//! repaint pass is in progress.
+//
+//*****************************************************************************
+Tree *Widget::pRepaintNext = 0;
 
 //*****************************************************************************
 //
@@ -110,6 +358,14 @@ Widget::Widget(unsigned char ucID, Widget *pParent, long lX, long lY, long lWidt
 {
 	this->ucID     = ucID;
 
+	this->bAbsPositionValid = 0;
+
+	//
+	// A widget handles every message until its class tells otherwise.
+	//
+	this->ulMsgMask     = WIDGET_MSG_MASK_ALL;
+	this->ulTreeMsgMask = WIDGET_MSG_MASK_ALL;
+
     this->sPosition.sXMin = lX;
     this->sPosition.sYMin = lY;
     this->sPosition.sXMax = lX + lWidth - 1;
@@ -120,19 +376,188 @@ Widget::Widget(unsigned char ucID, Widget *pParent, long lX, long lY, long lWidt
     	pParent->AppendChild(this);
     }
 
-    if(!Widget::pMQueue)
+    if(!Widget::pHitIndex)
     {
-    	Widget::pMQueue = new MQueue(sizeof(tMessageQueueItem), 16);
+#ifdef WIDGET_NO_HEAP
+    	Widget::pHitIndex = &g_sHitIndex;
+#else
+    	Widget::pHitIndex = new HitIndex();
+#endif
     }
 }
 
+//*****************************************************************************
+//
+//! Allocates the memory of a widget.
+//!
+//! \param ulSize is the size of the widget, in bytes.
+//!
+//! This function allocates every widget created with \b new from the arena
+//! selected with WidgetArena::Select(), if any, or from the heap otherwise.
+//! If the library is built with \b WIDGET_NO_HEAP defined, the heap is never
+//! used, and the widgets are allocated from a pool of \b WIDGET_HEAP_SIZE
+//! bytes cut into blocks of \b WIDGET_HEAP_BLOCK_SIZE bytes unless another
+//! arena is selected.  A screen that is created and destroyed as a whole is
+//! best given its own arena, so that the pool only holds the widgets that
+//! live on, like the root of the tree.
+//!
+//! \return Returns a pointer to the memory of the widget, or zero if the
+//! arena is full, in which case the widget is not created.
+//
+//*****************************************************************************
+void *
+Widget::operator new(size_t ulSize) throw()
+{
+	WidgetArena *pArena;
+	void *pvWidget;
+
+	pArena = WidgetArena::SelectedGet();
+
+	if(pArena)
+	{
+		pvWidget = pArena->Alloc(ulSize);
+
+		//
+		// Without a heap to fall back on, a full arena is a sizing error of
+		// the application.
+		//
+#ifdef WIDGET_NO_HEAP
+		ASSERT(pvWidget);
+#endif
+
+		return(pvWidget);
+	}
+
+#ifdef WIDGET_NO_HEAP
+	return(0);
+#else
+	return(::operator new(ulSize));
+#endif
+}
+
+//*****************************************************************************
+//
+//! Frees the memory of a widget.
+//!
+//! \param pvWidget is a pointer to the memory of the widget.
+//!
+//! This function gives the memory of a destroyed widget back to the arena it
+//! was allocated from, or to the heap.  An arena is emptied at once when its
+//! last widget is destroyed, so destroying a screen allocated from its own
+//! arena with Widget::Destroy() releases all of its memory in one operation.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+Widget::operator delete(void *pvWidget)
+{
+	WidgetArena *pArena;
+
+	pArena = WidgetArena::Find(pvWidget);
+
+	if(pArena)
+	{
+		pArena->Free(pvWidget);
+		return;
+	}
+
+#ifndef WIDGET_NO_HEAP
+	::operator delete(pvWidget);
+#endif
+}
+
+//*****************************************************************************
+//
+//! Creates a widget tree from its constant description.
+//!
+//! \param psDesc is a pointer to the array that describes the widgets of the
+//! tree, in pre-order.
+//! \param ulCount is the number of entries of the array.
+//! \param pParent is a pointer to the widget the tree is created into.
+//!
+//! This function creates the widgets described by \e psDesc, each one as a
+//! child of the closest previous widget with a lower depth, or of \e pParent
+//! for the widgets of depth zero.  The description, and the contents it
+//! points to, are only referenced by the widgets, so that they can be
+//! declared \b const and stay in flash: the widgets only hold their position
+//! in the tree and their state in RAM.  A screen described this way is built
+//! with a single call, without any code to set up its widgets one by one.
+//!
+//! If \e pParent is zero, the description must hold a single widget of depth
+//! zero, which becomes the root of the new tree.
+//!
+//! \return Returns a pointer to the first widget created, or zero if a widget
+//! could not be created (such as when its arena is full) or the description
+//! is malformed, in which case none of the widgets is left.
+//
+//*****************************************************************************
+Widget *
+Widget::TreeCreate(const tWidgetDesc *psDesc, unsigned long ulCount,
+                   Widget *pParent)
+{
+	Widget *ppParents[WIDGET_DESC_DEPTH + 1];
+	Widget *pFirst, *pWidget;
+	unsigned long ulIdx, ulDepth;
+
+	pFirst = 0;
+	ppParents[0] = pParent;
+	ulDepth = 0;
+
+	for(ulIdx = 0; ulIdx < ulCount; ulIdx++, psDesc++)
+	{
+		//
+		// Create this widget into the last widget of the depth above, unless
+		// its depth skips a level.
+		//
+		pWidget = 0;
+
+		if((psDesc->ucDepth <= ulDepth) &&
+		   (psDesc->ucDepth < WIDGET_DESC_DEPTH))
+		{
+			pWidget = psDesc->pfnCreate(psDesc->ucID,
+			                            ppParents[psDesc->ucDepth],
+			                            psDesc->sX, psDesc->sY,
+			                            psDesc->sWidth, psDesc->sHeight,
+			                            psDesc->pvDesc);
+		}
+
+		//
+		// Destroy the widgets created so far if this one cannot be created.
+		// The widgets of depth zero follow each other among the children of
+		// the parent, since children are always appended.
+		//
+		if(!pWidget)
+		{
+			while(pFirst)
+			{
+				pWidget = (Widget *)pFirst->NextGet();
+				pFirst->Destroy();
+				pFirst = pWidget;
+			}
+
+			return(0);
+		}
+
+		if(!pFirst)
+		{
+			pFirst = pWidget;
+		}
+
+		ppParents[psDesc->ucDepth + 1] = pWidget;
+		ulDepth = psDesc->ucDepth + 1;
+	}
+
+	return(pFirst);
+}
+
 //*****************************************************************************
 //
 //! Requests a redraw of the widget tree.
 //!
 //! This function sends a \b #WIDGET_MSG_UPDATE message to the given widgets,
 //! and all of the widget beneath it, so that they will draw or redraw
-//! themselves on the display.
+//! themselves on the display, and marks the area of the widget as dirty.
 //!
 //! \return None.
 //
@@ -145,10 +570,10 @@ Widget::Update(void)
 	//
 	Widget::MessageSend(this, WIDGET_MSG_UPDATE, 0, 0, 0);
 
-//	//
-//	// Flush this widget to the display
-//	//
-//	this->Flush();
+	//
+	// Flush this widget to the display
+	//
+	this->Flush();
 }
 
 //*****************************************************************************
@@ -170,13 +595,21 @@ Widget::Move(long lX, long lY)
 	this->sPosition.sYMin += lY;
 	this->sPosition.sXMax += lX;
 	this->sPosition.sYMax += lY;
+
+	//
+	// This widget and all his children are now somewhere else.
+	//
+	this->AbsolutePositionInvalidate();
+	Widget::pHitIndex->Invalidate();
 }
 
 //*****************************************************************************
 //
 //! Flushes a widget to the display.
 //!
-//! This function flushes a widget rectangle to the display.
+//! This function marks a widget rectangle as dirty.  The dirty areas of all
+//! widgets are merged and flushed to the display once, at the end of
+//! Widget::MessageQueueProcess(), rather than once per widget.
 //!
 //! \return None.
 //
@@ -192,77 +625,553 @@ Widget::Flush(void)
 	this->AbsolutePositionGet(&sPosition);
 
 	//
-	// Flush rectangle area of the widget to display.
+	// Mark rectangle area of the widget as dirty.
 	//
-	DisplayFlush(&sPosition);
+	GrDirtyRectAdd(&sPosition);
 }
 
 //*****************************************************************************
 //
-//! Gets an absolute coordinates of this widget.
+//! Marks an area of this widget as needing a repaint.
 //!
-//! This function Gets an absolute coordinates of this widget.
+//! \param psRect is a pointer to the area to repaint, in coordinates relative
+//! to the upper left corner of this widget, or zero for the whole widget.
 //!
-//! \param psPosition is a pointer to the rectangle that contains an absolute
-//! coordinates of this widget.
+//! This function adds an area of this widget to the invalid areas.  At the
+//! end of Widget::MessageQueueProcess() only the widgets that intersect an
+//! invalid area are sent a \b #WIDGET_MSG_UPDATE message, with their
+//! clipping region narrowed to it (see Widget::ClipRegionSet()), and only
+//! the invalid areas are flushed.  The areas invalidated in the same frame
+//! are kept apart, up to \b GRLIB_DIRTY_RECTS of them, and merged only when
+//! that does not grow them much (see GrDirtyRectSetAdd()), so that damage at
+//! opposite corners of the display does not repaint all of it.
 //!
 //! \return None.
 //
 //*****************************************************************************
 void
-Widget::AbsolutePositionGet(tRectangle *psPosition)
+Widget::Invalidate(const tRectangle *psRect)
 {
-	Widget *pWidget;
-	Tree   *pTemp;
+	tRectangle sPosition, sRect;
 
 	//
-	// Set relative position of this widget first
+	// Get the absolute position of this widget.
 	//
-	psPosition->sXMin = this->sPosition.sXMin;
-	psPosition->sYMin = this->sPosition.sYMin;
-	psPosition->sXMax = this->sPosition.sXMax;
-	psPosition->sYMax = this->sPosition.sYMax;
+	this->AbsolutePositionGet(&sPosition);
 
-	//
-	// Loop through all parents of this widget
-	//
-	for(pTemp = this->ParentGet(); pTemp;
-	    pTemp = pTemp->ParentGet())
+	if(psRect)
 	{
-		pWidget = (Widget *)pTemp;
-
 		//
-		// Accumulate all parents coordinates for get
-		// an absolute position of this widget.
+		// Move the area to absolute coordinates and keep the part of it that
+		// lies inside this widget.
 		//
-		psPosition->sXMin += pWidget->sPosition.sXMin;
-		psPosition->sYMin += pWidget->sPosition.sYMin;
-		psPosition->sXMax += pWidget->sPosition.sXMin;
-		psPosition->sYMax += pWidget->sPosition.sYMin;
+		sRect.sXMin = sPosition.sXMin + psRect->sXMin;
+		sRect.sYMin = sPosition.sYMin + psRect->sYMin;
+		sRect.sXMax = sPosition.sXMin + psRect->sXMax;
+		sRect.sYMax = sPosition.sYMin + psRect->sYMax;
+
+		if(sRect.sXMin < sPosition.sXMin)
+		{
+			sRect.sXMin = sPosition.sXMin;
+		}
+		if(sRect.sYMin < sPosition.sYMin)
+		{
+			sRect.sYMin = sPosition.sYMin;
+		}
+		if(sRect.sXMax > sPosition.sXMax)
+		{
+			sRect.sXMax = sPosition.sXMax;
+		}
+		if(sRect.sYMax > sPosition.sYMax)
+		{
+			sRect.sYMax = sPosition.sYMax;
+		}
+
+		if((sRect.sXMin > sRect.sXMax) || (sRect.sYMin > sRect.sYMax))
+		{
+			return;
+		}
+	}
+	else
+	{
+		sRect = sPosition;
 	}
+
+	//
+	// Add the area to the invalid areas.
+	//
+	GrDirtyRectSetAdd(&Widget::sInvalidRects, &sRect);
 }
 
 //*****************************************************************************
 //
-//! Destroys this widget and all his children.
+//! Sets the clipping region of a context used to draw a widget.
 //!
-//! This function destroys this widget and all his children.
+//! \param pContext is a pointer to the drawing context to modify.
+//! \param psRect is a pointer to the absolute area the widget draws into.
+//!
+//! This function sets the clipping region of \e pContext to \e psRect.  While
+//! a repaint pass is running, the clipping region is further narrowed to the
+//! area being repainted, so that a widget only redraws its damaged pixels.
+//! Widgets must use this function, rather than GrContextClipRegionSet(), in
+//! their Draw() methods, and lay out their contents from their own position
+//! rather than from the clipping region of the context.
 //!
 //! \return None.
 //
 //*****************************************************************************
 void
-Widget::Destroy(void)
+Widget::ClipRegionSet(tContext *pContext, const tRectangle *psRect)
 {
-    Tree *pTemp;
-    Tree *pPrev;
-    Tree *pParent;
+	tRectangle *psClip;
+
+	//
+	// Set the clipping region to the given area of the screen.
+	//
+	GrContextClipRegionSet(pContext, (tRectangle *)psRect);
+
+	//
+	// Nothing more to do outside of a repaint pass.
+	//
+	if(!Widget::psRepaintRegion)
+	{
+		return;
+	}
+
+	//
+	// Narrow the clipping region to the area being repainted.
+	//
+	psClip = &pContext->sClipRegion;
+
+	if(psClip->sXMin < Widget::psRepaintRegion->sXMin)
+	{
+		psClip->sXMin = Widget::psRepaintRegion->sXMin;
+	}
+	if(psClip->sYMin < Widget::psRepaintRegion->sYMin)
+	{
+		psClip->sYMin = Widget::psRepaintRegion->sYMin;
+	}
+	if(psClip->sXMax > Widget::psRepaintRegion->sXMax)
+	{
+		psClip->sXMax = Widget::psRepaintRegion->sXMax;
+	}
+	if(psClip->sYMax > Widget::psRepaintRegion->sYMax)
+	{
+		psClip->sYMax = Widget::psRepaintRegion->sYMax;
+	}
+
+	//
+	// If nothing is left, clip everything away.  The clipping region is made
+	// empty on both axes, with its minimum at the largest coordinate and its
+	// maximum at the smallest one, so that no shape can overlap it and every
+	// primitive draws nothing.
+	//
+	if((psClip->sXMin > psClip->sXMax) || (psClip->sYMin > psClip->sYMax))
+	{
+		psClip->sXMin = 0x7fff;
+		psClip->sYMin = 0x7fff;
+		psClip->sXMax = -0x8000;
+		psClip->sYMax = -0x8000;
+	}
+}
+
+//*****************************************************************************
+//
+//! Sets the display the widgets are drawn onto.
+//!
+//! \param pDisplay is a pointer to the display, such as an off-screen buffer
+//! initialized with GrOffScreen16BPPInit().
+//!
+//! This function selects the display that the widgets draw onto, that the hit
+//! index covers, and that the dirty areas are flushed to.  It is
+//! \b g_sDisplay until this function is called.  The widget styles hold
+//! colors translated for one display, so they must be set again with
+//! WidgetStyle::Set() for the new display, and the widgets repainted.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+Widget::DisplaySet(const tDisplay *pDisplay)
+{
+	ASSERT(pDisplay);
+
+	Widget::pDisplay = pDisplay;
+
+	//
+	// The grid of the hit index is sized for the display.
+	//
+	if(Widget::pHitIndex)
+	{
+		Widget::pHitIndex->Invalidate();
+	}
+}
+
+//*****************************************************************************
+//
+//! Initializes a context used to draw a widget.
+//!
+//! \param pContext is a pointer to the drawing context to initialize.
+//!
+//! This function initializes \e pContext, as GrContextInit() does, to draw
+//! onto the display selected with Widget::DisplaySet().  Widgets must use this
+//! function in their Draw() methods, and then set the clipping region with
+//! Widget::ClipRegionSet().
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+Widget::ContextInit(tContext *pContext)
+{
+	GrContextInit(pContext);
+	GrContextDisplaySet(pContext, Widget::pDisplay);
+}
+
+//*****************************************************************************
+//
+//! Repaints the widgets that intersect the invalid areas.
+//!
+//! This function repaints each invalid area in turn.  For each one it walks
+//! the widget tree in pre-order, so that parents are drawn before their
+//! children, and sends a \b #WIDGET_MSG_UPDATE message to every widget that
+//! intersects the area.  The children of a widget that does not intersect it
+//! are skipped, since they are expected to lie within their parent, and so
+//! are the subtrees where no widget handles \b #WIDGET_MSG_UPDATE.  Each
+//! repainted area is then marked as dirty so that it is flushed to the
+//! display.
+//!
+//! If the budget of Widget::MessageQueueProcess() is used up, the walk stops
+//! after the current widget and resumes from the next one on the next call.
+//! An area is only marked as dirty once its walk is complete, so that a half
+//! repainted area is not flushed.
+//!
+//! \return Returns 1 if the repaint pass has been paused, and 0 if it is
+//! complete.
+//
+//*****************************************************************************
+long
+Widget::Repaint(void)
+{
+	tRectangle sPosition;
+	const tRectangle *psArea;
+	Tree *pTree;
+
+	//
+	// See if a new repaint pass has to be started.
+	//
+	if(!Widget::pRepaintNext)
+	{
+		//
+		// Nothing to do if nothing is invalid.
+		//
+		if(!Widget::sInvalidRects.ulCount || !g_pcRootWidget)
+		{
+			return(0);
+		}
+
+		//
+		// Take a copy of the invalid areas, so that widgets may invalidate
+		// again while being repainted (this will be handled in the next
+		// pass).
+		//
+		Widget::sRepaintRects = Widget::sInvalidRects;
+		Widget::sInvalidRects.ulCount = 0;
+		Widget::ulRepaintRect = 0;
+		Widget::pRepaintRoot = g_pcRootWidget;
+		Widget::pRepaintNext = g_pcRootWidget;
+	}
+
+	psArea = &Widget::sRepaintRects.psRects[Widget::ulRepaintRect];
+	Widget::psRepaintRegion = psArea;
+
+	pTree = Widget::pRepaintNext;
+
+	do
+	{
+		//
+		// See if this widget intersects the area being repainted, and
+		// something under it is painted.
+		//
+		((Widget *)pTree)->AbsolutePositionGet(&sPosition);
+
+		if((((Widget *)pTree)->ulTreeMsgMask &
+		    WIDGET_MSG_MASK(WIDGET_MSG_UPDATE)) &&
+		   GrRectOverlapCheck(&sPosition, (tRectangle *)psArea))
+		{
+			//
+			// Repaint this widget, if it paints, and count the pixels it has
+			// repainted.
+			//
+			if(((Widget *)pTree)->ulMsgMask &
+			   WIDGET_MSG_MASK(WIDGET_MSG_UPDATE))
+			{
+				((Widget *)pTree)->MessageProc(WIDGET_MSG_UPDATE, 0, 0);
+
+				g_ulPixelsRepainted +=
+				    (((sPosition.sXMax < psArea->sXMax) ?
+				      sPosition.sXMax : psArea->sXMax) -
+				     ((sPosition.sXMin > psArea->sXMin) ?
+				      sPosition.sXMin : psArea->sXMin) + 1) *
+				    (((sPosition.sYMax < psArea->sYMax) ?
+				      sPosition.sYMax : psArea->sYMax) -
+				     ((sPosition.sYMin > psArea->sYMin) ?
+				      sPosition.sYMin : psArea->sYMin) + 1);
+			}
+
+			//
+			// Then go to its children.
+			//
+			if(pTree->ChildGet())
+			{
+				pTree = pTree->ChildGet();
+				continue;
+			}
+		}
+
+		//
+		// Go to the next sibling of this widget or, if there is none, of the
+		// closest parent which has one, without leaving the root widget.
+		//
+		while((pTree != Widget::pRepaintRoot) && !pTree->NextGet())
+		{
+			pTree = pTree->ParentGet();
+		}
+
+		pTree = (pTree == Widget::pRepaintRoot) ? 0 : pTree->NextGet();
+
+		//
+		// Once the walk of an area is complete, flush it at the end of this
+		// frame, and walk the tree again for the next area, if any.
+		//
+		if(!pTree)
+		{
+			GrDirtyRectAdd(psArea);
+
+			if(++Widget::ulRepaintRect < Widget::sRepaintRects.ulCount)
+			{
+				psArea++;
+				Widget::psRepaintRegion = psArea;
+				pTree = Widget::pRepaintRoot;
+			}
+		}
+	}
+	while(pTree && !BudgetSpent());
+
+	Widget::psRepaintRegion = 0;
+
+	//
+	// See if the budget is used up before the end of the walk.
+	//
+	if(pTree)
+	{
+		Widget::pRepaintNext = pTree;
+
+		return(1);
+	}
+
+	Widget::pRepaintNext = 0;
+
+	return(0);
+}
+
+//*****************************************************************************
+//
+//! Restarts the repaint pass in progress, if any.
+//!
+//! This function is called when the widget tree changes while a repaint pass
+//! is paused, since the next widget to visit may have been moved elsewhere in
+//! the tree or destroyed.  All the areas of the pass are repainted again from
+//! the root widget.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+Widget::RepaintRestart(void)
+{
+	if(Widget::pRepaintNext)
+	{
+		Widget::pRepaintNext = Widget::pRepaintRoot;
+		Widget::ulRepaintRect = 0;
+	}
+}
+
+//*****************************************************************************
+//
+//! Gets an absolute coordinates of this widget.
+//!
+//! This function Gets an absolute coordinates of this widget.  The result is
+//! cached, so only the first call after the widget or one of its parents has
+//! been moved or reparented walks up the tree; later calls offset the relative
+//! rectangle by the cached position of its upper left corner.
+//!
+//! \param psPosition is a pointer to the rectangle that contains an absolute
+//! coordinates of this widget.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+Widget::AbsolutePositionGet(tRectangle *psPosition)
+{
+	Widget *pParent;
+
+	//
+	// See if the cached position has to be computed.
+	//
+	if(!this->bAbsPositionValid)
+	{
+		//
+		// Start with the relative position of this widget
+		//
+		this->sAbsOrigin.sX = this->sPosition.sXMin;
+		this->sAbsOrigin.sY = this->sPosition.sYMin;
+
+		//
+		// Offset it by the absolute position of the parent, which is itself
+		// cached.
+		//
+		pParent = (Widget *)this->ParentGet();
+
+		if(pParent)
+		{
+			pParent->AbsolutePositionGet(psPosition);
+
+			this->sAbsOrigin.sX += psPosition->sXMin;
+			this->sAbsOrigin.sY += psPosition->sYMin;
+		}
+
+		this->bAbsPositionValid = 1;
+	}
+
+	psPosition->sXMin = this->sAbsOrigin.sX;
+	psPosition->sYMin = this->sAbsOrigin.sY;
+	psPosition->sXMax = (this->sAbsOrigin.sX +
+	                     (this->sPosition.sXMax - this->sPosition.sXMin));
+	psPosition->sYMax = (this->sAbsOrigin.sY +
+	                     (this->sPosition.sYMax - this->sPosition.sYMin));
+}
+
+//*****************************************************************************
+//
+//! Invalidates the cached absolute positions of this widget tree.
+//!
+//! This function marks the cached absolute position of this widget and all
+//! his children as out of date.  Since a child can only have an up to date
+//! position if its parent has one, there is nothing to do when the position
+//! of this widget is already out of date.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+Widget::AbsolutePositionInvalidate(void)
+{
+	Tree *pTree = 0;
+
+	if(!this->bAbsPositionValid)
+	{
+		return;
+	}
+
+	//
+	// Loop through the tree under the widget.
+	//
+	while((pTree = this->PreOrderSearch(pTree)) != 0)
+	{
+		((Widget *)pTree)->bAbsPositionValid = 0;
+	}
+}
+
+//*****************************************************************************
+//
+//! Invalidates the cached positions when this widget is reparented.
+//!
+//! This function is called by the tree after this widget has been appended to
+//! a parent or cut from it.  The pointer hit-test index is rebuilt on the next
+//! pointer message, and a paused repaint pass is restarted.  The messages
+//! handled by this widget tree are added to those of its new parents.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+Widget::ParentChanged(void)
+{
+	Widget *pParent;
+
+	for(pParent = (Widget *)this->ParentGet();
+	    pParent && ((pParent->ulTreeMsgMask | this->ulTreeMsgMask) !=
+	                pParent->ulTreeMsgMask);
+	    pParent = (Widget *)pParent->ParentGet())
+	{
+		pParent->ulTreeMsgMask |= this->ulTreeMsgMask;
+	}
+
+	this->AbsolutePositionInvalidate();
+	Widget::pHitIndex->Invalidate();
+	Widget::RepaintRestart();
+}
+
+//*****************************************************************************
+//
+//! Starts the auto-repeat timer for this widget.
+//!
+//! \param ulDelay is the number of ticks of GrTimerGet() before the first
+//! auto-repeat event.
+//! \param ulPeriod is the number of ticks between two auto-repeat events
+//! after the first one.
+//!
+//! This function is called by a widget that accepts a pointer press, to
+//! receive \b #WIDGET_MSG_TIMER messages while it is held;
+//! Widget::AutoRepeatIs() tells them apart from those of its own timers.  A
+//! single timer is shared by every widget, since only the widget that has
+//! captured the pointer can be held, and it is stopped when the pointer is
+//! released or pressed again, or when the widget is destroyed.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+Widget::AutoRepeatStart(unsigned long ulDelay, unsigned long ulPeriod)
+{
+	Widget::cAutoRepeatTimer.Start(this, ulDelay, ulPeriod);
+}
+
+//*****************************************************************************
+//
+//! Destroys this widget and all his children.
+//!
+//! This function destroys this widget and all his children.  If one of them
+//! has captured the pointer, the pointer is released, and the messages still
+//! queued for them are cancelled, so that none reaches a widget later created
+//! in the same memory.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+Widget::Destroy(void)
+{
+    Widget *pOwner;
+    Tree *pTemp;
+    Tree *pPrev;
+    Tree *pParent;
 
     //
-    // Detach the widget first
-    //
+    // Detach the widget first, and remove the messages it handles from those
+    // of its former parents.
+    //
+    pOwner = (Widget *)this->ParentGet();
+
     this->Cut();
 
+    if(pOwner)
+    {
+    	pOwner->MessageMaskUpdate();
+    }
+
     pTemp = this;
 
     //
@@ -276,17 +1185,9 @@ Widget::Destroy(void)
         if(pTemp->ChildGet())
         {
             //
-            // Go to this widget's child first.
+            // Go to the last child of this widget first.
             //
-            pTemp = pTemp->ChildGet();
-
-        	//
-        	// Go to the last siblig widget at this level
-        	//
-        	while(pTemp->NextGet())
-        	{
-        		pTemp = pTemp->NextGet();
-        	}
+            pTemp = pTemp->LastChildGet();
         }
 
         //
@@ -305,9 +1206,10 @@ Widget::Destroy(void)
         	while(pTemp != this)
             {
         		//
-        		// Save widget's parent before destroing.
+        		// Save widget's parent and previous sibling before destroing.
         		//
         		pParent = pTemp->ParentGet();
+        		pPrev = pTemp->PrevGet();
 
 				//
 				// Notify parent before destroy widget.
@@ -322,17 +1224,8 @@ Widget::Destroy(void)
 			    //
 			    // See if this widget is not the first child of its parent.
 			    //
-                if(pParent->ChildGet() != pTemp)
+                if(pPrev)
                 {
-					//
-					// Find the sibling directly before this widget (previous).
-					//
-					for(pPrev = pParent->ChildGet(); pPrev->NextGet() != pTemp;
-						pPrev = pPrev->NextGet())
-					{
-					}
-
-
                     //
                     // Visit to the previous sibling of this widget.
                     //
@@ -371,58 +1264,200 @@ Widget::Destroy(void)
 
 //*****************************************************************************
 //
-//! Adds message to the widget message queue.
-//!
-//! \param ulMessage is a message to be added to the widget queue.
-//! \param ulParam1 is a first paramener of the message.
-//! \param ulParam2 is a second paramener of the message.
-//! \param ulFlags is a flags that describe how this message should be
-//! processed.
-//!
-//! This function places a widget message into the message queue for later
-//! processing.
-//!
-//! It is safe for code which interrupts WidgetMessageQueueProcess() (or called
-//! by it) to call this function to send a message.  It is not safe for code
-//! which interrupts this function to call this function as well; it is up to
-//! the caller to guarantee that the later sequence never occurs.
-//!
-//! \return Returns 1 if the message was added to the queue, and 0 if it could
-//! not be added since either the queue is full or another context is currently
-//! adding a message to the queue.
+// Determines if two queued messages are the same message sent to the same
+// widget in the same way.
 //
 //*****************************************************************************
-long
-Widget::MessagePost(Widget *pWidget, unsigned long ulMessage,
-		            unsigned long ulParam1,
-		            unsigned long ulParam2,
+#define MessageSame(psItem1, psItem2)                                        \
+        (((psItem1)->ulMessage == (psItem2)->ulMessage) &&                   \
+         ((psItem1)->pWidget == (psItem2)->pWidget) &&                       \
+         ((psItem1)->ulFlags == (psItem2)->ulFlags))
+
+//*****************************************************************************
+//
+// Replaces the last queued message with a new one if both are the same
+// message (MSG_COALESCE_LATEST).
+//
+//*****************************************************************************
+static long
+MessageLatestMerge(tMessageQueueItem *psTail, const tMessageQueueItem *psItem)
+{
+	if(!MessageSame(psTail, psItem))
+	{
+		return(0);
+	}
+
+	*psTail = *psItem;
+
+	return(1);
+}
+
+//*****************************************************************************
+//
+// Grows the rectangle of the last queued message to include the rectangle of
+// a new one if both are the same message (MSG_COALESCE_RECT).  A message whose
+// parameters are both zero covers the whole area.
+//
+//*****************************************************************************
+static long
+MessageRectMerge(tMessageQueueItem *psTail, const tMessageQueueItem *psItem)
+{
+	long lXMin, lYMin, lXMax, lYMax;
+
+	if(!MessageSame(psTail, psItem))
+	{
+		return(0);
+	}
+
+	if(!psTail->ulParam1 && !psTail->ulParam2)
+	{
+		return(1);
+	}
+
+	if(!psItem->ulParam1 && !psItem->ulParam2)
+	{
+		psTail->ulParam1 = 0;
+		psTail->ulParam2 = 0;
+
+		return(1);
+	}
+
+	lXMin = MSG_PARAM_X(psTail->ulParam1);
+	lYMin = MSG_PARAM_Y(psTail->ulParam1);
+	lXMax = MSG_PARAM_X(psTail->ulParam2);
+	lYMax = MSG_PARAM_Y(psTail->ulParam2);
+
+	if(MSG_PARAM_X(psItem->ulParam1) < lXMin)
+	{
+		lXMin = MSG_PARAM_X(psItem->ulParam1);
+	}
+	if(MSG_PARAM_Y(psItem->ulParam1) < lYMin)
+	{
+		lYMin = MSG_PARAM_Y(psItem->ulParam1);
+	}
+	if(MSG_PARAM_X(psItem->ulParam2) > lXMax)
+	{
+		lXMax = MSG_PARAM_X(psItem->ulParam2);
+	}
+	if(MSG_PARAM_Y(psItem->ulParam2) > lYMax)
+	{
+		lYMax = MSG_PARAM_Y(psItem->ulParam2);
+	}
+
+	psTail->ulParam1 = MSG_PARAM_POINT(lXMin, lYMin);
+	psTail->ulParam2 = MSG_PARAM_POINT(lXMax, lYMax);
+
+	return(1);
+}
+
+//*****************************************************************************
+//
+// Cancels a queued message if it is sent to the widget of another message, by
+// clearing its widget; MessageQueueProcess() skips such messages.
+//
+//*****************************************************************************
+static void
+MessageCancel(tMessageQueueItem *psQueued, const tMessageQueueItem *psItem)
+{
+	if(psQueued->pWidget == psItem->pWidget)
+	{
+		psQueued->pWidget = 0;
+	}
+}
+
+//*****************************************************************************
+//
+// Gets the coalescing policy of a message posted to a widget.  A rule set for
+// the widget itself takes precedence over a rule set for any widget.
+//
+//*****************************************************************************
+static unsigned long
+MessageCoalescePolicyGet(unsigned long ulMessage, Widget *pWidget)
+{
+	unsigned long ulIdx, ulPolicy = MSG_COALESCE_NONE;
+
+	for(ulIdx = 0; ulIdx < WIDGET_COALESCE_RULES; ulIdx++)
+	{
+		if(g_psCoalesceRules[ulIdx].ulMessage != ulMessage)
+		{
+			continue;
+		}
+
+		if(g_psCoalesceRules[ulIdx].pWidget == pWidget)
+		{
+			return(g_psCoalesceRules[ulIdx].ulPolicy);
+		}
+
+		if(!g_psCoalesceRules[ulIdx].pWidget)
+		{
+			ulPolicy = g_psCoalesceRules[ulIdx].ulPolicy;
+		}
+	}
+
+	return(ulPolicy);
+}
+
+//*****************************************************************************
+//
+// Gets the lane of the widget message queue a message is posted to.
+//
+//*****************************************************************************
+static unsigned long
+MessageLaneGet(unsigned long ulMessage)
+{
+	switch(ulMessage)
+	{
+	case WIDGET_MSG_PTR_DOWN:
+	case WIDGET_MSG_PTR_MOVE:
+	case WIDGET_MSG_PTR_UP:
+		return(MSG_LANE_INPUT);
+
+	case WIDGET_MSG_UPDATE:
+		return(MSG_LANE_REPAINT);
+
+	default:
+		return(MSG_LANE_NOTIFY);
+	}
+}
+
+//*****************************************************************************
+//
+//! Adds message to the widget message queue.
+//!
+//! \param ulMessage is a message to be added to the widget queue.
+//! \param ulParam1 is a first paramener of the message.
+//! \param ulParam2 is a second paramener of the message.
+//! \param ulFlags is a flags that describe how this message should be
+//! processed.
+//!
+//! This function places a widget message into the message queue for later
+//! processing.  If the last message of the queue is the same message, sent to
+//! the same widget with the same flags, the new message may be merged into it
+//! instead, as set with Widget::MessageCoalesceSet().  Pointer messages,
+//! repaint messages and other messages are queued in separate lanes, which
+//! are processed by priority (see Widget::MessageQueueProcess()), so messages
+//! of different lanes may be processed in another order than they were posted.
+//!
+//! It is safe for code which interrupts Widget::MessageQueueProcess() (or
+//! called by it) to call this function to send a message, as well as for code
+//! which interrupts this function, or for several threads at once; the message
+//! queue does not use any lock.
+//!
+//! \return Returns 1 if the message was added to the queue, and 0 if it could
+//! not be added since the queue is full.
+//
+//*****************************************************************************
+long
+Widget::MessagePost(Widget *pWidget, unsigned long ulMessage,
+		            unsigned long ulParam1,
+		            unsigned long ulParam2,
 		            unsigned long ulFlags)
 {
+    MQueue<tMessageQueueItem, WIDGET_MSG_QUEUE_SIZE> *pQueue;
     tMessageQueueItem sMessageQueueItem;
+    long lRet;
 
-    //
-    // If the queue is not empty, and this is a pointer move message, see if
-    // the previous message was also a move and, if so, replace the
-    // coordinates.  Without this, the message queue can very quickly overflow
-    // if the application is busy doing something while the user keeps pressing
-    // the display.
-    //
-    if(ulMessage == WIDGET_MSG_PTR_MOVE)
-    {
-    	if(Widget::pMQueue->Show(&sMessageQueueItem))
-    	{
-    		if(sMessageQueueItem.ulMessage == WIDGET_MSG_PTR_MOVE)
-    		{
-    		    sMessageQueueItem.pWidget   = pWidget;
-    		    sMessageQueueItem.ulMessage = ulMessage;
-    		    sMessageQueueItem.ulParam1  = ulParam1;
-    		    sMessageQueueItem.ulParam2  = ulParam2;
-    		    sMessageQueueItem.ulFlags   = ulFlags;
-
-    		    return Widget::pMQueue->OverWrite(&sMessageQueueItem);
-    		}
-    	}
-    }
+    pQueue = &g_psMessageQueues[MessageLaneGet(ulMessage)];
 
 	sMessageQueueItem.pWidget   = pWidget;
 	sMessageQueueItem.ulMessage = ulMessage;
@@ -430,10 +1465,149 @@ Widget::MessagePost(Widget *pWidget, unsigned long ulMessage,
 	sMessageQueueItem.ulParam2  = ulParam2;
 	sMessageQueueItem.ulFlags   = ulFlags;
 
-	return Widget::pMQueue->EnQueue(&sMessageQueueItem);
+    //
+    // See if the message can be merged into the last queued message, according
+    // to its coalescing policy.
+    //
+    switch(MessageCoalescePolicyGet(ulMessage, pWidget))
+    {
+    case MSG_COALESCE_LATEST:
+    	lRet = pQueue->TailUpdate(&sMessageQueueItem, MessageLatestMerge);
+    	break;
+
+    case MSG_COALESCE_RECT:
+    	lRet = pQueue->TailUpdate(&sMessageQueueItem, MessageRectMerge);
+    	break;
+
+    default:
+    	lRet = 0;
+    	break;
+    }
+
+    if(lRet)
+    {
+    	__atomic_fetch_add(&g_sMessageQueueStats.ulMerged, 1, __ATOMIC_RELAXED);
+
+    	return(1);
+    }
+
+    //
+    // Add the message to the queue.
+    //
+	if(!pQueue->EnQueue(&sMessageQueueItem))
+	{
+		__atomic_fetch_add(&g_sMessageQueueStats.ulDropped, 1,
+		                   __ATOMIC_RELAXED);
+
+		return(0);
+	}
+
+	__atomic_fetch_add(&g_sMessageQueueStats.ulPosted, 1, __ATOMIC_RELAXED);
+
+	return(1);
 }
 
 
+//*****************************************************************************
+//
+//! Sets how messages posted to a widget are coalesced in the queue.
+//!
+//! \param ulMessage is the message to set the policy for.
+//! \param pWidget is the widget the policy applies to, or zero for any widget.
+//! \param ulPolicy is the coalescing policy; this is one of
+//! \b #MSG_COALESCE_NONE, \b #MSG_COALESCE_LATEST or \b #MSG_COALESCE_RECT.
+//!
+//! This function sets what Widget::MessagePost() does when \e ulMessage is
+//! posted to \e pWidget while the last message of the queue is the same
+//! message, sent to the same widget with the same flags.  A policy set for a
+//! widget takes precedence over the policy set for any widget.  By default,
+//! \b #WIDGET_MSG_PTR_MOVE messages use \b #MSG_COALESCE_LATEST,
+//! \b #WIDGET_MSG_UPDATE messages use \b #MSG_COALESCE_RECT and all other
+//! messages use \b #MSG_COALESCE_NONE.
+//!
+//! This function must not be called while messages are being posted.
+//!
+//! \return Returns 1 if the policy was set, or 0 if there is no room left for
+//! a new rule.
+//
+//*****************************************************************************
+long
+Widget::MessageCoalesceSet(unsigned long ulMessage, Widget *pWidget,
+                           unsigned long ulPolicy)
+{
+	unsigned long ulIdx;
+	tCoalesceRule *psFree = 0;
+
+	//
+	// Look for the rule of this message and widget, or for a free rule.
+	//
+	for(ulIdx = 0; ulIdx < WIDGET_COALESCE_RULES; ulIdx++)
+	{
+		if((g_psCoalesceRules[ulIdx].ulMessage == ulMessage) &&
+		   (g_psCoalesceRules[ulIdx].pWidget == pWidget))
+		{
+			g_psCoalesceRules[ulIdx].ulPolicy = ulPolicy;
+
+			return(1);
+		}
+
+		if(!psFree && !g_psCoalesceRules[ulIdx].ulMessage)
+		{
+			psFree = &g_psCoalesceRules[ulIdx];
+		}
+	}
+
+	if(!psFree)
+	{
+		return(0);
+	}
+
+	psFree->ulPolicy  = ulPolicy;
+	psFree->pWidget   = pWidget;
+	psFree->ulMessage = ulMessage;
+
+	return(1);
+}
+
+//*****************************************************************************
+//
+//! Gets the counters of the widget message queue activity.
+//!
+//! \param psStats is a pointer to the structure that receives the counters.
+//!
+//! This function returns the number of messages added to the queue, merged
+//! into a queued message, or lost since the queue was full, since the last
+//! call to Widget::MessageQueueStatsReset().
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+Widget::MessageQueueStatsGet(tMessageQueueStats *psStats)
+{
+	psStats->ulPosted  = __atomic_load_n(&g_sMessageQueueStats.ulPosted,
+	                                     __ATOMIC_RELAXED);
+	psStats->ulMerged  = __atomic_load_n(&g_sMessageQueueStats.ulMerged,
+	                                     __ATOMIC_RELAXED);
+	psStats->ulDropped = __atomic_load_n(&g_sMessageQueueStats.ulDropped,
+	                                     __ATOMIC_RELAXED);
+}
+
+//*****************************************************************************
+//
+//! Resets the counters of the widget message queue activity.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+Widget::MessageQueueStatsReset(void)
+{
+	__atomic_store_n(&g_sMessageQueueStats.ulPosted, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&g_sMessageQueueStats.ulMerged, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&g_sMessageQueueStats.ulDropped, 0, __ATOMIC_RELAXED);
+}
+
 //*****************************************************************************
 //
 //! Sends a message to a widget tree.
@@ -490,110 +1664,375 @@ Widget::MessageSend(Widget *pWidget, unsigned long ulMessage,
 
 //*****************************************************************************
 //
-//! Sends notification message to parent.
+//! Sets the messages this widget handles.
 //!
-//! This function sends notification message to parent.
+//! \param ulMask is the set of messages, made of WIDGET_MSG_MASK() bits, or
+//! \b #WIDGET_MSG_MASK_ALL.
 //!
-//! \param ulMessage is the message to send.
+//! This function tells which messages this widget handles.  A message sent to
+//! a widget tree is only offered to the widgets that handle it, and the
+//! subtrees where no widget handles it are not visited at all.  Widget classes
+//! call it from their constructor; a class derived from one of them that
+//! handles more messages must add them to the mask it inherits.  Messages sent
+//! with \b #MSG_FLAG_STOP_ON_FIRST, such as notifications, and the messages
+//! sent directly to a widget, such as pointer moves to the widget that has
+//! captured the pointer, are always delivered.
 //!
-//! \return Returns 1 if success.
+//! \return None.
 //
 //*****************************************************************************
-long Widget::ParentNotify(Widget *pWidget, unsigned long ulMessage)
+void
+Widget::MessageMaskSet(unsigned long ulMask)
 {
-	Widget *pParent;
-
-	pParent = (Widget *)pWidget->ParentGet();
+	this->ulMsgMask = ulMask;
+	this->MessageMaskUpdate();
 
-	if(pParent)
-	{
-		return Widget::MessageSend(pParent,
-								   ulMessage,
-								   pWidget->ucID,
-								   (unsigned long)pWidget,
-								   MSG_FLAG_STOP_ON_FIRST);
-	}
-	else
+	//
+	// The hit-test index only holds the widgets that handle pointer presses.
+	//
+	if(Widget::pHitIndex)
 	{
-		return 0;
+		Widget::pHitIndex->Invalidate();
 	}
 }
 
 //*****************************************************************************
 //
-//! Sends a message to a widget tree via a pre-order, depth-first search.
-//!
-//! \param ulMessage is the message to send.
-//! \param ulParam1 is the first parameter to the message.
-//! \param ulParam2 is the second parameter to the message.
-//! \param bStopOnSuccess is true if the search should be stopped when the
-//! first widget is found that returns success in response to the message.
-//!
-//! This function performs a pre-order, depth-first search of the widget tree,
-//! sending a message to each widget encountered.  In a depth-first search, the
-//! children of a widget are searched before its siblings (preferring to go
-//! deeper into the tree, hence the name depth-first).  A pre-order search
-//! means that the message is sent to a widget before any of its children are
-//! searched.
+//! Updates the messages handled by the widget trees this widget is part of.
 //!
-//! An example use of the pre-order search is for paint messages; the larger
-//! enclosing widgets should be drawn on the screen before the smaller widgets
-//! that reside within the parent widget (otherwise, the children would be
-//! overwritten by the parent).
+//! This function computes again the messages handled by the tree under this
+//! widget, then under each of its parents, stopping at the first one that
+//! does not change.
 //!
-//! \return Returns 0 if \e bStopOnSuccess is false or no widget returned
-//! success in response to the message, or the value returned by the first
-//! widget to successfully process the message.
+//! \return None.
 //
 //*****************************************************************************
-long
-Widget::MessageSendPreOrder(Widget *pWidget, unsigned long ulMessage,
-                            unsigned long ulParam1, unsigned long ulParam2,
-                            char bStopOnSuccess, char bStopAfterFirst)
+void
+Widget::MessageMaskUpdate(void)
 {
-    Tree *pTree = 0;
-    long  lRet;
+	unsigned long ulMask;
+	Widget *pWidget;
+	Tree *pChild;
 
-	//
-	// Loop through the tree under the widget until every widget is searched.
-	//
-	do
+	for(pWidget = this; pWidget; pWidget = (Widget *)pWidget->ParentGet())
 	{
-		pTree = pWidget->PreOrderSearch(pTree);
+		ulMask = pWidget->ulMsgMask;
 
-		if(pTree)
+		for(pChild = pWidget->ChildGet(); pChild; pChild = pChild->NextGet())
 		{
-			//
-			// Send the message to this widget and return if it succeeded and the
-			// search should stop on success.
-			//
-			lRet = ((Widget *)pTree)->MessageProc(ulMessage, ulParam1, ulParam2);
+			ulMask |= ((Widget *)pChild)->ulTreeMsgMask;
+		}
 
-			if(((lRet != 0) && bStopOnSuccess) || bStopAfterFirst)
-			{
-				return(lRet);
-			}
+		if(ulMask == pWidget->ulTreeMsgMask)
+		{
+			break;
 		}
-	}
-	while(pTree);
 
-    //
-    // No widget returned success for the message, or bStopOnSuccess was zero,
-    // so return zero.
-    //
-    return(0);
+		pWidget->ulTreeMsgMask = ulMask;
+	}
 }
 
-
 //*****************************************************************************
 //
-//! Sends a message to a widget tree via a post-order, depth-first search.
+//! Finds the next widget of this tree that handles a message, in pre-order.
 //!
-//! \param ulMessage is the message to send.
-//! \param ulParam1 is the first parameter to the message.
-//! \param ulParam2 is the second parameter to the message.
-//! \param bStopOnSuccess is true if the search should be stopped when the
-//! first widget is found that returns success in response to the message.
+//! \param pLastSearch is a pointer to the widget returned by the previous
+//! call, or zero to start the search.
+//! \param ulMask is the WIDGET_MSG_MASK() bit of the message.
+//!
+//! This function walks the tree under this widget in the same order as
+//! Tree::PreOrderSearch(), but only returns the widgets that handle the
+//! message, and skips the subtrees where no widget handles it.
+//!
+//! \return Returns a pointer to the next widget that handles the message, or
+//! zero if there is none.
+//
+//*****************************************************************************
+Widget *
+Widget::SubscriberPreOrderSearch(Widget *pLastSearch, unsigned long ulMask)
+{
+	Widget *pTree;
+	Tree *pNext;
+
+	//
+	// Start with this widget, if anything under it handles the message.
+	//
+	if(!pLastSearch)
+	{
+		if(!(this->ulTreeMsgMask & ulMask))
+		{
+			return(0);
+		}
+
+		if(this->ulMsgMask & ulMask)
+		{
+			return(this);
+		}
+	}
+
+	pTree = pLastSearch ? pLastSearch : this;
+
+	while(1)
+	{
+		//
+		// Go to the first child whose subtree handles the message.
+		//
+		for(pNext = pTree->ChildGet();
+		    pNext && !(((Widget *)pNext)->ulTreeMsgMask & ulMask);
+		    pNext = pNext->NextGet())
+		{
+		}
+
+		//
+		// Otherwise, go to the next such sibling of this widget or, if there
+		// is none, of the closest parent which has one, without leaving this
+		// widget.
+		//
+		while(!pNext && (pTree != this))
+		{
+			for(pNext = pTree->NextGet();
+			    pNext && !(((Widget *)pNext)->ulTreeMsgMask & ulMask);
+			    pNext = pNext->NextGet())
+			{
+			}
+
+			if(!pNext)
+			{
+				pTree = (Widget *)pTree->ParentGet();
+			}
+		}
+
+		if(!pNext)
+		{
+			return(0);
+		}
+
+		pTree = (Widget *)pNext;
+
+		if(pTree->ulMsgMask & ulMask)
+		{
+			return(pTree);
+		}
+	}
+}
+
+//*****************************************************************************
+//
+//! Finds the next widget of this tree that handles a message, in post-order.
+//!
+//! \param pLastSearch is a pointer to the widget returned by the previous
+//! call, or zero to start the search.
+//! \param ulMask is the WIDGET_MSG_MASK() bit of the message.
+//!
+//! This function walks the tree under this widget in the same order as
+//! Tree::PostOrderSearch(), but only returns the widgets that handle the
+//! message, and skips the subtrees where no widget handles it.
+//!
+//! \return Returns a pointer to the next widget that handles the message, or
+//! zero if there is none.
+//
+//*****************************************************************************
+Widget *
+Widget::SubscriberPostOrderSearch(Widget *pLastSearch, unsigned long ulMask)
+{
+	Widget *pTree;
+	Tree *pNext;
+
+	if(!pLastSearch)
+	{
+		if(!(this->ulTreeMsgMask & ulMask))
+		{
+			return(0);
+		}
+
+		pTree = this;
+	}
+	else
+	{
+		pTree = pLastSearch;
+	}
+
+	while(1)
+	{
+		if(pLastSearch)
+		{
+			if(pTree == this)
+			{
+				return(0);
+			}
+
+			//
+			// Go to the previous sibling whose subtree handles the message or,
+			// if there is none, to the parent.
+			//
+			for(pNext = pTree->PrevGet();
+			    pNext && !(((Widget *)pNext)->ulTreeMsgMask & ulMask);
+			    pNext = pNext->PrevGet())
+			{
+			}
+
+			if(!pNext)
+			{
+				pTree = (Widget *)pTree->ParentGet();
+			}
+		}
+		else
+		{
+			pNext = pTree;
+		}
+
+		//
+		// Find the deepest widget under a sibling, going through the last
+		// child whose subtree handles the message at each level.
+		//
+		if(pNext)
+		{
+			pTree = (Widget *)pNext;
+
+			do
+			{
+				for(pNext = pTree->LastChildGet();
+				    pNext && !(((Widget *)pNext)->ulTreeMsgMask & ulMask);
+				    pNext = pNext->PrevGet())
+				{
+				}
+
+				if(pNext)
+				{
+					pTree = (Widget *)pNext;
+				}
+			}
+			while(pNext);
+		}
+
+		if(pTree->ulMsgMask & ulMask)
+		{
+			return(pTree);
+		}
+
+		pLastSearch = pTree;
+	}
+}
+
+//*****************************************************************************
+//
+//! Sends notification message to parent.
+//!
+//! This function sends notification message to parent.
+//!
+//! \param ulMessage is the message to send.
+//!
+//! \return Returns 1 if success.
+//
+//*****************************************************************************
+long Widget::ParentNotify(Widget *pWidget, unsigned long ulMessage)
+{
+	Widget *pParent;
+
+	pParent = (Widget *)pWidget->ParentGet();
+
+	if(pParent)
+	{
+		return Widget::MessageSend(pParent,
+								   ulMessage,
+								   pWidget->ucID,
+								   (unsigned long)pWidget,
+								   MSG_FLAG_STOP_ON_FIRST);
+	}
+	else
+	{
+		return 0;
+	}
+}
+
+//*****************************************************************************
+//
+//! Sends a message to a widget tree via a pre-order, depth-first search.
+//!
+//! \param ulMessage is the message to send.
+//! \param ulParam1 is the first parameter to the message.
+//! \param ulParam2 is the second parameter to the message.
+//! \param bStopOnSuccess is true if the search should be stopped when the
+//! first widget is found that returns success in response to the message.
+//!
+//! This function performs a pre-order, depth-first search of the widget tree,
+//! sending a message to each widget encountered.  In a depth-first search, the
+//! children of a widget are searched before its siblings (preferring to go
+//! deeper into the tree, hence the name depth-first).  A pre-order search
+//! means that the message is sent to a widget before any of its children are
+//! searched.
+//!
+//! An example use of the pre-order search is for paint messages; the larger
+//! enclosing widgets should be drawn on the screen before the smaller widgets
+//! that reside within the parent widget (otherwise, the children would be
+//! overwritten by the parent).
+//!
+//! Only the widgets that handle the message are visited (see
+//! Widget::MessageMaskSet()), except with \e bStopAfterFirst, where the
+//! message is always sent to \e pWidget.
+//!
+//! \return Returns 0 if \e bStopOnSuccess is false or no widget returned
+//! success in response to the message, or the value returned by the first
+//! widget to successfully process the message.
+//
+//*****************************************************************************
+long
+Widget::MessageSendPreOrder(Widget *pWidget, unsigned long ulMessage,
+                            unsigned long ulParam1, unsigned long ulParam2,
+                            char bStopOnSuccess, char bStopAfterFirst)
+{
+    Widget *pTree = 0;
+    long    lRet;
+
+    //
+    // The first widget of the search is the widget itself.
+    //
+    if(bStopAfterFirst)
+    {
+    	return(pWidget->MessageProc(ulMessage, ulParam1, ulParam2));
+    }
+
+	//
+	// Loop through the widgets under the widget that handle the message.
+	//
+	do
+	{
+		pTree = pWidget->SubscriberPreOrderSearch(pTree,
+		                                          WIDGET_MSG_MASK(ulMessage));
+
+		if(pTree)
+		{
+			//
+			// Send the message to this widget and return if it succeeded and the
+			// search should stop on success.
+			//
+			lRet = pTree->MessageProc(ulMessage, ulParam1, ulParam2);
+
+			if((lRet != 0) && bStopOnSuccess)
+			{
+				return(lRet);
+			}
+		}
+	}
+	while(pTree);
+
+    //
+    // No widget returned success for the message, or bStopOnSuccess was zero,
+    // so return zero.
+    //
+    return(0);
+}
+
+
+//*****************************************************************************
+//
+//! Sends a message to a widget tree via a post-order, depth-first search.
+//!
+//! \param ulMessage is the message to send.
+//! \param ulParam1 is the first parameter to the message.
+//! \param ulParam2 is the second parameter to the message.
+//! \param bStopOnSuccess is true if the search should be stopped when the
+//! first widget is found that returns success in response to the message.
 //!
 //! This function performs a post-order, depth-first search of the widget tree,
 //! sending a message to each widget encountered.  In a depth-first search, the
@@ -611,7 +2050,15 @@ Widget::MessageSendPreOrder(Widget *pWidget, unsigned long ulMessage,
 //! Special handling is performed for pointer-related messages.  The widget
 //! that accepts \b #WIDGET_MSG_PTR_DOWN is remembered and subsequent
 //! \b #WIDGET_MSG_PTR_MOVE and \b #WIDGET_MSG_PTR_UP messages are sent
-//! directly to that widget.
+//! directly to that widget, until the pointer is released or the widget is
+//! destroyed.  A \b #WIDGET_MSG_PTR_DOWN message sent to the whole widget tree
+//! with \e bStopOnSuccess is only offered to the widgets whose rectangle
+//! contains the pointer, which are looked up in a spatial index rather than by
+//! visiting every widget of the tree.
+//!
+//! Only the widgets that handle the message are visited (see
+//! Widget::MessageMaskSet()), except with \e bStopAfterFirst, where the
+//! message is always sent to the first widget of the search.
 //!
 //! \return Returns 0 if \e bStopOnSuccess is false or no widget returned
 //! success in response to the message, or the value returned by the first
@@ -623,34 +2070,106 @@ Widget::MessageSendPostOrder(Widget *pWidget, unsigned long ulMessage,
                              unsigned long ulParam1, unsigned long ulParam2,
                              char bStopOnSuccess, char bStopAfterFirst)
 {
-    Widget *pTemp;
-    Tree   *pTree = 0;
+    Widget *pTemp = 0;
     long    lRet;
 
+    //
+    // See if this is a pointer move or release and a widget has captured the
+    // pointer.
+    //
+    if(((ulMessage == WIDGET_MSG_PTR_MOVE) ||
+        (ulMessage == WIDGET_MSG_PTR_UP)) && Widget::pPointerWidget)
+    {
+    	pTemp = Widget::pPointerWidget;
+
+    	//
+    	// The pointer is no longer captured once it is released, which ends
+    	// the auto-repeat events.
+    	//
+    	if(ulMessage == WIDGET_MSG_PTR_UP)
+    	{
+    		Widget::pPointerWidget = 0;
+    		Widget::AutoRepeatStop();
+    	}
+
+    	//
+    	// Send the message directly to the widget that has captured the
+    	// pointer.
+    	//
+    	return(pTemp->MessageProc(ulMessage, ulParam1, ulParam2));
+    }
+
+    //
+    // A pointer press releases the pointer, since the previous release may
+    // have been lost.  It is captured again by the widget accepting the press.
+    //
+    if(ulMessage == WIDGET_MSG_PTR_DOWN)
+    {
+    	Widget::pPointerWidget = 0;
+    	Widget::AutoRepeatStop();
+    }
+
+    //
+    // See if this is a pointer press on the whole widget tree, that can be
+    // dispatched through the hit-test index.
+    //
+    if((ulMessage == WIDGET_MSG_PTR_DOWN) && (pWidget == g_pcRootWidget) &&
+       bStopOnSuccess && !bStopAfterFirst)
+    {
+    	return(Widget::pHitIndex->MessageSend(pWidget, ulMessage,
+    	                                      (long)ulParam1, (long)ulParam2,
+    	                                      &Widget::pPointerWidget));
+    }
+
+    //
+    // The first widget of the search is the deepest one under the last
+    // children.
+    //
+    if(bStopAfterFirst)
+    {
+    	pTemp = (Widget *)pWidget->PostOrderSearch(0);
+    	lRet = pTemp->MessageProc(ulMessage, ulParam1, ulParam2);
+
+    	if((ulMessage == WIDGET_MSG_PTR_DOWN) && (lRet != 0))
+    	{
+    		Widget::pPointerWidget = pTemp;
+    	}
+
+    	return(lRet);
+    }
+
 	do
 	{
-		pTree = pWidget->PostOrderSearch(pTree);
+		pTemp = pWidget->SubscriberPostOrderSearch(pTemp,
+		                                           WIDGET_MSG_MASK(ulMessage));
 
-		if(pTree)
+		if(pTemp)
 		{
-			pTemp = (Widget *)pTree;
-
 			//
 			// Send the message to this widget.
 			//
 			lRet = pTemp->MessageProc(ulMessage, ulParam1, ulParam2);
 
+			//
+			// If this is a pointer press and the widget accepted it, the widget
+			// captures the pointer.
+			//
+			if((ulMessage == WIDGET_MSG_PTR_DOWN) && (lRet != 0))
+			{
+				Widget::pPointerWidget = pTemp;
+			}
+
 			//
 			// If the widget returned success and the search should stop on
 			// success then return immediately.
 			//
-			if(((lRet != 0) && bStopOnSuccess) || bStopAfterFirst)
+			if((lRet != 0) && bStopOnSuccess)
 			{
 				return(lRet);
 			}
 		}
 	}
-	while(pTree);
+	while(pTemp);
 
     //
     // No widget returned success for the message, or bStopOnSuccess was zero,
@@ -678,53 +2197,524 @@ long Widget::MessageProc(unsigned long ulMessage, unsigned long ulParam1,
 	return(0);
 }
 
+//*****************************************************************************
+//
+// Takes the next message to process from the lanes of the widget message
+// queue.
+//
+// The message is taken from the highest priority lane that has one.  To avoid
+// starving the lower priority lanes, a message is taken from a lane that has
+// been passed over WIDGET_MSG_LANE_STARVATION times first.
+//
+//*****************************************************************************
+static long
+MessageQueueNext(tMessageQueueItem *psItem)
+{
+	unsigned long ulLane, ulIdx;
+
+	//
+	// Take a message from a lane that has been passed over too many times, if
+	// any.  A lane found empty no longer counts as passed over.
+	//
+	for(ulLane = 0; ulLane < MSG_LANES; ulLane++)
+	{
+		if(g_pulLaneSkipped[ulLane] >= WIDGET_MSG_LANE_STARVATION)
+		{
+			g_pulLaneSkipped[ulLane] = 0;
+
+			if(g_psMessageQueues[ulLane].DeQueue(psItem))
+			{
+				break;
+			}
+		}
+	}
+
+	//
+	// Otherwise, take a message from the highest priority lane that has one.
+	//
+	if(ulLane == MSG_LANES)
+	{
+		for(ulLane = 0; ulLane < MSG_LANES; ulLane++)
+		{
+			if(g_psMessageQueues[ulLane].DeQueue(psItem))
+			{
+				break;
+			}
+		}
+	}
+
+	//
+	// See if every lane is empty.
+	//
+	if(ulLane == MSG_LANES)
+	{
+		return(0);
+	}
+
+	//
+	// The lower priority lanes have been passed over once more.
+	//
+	for(ulIdx = ulLane + 1; ulIdx < MSG_LANES; ulIdx++)
+	{
+		g_pulLaneSkipped[ulIdx]++;
+	}
+
+	return(1);
+}
+
 //*****************************************************************************
 //
 //! Processes the messages in the widget message queue.
 //!
-//! This function extracts messages from the widget message queue one at a time
-//! and processes them.  If the processing of a widget message requires that a
-//! new message be sent, it is acceptable to call Widget::MessagePost().
-//! It is also acceptable for code which interrupts this function to call
-//! Widget::MessagePost() to send more messages.  In both cases, the newly
-//! added message will also be processed before this function returns.
+//! This function first runs the widget timers that have expired (see
+//! WidgetTimer::Process()) and steps the animations (see
+//! Animation::Process()), then extracts messages from the widget message
+//! queue one at a time and processes them.  Pointer messages are processed
+//! first, then notifications and other messages, then repaint messages, so
+//! that a burst of repaints does not delay the response to the pointer.  To
+//! avoid starving the lower priority messages, one of them is processed
+//! anyway after \b WIDGET_MSG_LANE_STARVATION messages of higher priority
+//! have been processed in its place.  If the processing of a widget message
+//! requires that a new message be sent, it is acceptable to call
+//! Widget::MessagePost().  It is also acceptable for code which interrupts
+//! this function to call Widget::MessagePost() to send more messages.  In
+//! both cases, the newly added message will also be processed before this
+//! function returns.
+//!
+//! Once the queue is empty, the widgets that intersect the invalid areas (see
+//! Widget::Invalidate()) are repainted, and the areas marked as dirty while
+//! drawing (see Widget::Flush()) are flushed to the display in one pass.
 //!
 //! \return None.
 //
 //*****************************************************************************
 void
 Widget::MessageQueueProcess(void)
+{
+	Widget::MessageQueueProcess(0, 0);
+}
+
+//*****************************************************************************
+//
+//! Processes the messages in the widget message queue within a budget.
+//!
+//! \param ulTimeBudget is the time this function may use, in ticks of the
+//! clock set with Widget::ClockSet(), or zero for no limit.
+//! \param ulPixelBudget is the number of pixels this function may repaint, or
+//! zero for no limit.
+//!
+//! This function works as Widget::MessageQueueProcess(void), but returns once
+//! its budget is used up, leaving the remaining work for the next call.  The
+//! budget is checked after each message and after each widget repainted, so
+//! at least one message or widget is processed per call, and a single message
+//! or widget is never interrupted.  A repaint pass interrupted this way
+//! resumes where it stopped; its area is only flushed once it is complete.
+//!
+//! A \b #WIDGET_MSG_UPDATE message posted to a widget tree without any
+//! search flags is turned into an invalidation of the area given by its
+//! parameters, or of the whole widget if they are both zero (see
+//! Widget::Invalidate()), so that it is repainted by the resumable repaint pass
+//! rather than in one go.
+//!
+//! \return Returns 1 if some work is left for the next call, and 0 if the
+//! message queue is empty and nothing is left to repaint.
+//
+//*****************************************************************************
+long
+Widget::MessageQueueProcess(unsigned long ulTimeBudget,
+                            unsigned long ulPixelBudget)
 {
 	tMessageQueueItem sMessageQueueItem;
+	tRectangle sRect;
+	long lRet;
+
+	//
+	// Start the budget of this call.
+	//
+	g_ulBudgetStart = g_pfnClock();
+	g_ulTimeBudget = ulTimeBudget;
+	g_ulPixelBudget = ulPixelBudget;
+	g_ulPixelsRepainted = 0;
+
+	lRet = 0;
+
+	//
+	// Run the timers that have expired.
+	//
+	WidgetTimer::Process();
+
+	//
+	// Step the animations, if a frame is due.
+	//
+	Animation::Process();
 
     //
     // Loop while there are more messages in the message queue.
     //
-    while(Widget::pMQueue->DeQueue(&sMessageQueueItem))
+    while(MessageQueueNext(&sMessageQueueItem))
     {
+    	//
+    	// Skip a message whose widget has been destroyed since it was posted.
+    	//
+    	if(!sMessageQueueItem.pWidget)
+    	{
+    		continue;
+    	}
+
+    	//
+    	// Turn a repaint of a widget tree into an invalidation of the area
+    	// it names, or of the whole widget.
+    	//
+    	if((sMessageQueueItem.ulMessage == WIDGET_MSG_UPDATE) &&
+    	   !sMessageQueueItem.ulFlags)
+    	{
+    		if(!sMessageQueueItem.ulParam1 && !sMessageQueueItem.ulParam2)
+    		{
+    			sMessageQueueItem.pWidget->Invalidate();
+    		}
+    		else
+    		{
+    			sRect.sXMin = MSG_PARAM_X(sMessageQueueItem.ulParam1);
+    			sRect.sYMin = MSG_PARAM_Y(sMessageQueueItem.ulParam1);
+    			sRect.sXMax = MSG_PARAM_X(sMessageQueueItem.ulParam2);
+    			sRect.sYMax = MSG_PARAM_Y(sMessageQueueItem.ulParam2);
+    			sMessageQueueItem.pWidget->Invalidate(&sRect);
+    		}
+    	}
+    	else
+    	{
+			//
+			// Send this message to the widget.
+			//
+			Widget::MessageSend(sMessageQueueItem.pWidget,
+								sMessageQueueItem.ulMessage,
+								sMessageQueueItem.ulParam1,
+								sMessageQueueItem.ulParam2,
+								sMessageQueueItem.ulFlags);
+    	}
+
 		//
-		// Send this message to the widget.
+		// Stop if the budget is used up.
 		//
-		Widget::MessageSend(sMessageQueueItem.pWidget,
-							sMessageQueueItem.ulMessage,
-							sMessageQueueItem.ulParam1,
-							sMessageQueueItem.ulParam2,
-							sMessageQueueItem.ulFlags);
+		if(BudgetSpent())
+		{
+			lRet = 1;
+			break;
+		}
+    }
+
+    //
+    // Repaint the invalid areas.
+    //
+    if(!lRet)
+    {
+    	lRet = Widget::Repaint() || Widget::sInvalidRects.ulCount;
     }
+
+    //
+    // Flush everything that has been drawn during this frame.
+    //
+    GrDirtyRectFlush(Widget::pDisplay);
+
+    return(lRet);
+}
+
+//*****************************************************************************
+//
+//! Sets the clock used to measure the time budget of the message queue
+//! processing.
+//!
+//! \param pfnClock is a pointer to the function that returns the current
+//! time, in ticks of any length, or zero to use GrTimerGet().
+//!
+//! This function sets the clock read by Widget::MessageQueueProcess() to
+//! check its time budget.  By default, it is GrTimerGet(), which counts
+//! milliseconds; a finer clock, such as a free-running hardware timer, allows
+//! a tighter budget.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+Widget::ClockSet(unsigned long (*pfnClock)(void))
+{
+	g_pfnClock = pfnClock ? pfnClock : GrTimerGet;
+}
+
+//*****************************************************************************
+//
+//! Determines if an area is waiting to be repainted.
+//!
+//! This function tells whether an area has been invalidated (see
+//! Widget::Invalidate()) and not repainted yet, or a repaint pass has been
+//! paused by the budget of Widget::MessageQueueProcess().
+//!
+//! \return Returns 1 if an area is waiting to be repainted, and 0 otherwise.
+//
+//*****************************************************************************
+long
+Widget::RepaintPending(void)
+{
+	return((Widget::pRepaintNext != 0) ||
+	       (Widget::sInvalidRects.ulCount != 0));
+}
+
+//*****************************************************************************
+//
+//! Gets the time the widget framework can stay idle.
+//!
+//! This function tells how long the application may sleep before calling
+//! Widget::FrameProcess() again, based on the messages waiting in the queue,
+//! the areas waiting to be repainted or flushed, the next widget timer to
+//! expire (see WidgetTimer::NextExpiryGet()), the next animation frame (see
+//! Animation::NextFrameGet()), and the shortest time between two frames (see
+//! Widget::FramePeriodSet()).  A message posted meanwhile, such as from a
+//! pointer interrupt, makes this time shorter, so the application must wake
+//! up when one is posted.
+//!
+//! \return Returns the number of milliseconds the widget framework can stay
+//! idle, zero if a frame is due, or \b #WIDGET_IDLE_FOREVER if there is
+//! nothing to do until the next message is posted.
+//
+//*****************************************************************************
+unsigned long
+Widget::IdleTimeGet(void)
+{
+	unsigned long ulIdle, ulNext, ulLane;
+
+	//
+	// A paused repaint pass is resumed at once, since it is the rest of the
+	// last frame.
+	//
+	if(Widget::pRepaintNext)
+	{
+		return(0);
+	}
+
+	//
+	// See if anything is waiting: damage, messages or drawing to flush.
+	//
+	ulIdle = WIDGET_IDLE_FOREVER;
+
+	if(Widget::sInvalidRects.ulCount || GrDirtyRectCountGet())
+	{
+		ulIdle = 0;
+	}
+
+	for(ulLane = 0; (ulLane < MSG_LANES) && ulIdle; ulLane++)
+	{
+		if(!g_psMessageQueues[ulLane].IsEmpty())
+		{
+			ulIdle = 0;
+		}
+	}
+
+	//
+	// Otherwise, wait for the next timer or animation frame.
+	//
+	ulNext = WidgetTimer::NextExpiryGet();
+
+	if(ulNext < ulIdle)
+	{
+		ulIdle = ulNext;
+	}
+
+	ulNext = Animation::NextFrameGet();
+
+	if(ulNext < ulIdle)
+	{
+		ulIdle = ulNext;
+	}
+
+	//
+	// Nothing to do ever, until a message is posted.
+	//
+	if(ulIdle == WIDGET_IDLE_FOREVER)
+	{
+		return(ulIdle);
+	}
+
+	//
+	// Do not run frames closer than the frame period.
+	//
+	ulNext = GrTimerGet() - g_ulFrameTime;
+
+	if(g_bFrameRun && (ulNext < g_ulFramePeriod) &&
+	   (ulIdle < (g_ulFramePeriod - ulNext)))
+	{
+		ulIdle = g_ulFramePeriod - ulNext;
+	}
+
+	return(ulIdle);
+}
+
+//*****************************************************************************
+//
+//! Runs a frame if one is due, or reports how long to stay idle.
+//!
+//! \param ulTimeBudget is the time budget of the frame, as for
+//! Widget::MessageQueueProcess().
+//! \param ulPixelBudget is the pixel budget of the frame, as for
+//! Widget::MessageQueueProcess().
+//!
+//! This function is the frame scheduler of the widget framework, to be called
+//! from the main loop of the application instead of
+//! Widget::MessageQueueProcess().  If there is nothing to do yet (see
+//! Widget::IdleTimeGet()), it returns at once without touching the display,
+//! after calling the idle hook, if any (see Widget::IdleHookSet()).  Otherwise
+//! it runs a frame: the widget timers and animations are stepped, the messages
+//! are processed, and the damaged area is repainted and flushed, within the
+//! given budget.  Frames are never run closer than the frame period (see
+//! Widget::FramePeriodSet()), so that a burst of changes is repainted once, and
+//! a static screen costs nothing.
+//!
+//! \return Returns the number of milliseconds the application can sleep
+//! before calling this function again, zero if it should be called again at
+//! once, or \b #WIDGET_IDLE_FOREVER if it needs only be called once a message
+//! is posted.
+//
+//*****************************************************************************
+unsigned long
+Widget::FrameProcess(unsigned long ulTimeBudget, unsigned long ulPixelBudget)
+{
+	unsigned long ulIdle;
+
+	//
+	// See if a frame is due.
+	//
+	ulIdle = Widget::IdleTimeGet();
+
+	if(!ulIdle)
+	{
+		//
+		// Run the frame.  A paused repaint pass is part of the frame which
+		// started it, so it does not start a new frame period.
+		//
+		if(!Widget::pRepaintNext)
+		{
+			g_ulFrameTime = GrTimerGet();
+			g_bFrameRun = 1;
+		}
+
+		Widget::MessageQueueProcess(ulTimeBudget, ulPixelBudget);
+
+		ulIdle = Widget::IdleTimeGet();
+	}
+
+	//
+	// Report the idle time.
+	//
+	if(ulIdle && g_pfnIdleHook)
+	{
+		g_pfnIdleHook(ulIdle);
+	}
+
+	return(ulIdle);
+}
+
+//*****************************************************************************
+//
+//! Sets the shortest time between two frames.
+//!
+//! \param ulPeriod is the shortest time between two frames run by
+//! Widget::FrameProcess(), in milliseconds.
+//!
+//! This function caps the frame rate of the widget framework, which is
+//! \b WIDGET_FRAME_PERIOD milliseconds by default.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+Widget::FramePeriodSet(unsigned long ulPeriod)
+{
+	g_ulFramePeriod = ulPeriod;
+}
+
+//*****************************************************************************
+//
+//! Sets the function called when the widget framework is idle.
+//!
+//! \param pfnIdle is a pointer to the function to call, or zero for none.
+//!
+//! This function sets a hook called by Widget::FrameProcess() whenever there
+//! is nothing to do, with the number of milliseconds the widget framework can
+//! stay idle (or \b #WIDGET_IDLE_FOREVER).  The application can use it to put
+//! the processor into a low power mode, or to program a wake-up timer.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+Widget::IdleHookSet(void (*pfnIdle)(unsigned long ulIdleTime))
+{
+	g_pfnIdleHook = pfnIdle;
 }
 
 //*****************************************************************************
 //
 //! Destructor for a widget object.
 //!
-//! This function is a destructor for a widget object.
+//! This function is a destructor for a widget object.  If the widget has
+//! captured the pointer, the pointer is released, the coalescing rules set
+//! for the widget are removed, and the messages still queued for it are
+//! cancelled.
 //!
 //! \return None.
 //
 //*****************************************************************************
 Widget::~Widget(void)
 {
+	tMessageQueueItem sMessageQueueItem;
+	unsigned long ulIdx;
+
+	//
+	// Release the pointer if this widget has captured it.
+	//
+	if(Widget::pPointerWidget == this)
+	{
+		Widget::pPointerWidget = 0;
+	}
 
+	//
+	// Stop the auto-repeat events sent to this widget.
+	//
+	if(Widget::cAutoRepeatTimer.WidgetGet() == this)
+	{
+		Widget::AutoRepeatStop();
+	}
+
+	//
+	// The widget may be the next one to visit in a paused repaint pass.
+	//
+	if(Widget::pRepaintRoot == this)
+	{
+		Widget::pRepaintNext = 0;
+	}
+	Widget::RepaintRestart();
+
+	//
+	// Remove the coalescing rules set for this widget.
+	//
+	for(ulIdx = 0; ulIdx < WIDGET_COALESCE_RULES; ulIdx++)
+	{
+		if(g_psCoalesceRules[ulIdx].pWidget == this)
+		{
+			g_psCoalesceRules[ulIdx].ulMessage = 0;
+			g_psCoalesceRules[ulIdx].pWidget = 0;
+		}
+	}
+
+	//
+	// Cancel the messages still queued for this widget, before its memory is
+	// handed out to another widget.
+	//
+	sMessageQueueItem.pWidget = this;
+
+	for(ulIdx = 0; ulIdx < MSG_LANES; ulIdx++)
+	{
+		g_psMessageQueues[ulIdx].Update(&sMessageQueueItem, MessageCancel);
+	}
 }
 
 //*****************************************************************************
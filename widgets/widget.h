@@ -10,6 +10,10 @@
 #include "tree.h"
 #include "mqueue.h"
 #include "grlib.h"
+#include "widgettimer.h"
+#include "animation.h"
+#include "widgetarena.h"
+#include "widgetstyle.h"
 
 //*****************************************************************************
 //
@@ -29,6 +33,77 @@ extern "C"
 {
 #endif
 
+class HitIndex;
+
+//*****************************************************************************
+//
+//! This structure holds the counters of the widget message queue activity.
+//
+//*****************************************************************************
+typedef struct
+{
+    //
+    //! The number of messages added to the queue.
+    //
+    unsigned long ulPosted;
+
+    //
+    //! The number of messages merged into the last message of the queue
+    //! instead of being added.
+    //
+    unsigned long ulMerged;
+
+    //
+    //! The number of messages lost since the queue was full.
+    //
+    unsigned long ulDropped;
+}
+tMessageQueueStats;
+
+//*****************************************************************************
+//
+//! This structure describes a widget of a widget tree that is built from
+//! constant data, such as a static screen held in flash (see
+//! Widget::TreeCreate()).  An array of these structures lists the widgets of
+//! the tree in pre-order, each one with its depth in the tree, so that a
+//! widget is followed by its children.
+//
+//*****************************************************************************
+typedef struct
+{
+    //
+    //! The function that creates the widget; this is the Create() function of
+    //! the widget class, such as CanvasView::Create().
+    //
+    Widget *(*pfnCreate)(unsigned char ucID, Widget *pParent, long lX, long lY,
+                         long lWidth, long lHeight, const void *pvDesc);
+
+    //
+    //! The depth of the widget in the tree; the widgets of depth zero are
+    //! children of the widget the tree is created into.
+    //
+    unsigned char ucDepth;
+
+    //
+    //! The ID of the widget.
+    //
+    unsigned char ucID;
+
+    //
+    //! The position and size of the widget, relative to its parent.
+    //
+    short sX;
+    short sY;
+    short sWidth;
+    short sHeight;
+
+    //
+    //! A pointer to the constant description of the widget contents, whose
+    //! type depends on the widget class, such as tCanvasDesc.
+    //
+    const void *pvDesc;
+}
+tWidgetDesc;
 
 //*****************************************************************************
 //
@@ -44,6 +119,22 @@ public:
     //
 	Widget(unsigned char ucID, Widget *pParent, long lX, long lY, long lWidth, long lHeight);
 
+	//
+	//! Allocates the memory of a widget.
+	//
+	static void *operator new(size_t ulSize) throw();
+
+	//
+	//! Frees the memory of a widget.
+	//
+	static void operator delete(void *pvWidget);
+
+	//
+	//! Creates a widget tree from its constant description.
+	//
+	static Widget *TreeCreate(const tWidgetDesc *psDesc, unsigned long ulCount,
+	                          Widget *pParent);
+
 	//
 	//! Updates this widget and all his children.
 	//
@@ -59,6 +150,34 @@ public:
 	//
 	void Flush(void);
 
+	//
+	//! Marks an area of this widget as needing a repaint.
+	//
+	void Invalidate(const tRectangle *psRect = 0);
+
+	//
+	//! Sets the clipping region of a context used to draw a widget.
+	//
+	static void ClipRegionSet(tContext *pContext, const tRectangle *psRect);
+
+	//
+	//! Sets the display the widgets are drawn onto.
+	//
+	static void DisplaySet(const tDisplay *pDisplay);
+
+	//
+	//! Gets the display the widgets are drawn onto.
+	//
+	static const tDisplay *DisplayGet(void)
+	{
+		return(Widget::pDisplay);
+	}
+
+	//
+	//! Initializes a context used to draw a widget.
+	//
+	static void ContextInit(tContext *pContext);
+
 	//
 	//! Gets an absolute coordinates of this widget.
 	//
@@ -78,6 +197,22 @@ public:
 			                unsigned long ulParam2,
 			                unsigned long ulFlags);
 
+	//
+	//! Sets how messages posted to a widget are coalesced in the queue.
+	//
+	static long MessageCoalesceSet(unsigned long ulMessage, Widget *pWidget,
+	                               unsigned long ulPolicy);
+
+	//
+	//! Gets the counters of the widget message queue activity.
+	//
+	static void MessageQueueStatsGet(tMessageQueueStats *psStats);
+
+	//
+	//! Resets the counters of the widget message queue activity.
+	//
+	static void MessageQueueStatsReset(void);
+
 	//
 	//! Sends a message to a widget tree.
 	//
@@ -87,6 +222,33 @@ public:
 			                unsigned long ulParam2,
 			                unsigned long ulFlags);
 
+	//
+	//! Sets the messages this widget handles.
+	//
+	void MessageMaskSet(unsigned long ulMask);
+
+	//
+	//! Gets the messages this widget handles.
+	//
+	unsigned long MessageMaskGet(void)
+	{
+		return(this->ulMsgMask);
+	}
+
+	//
+	//! Finds the next widget of this tree that handles a message, in
+	//! pre-order.
+	//
+	Widget *SubscriberPreOrderSearch(Widget *pLastSearch,
+	                                 unsigned long ulMask);
+
+	//
+	//! Finds the next widget of this tree that handles a message, in
+	//! post-order.
+	//
+	Widget *SubscriberPostOrderSearch(Widget *pLastSearch,
+	                                  unsigned long ulMask);
+
 	//
 	//! Sends notification message to parent
 	//
@@ -98,6 +260,44 @@ public:
 	//
 	static void MessageQueueProcess(void);
 
+	//
+	//! Processes a message queue within a time and pixel budget.
+	//
+	static long MessageQueueProcess(unsigned long ulTimeBudget,
+	                                unsigned long ulPixelBudget);
+
+	//
+	//! Sets the clock used to measure the time budget of the message queue
+	//! processing.
+	//
+	static void ClockSet(unsigned long (*pfnClock)(void));
+
+	//
+	//! Determines if an area is waiting to be repainted.
+	//
+	static long RepaintPending(void);
+
+	//
+	//! Runs a frame if one is due, or reports how long to stay idle.
+	//
+	static unsigned long FrameProcess(unsigned long ulTimeBudget = 0,
+	                                  unsigned long ulPixelBudget = 0);
+
+	//
+	//! Sets the shortest time between two frames.
+	//
+	static void FramePeriodSet(unsigned long ulPeriod);
+
+	//
+	//! Gets the time the widget framework can stay idle.
+	//
+	static unsigned long IdleTimeGet(void);
+
+	//
+	//! Sets the function called when the widget framework is idle.
+	//
+	static void IdleHookSet(void (*pfnIdle)(unsigned long ulIdleTime));
+
     //
     //! The procedure that handles messages sent to this widget.
     //
@@ -110,21 +310,143 @@ public:
     //
 	virtual ~Widget(void);
 
+protected:
+	//
+	//! Invalidates the cached positions when this widget is reparented.
+	//
+	virtual void ParentChanged(void);
+
+	//
+	//! Starts the auto-repeat timer for this widget.
+	//
+	void AutoRepeatStart(unsigned long ulDelay, unsigned long ulPeriod);
+
+	//
+	//! Stops the auto-repeat timer.
+	//
+	static void AutoRepeatStop(void)
+	{
+		Widget::cAutoRepeatTimer.Stop();
+	}
+
+	//
+	//! Determines if a \b #WIDGET_MSG_TIMER message sent to this widget comes
+	//! from the auto-repeat timer.
+	//
+	long AutoRepeatIs(unsigned long ulParam1)
+	{
+		return(ulParam1 == (unsigned long)&Widget::cAutoRepeatTimer);
+	}
+
 private:
+    //
+    //! The messages this widget handles, as a set of WIDGET_MSG_MASK() bits.
+    //
+    unsigned long ulMsgMask;
+
+    //
+    //! The messages handled by this widget or any widget under it.  This may
+    //! hold extra bits for a while after a widget is moved to another parent,
+    //! which only costs a useless visit.
+    //
+    unsigned long ulTreeMsgMask;
+
+    //
+    //! The rectangle that encloses this widget, relative to its parent.
+    //
+    tRectangle sPosition;
+
+    //
+    //! The cached absolute position of the upper left corner of this widget.
+    //! Its size is that of sPosition.
+    //
+    tPoint sAbsOrigin;
+
 	//
 	//! An ID of this widget.
 	//
 	unsigned char ucID;
 
     //
-    //! The rectangle that encloses this widget.
+    //! Non-zero if sAbsOrigin is up to date.  A widget with an up to date
+    //! position always has a parent with an up to date position.
     //
-    tRectangle sPosition;
+    char bAbsPositionValid;
 
     //
-    //! The pointer to the message queue object.
+    //! The display the widgets are drawn onto.
     //
-    static MQueue *pMQueue;
+    static const tDisplay *pDisplay;
+
+    //
+    //! The pointer to the index used to find the widgets under the pointer.
+    //
+    static HitIndex *pHitIndex;
+
+    //
+    //! The widget that accepted the last pointer press, to which pointer moves
+    //! and releases are sent until the pointer is released.
+    //
+    static Widget *pPointerWidget;
+
+    //
+    //! The timer that generates the auto-repeat events of the widget that has
+    //! captured the pointer.  Only one widget can be pressed at a time, so a
+    //! single timer serves every widget.
+    //
+    static WidgetTimer cAutoRepeatTimer;
+
+    //
+    //! The absolute areas of the display that need a repaint.
+    //
+    static tDirtyRectSet sInvalidRects;
+
+    //
+    //! The area being repainted, or zero outside of a repaint pass.
+    //
+    static const tRectangle *psRepaintRegion;
+
+    //
+    //! The areas of the repaint pass in progress.
+    //
+    static tDirtyRectSet sRepaintRects;
+
+    //
+    //! The index in sRepaintRects of the area being repainted.
+    //
+    static unsigned long ulRepaintRect;
+
+    //
+    //! The root of the widget tree of the repaint pass in progress.
+    //
+    static Widget *pRepaintRoot;
+
+    //
+    //! The next widget to visit in the repaint pass in progress, or zero if
+    //! no repaint pass is in progress.
+    //
+    static Tree *pRepaintNext;
+
+	//
+	//! Repaints the widgets that intersect the invalid areas.
+	//
+	static long Repaint(void);
+
+	//
+	//! Restarts the repaint pass in progress, if any.
+	//
+	static void RepaintRestart(void);
+
+	//
+	//! Invalidates the cached absolute positions of this widget tree.
+	//
+	void AbsolutePositionInvalidate(void);
+
+	//
+	//! Updates the messages handled by the widget trees this widget is part
+	//! of.
+	//
+	void MessageMaskUpdate(void);
 
 	//
 	//! Sends a message to a widget tree via a pre-order, depth-first search.
@@ -156,6 +478,81 @@ private:
 #define MSG_FLAG_STOP_ON_SUCCESS    0x00000002
 #define MSG_FLAG_STOP_ON_FIRST      0x00000004
 
+//*****************************************************************************
+//
+// The bit of a message in the set of messages a widget handles (see
+// Widget::MessageMaskSet()).  The messages above 30 share the top bit.
+//
+//*****************************************************************************
+#define WIDGET_MSG_MASK(ulMessage)                                            \
+        (((ulMessage) < 31) ? (1UL << (ulMessage)) : 0x80000000)
+
+//*****************************************************************************
+//
+// The set of messages of a widget that handles every message, which is the
+// default.
+//
+//*****************************************************************************
+#define WIDGET_MSG_MASK_ALL         0xffffffff
+
+//*****************************************************************************
+//
+// Policies that tell how a posted message is coalesced with the last message
+// of the queue, when that one is the same message sent to the same widget with
+// the same flags (see Widget::MessageCoalesceSet()).  With
+// MSG_COALESCE_LATEST the new message replaces the queued one, which suits
+// messages that carry a value where only the latest one matters.  With
+// MSG_COALESCE_RECT the parameters of both messages are a rectangle, whose
+// upper left corner is in ulParam1 and lower right corner is in ulParam2
+// (packed with MSG_PARAM_POINT()), and the queued message is grown to the
+// bounding box of both; a message whose parameters are both zero stands for
+// the whole area and absorbs the other one.
+//
+//*****************************************************************************
+#define MSG_COALESCE_NONE           0x00000000
+#define MSG_COALESCE_LATEST         0x00000001
+#define MSG_COALESCE_RECT           0x00000002
+
+//*****************************************************************************
+//
+// The value returned by Widget::IdleTimeGet() and Widget::FrameProcess() when
+// the widget framework has nothing to do until the next message is posted.
+//
+//*****************************************************************************
+#define WIDGET_IDLE_FOREVER         0xffffffff
+
+//*****************************************************************************
+//
+// The greatest depth of a widget tree created by Widget::TreeCreate().
+//
+//*****************************************************************************
+#ifndef WIDGET_DESC_DEPTH
+#define WIDGET_DESC_DEPTH           8
+#endif
+
+//*****************************************************************************
+//
+// Declares the constant description of a widget of a widget tree (see
+// tWidgetDesc).  The widget classes define shorter forms of this macro, such
+// as CANVAS_DESC().
+//
+//*****************************************************************************
+#define WIDGET_DESC(pfnCreate, ucDepth, ucID, lX, lY, lWidth, lHeight,       \
+                    pvDesc)                                                  \
+        { (pfnCreate), (ucDepth), (ucID), (lX), (lY), (lWidth), (lHeight),   \
+          (pvDesc) }
+
+//*****************************************************************************
+//
+// Macros that pack a point into a message parameter, and unpack it.
+//
+//*****************************************************************************
+#define MSG_PARAM_POINT(lX, lY)                                              \
+        ((((unsigned long)(lY) & 0xffff) << 16) |                            \
+         ((unsigned long)(lX) & 0xffff))
+#define MSG_PARAM_X(ulParam)        ((long)(short)((ulParam) & 0xffff))
+#define MSG_PARAM_Y(ulParam)        ((long)(short)((ulParam) >> 16))
+
 //*****************************************************************************
 //
 // Prototypes for the generic widget handling functions.
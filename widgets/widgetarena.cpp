@@ -0,0 +1,319 @@
+//*****************************************************************************
+//
+// widgetarena.cpp - Widget memory arenas.
+//
+//*****************************************************************************
+
+#include "debug.h"
+#include "grlib.h"
+#include "widgetarena.h"
+
+//*****************************************************************************
+//
+//! \addtogroup widget_api
+//! @{
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+//! The list of arenas.
+//
+//*****************************************************************************
+WidgetArena *WidgetArena::pFirst = 0;
+
+//*****************************************************************************
+//
+//! The arena new widgets are allocated from, or zero for the heap.
+//
+//*****************************************************************************
+WidgetArena *WidgetArena::pSelected = 0;
+
+#ifdef WIDGET_NO_HEAP
+//*****************************************************************************
+//
+// The memory of the arena used in place of the heap.
+//
+//*****************************************************************************
+static unsigned char g_pucHeap[WIDGET_HEAP_SIZE + WIDGET_ARENA_ALIGN];
+
+//*****************************************************************************
+//
+// Gets the arena used in place of the heap, when no other arena is selected.
+// It is a pool of blocks that are reused one by one, since the root of the
+// widget tree is usually allocated from it and is never destroyed.  The arena
+// is built on first use, so that widgets created by the constructors of other
+// static objects find it ready whatever the order of the static constructors.
+//
+//*****************************************************************************
+static WidgetArena *
+HeapArenaGet(void)
+{
+	static WidgetArena sHeapArena(g_pucHeap, sizeof(g_pucHeap),
+	                              WIDGET_HEAP_BLOCK_SIZE);
+
+	return(&sHeapArena);
+}
+#endif
+
+//*****************************************************************************
+//
+//! Constructs an arena.
+//!
+//! \param pvBuffer is a pointer to the memory of the arena.
+//! \param ulSize is the size of the memory of the arena, in bytes.
+//! \param ulBlockSize is the size of the blocks of a pool, in bytes, or zero
+//! to hand out blocks of any size one after the other.
+//!
+//! This function constructs an empty arena over the given memory, which must
+//! stay valid as long as the arena exists.  If \e ulBlockSize is not zero, the
+//! memory is cut into blocks of that size, which are kept on a free list and
+//! reused as soon as they are freed.
+//!
+//! \return None.
+//
+//*****************************************************************************
+WidgetArena::WidgetArena(void *pvBuffer, unsigned long ulSize,
+                         unsigned long ulBlockSize)
+{
+	unsigned long ulSkip, ulOffset;
+
+	//
+	// Align the start of the buffer.
+	//
+	ulSkip = (WIDGET_ARENA_ALIGN -
+	          ((unsigned long)pvBuffer & (WIDGET_ARENA_ALIGN - 1))) &
+	         (WIDGET_ARENA_ALIGN - 1);
+
+	if(ulSkip > ulSize)
+	{
+		ulSkip = ulSize;
+	}
+
+	this->pucBuffer = (unsigned char *)pvBuffer + ulSkip;
+	this->ulSize    = ulSize - ulSkip;
+	this->ulUsed    = 0;
+	this->ulCount   = 0;
+	this->pvFree    = 0;
+
+	//
+	// Cut the memory of a pool into blocks, and chain them on the free list
+	// in address order.
+	//
+	this->ulBlockSize = ((ulBlockSize + WIDGET_ARENA_ALIGN - 1) &
+	                     ~(WIDGET_ARENA_ALIGN - 1));
+
+	if(this->ulBlockSize)
+	{
+		for(ulOffset = this->ulSize - (this->ulSize % this->ulBlockSize);
+		    ulOffset >= this->ulBlockSize; ulOffset -= this->ulBlockSize)
+		{
+			*(void **)(this->pucBuffer + ulOffset - this->ulBlockSize) =
+				this->pvFree;
+			this->pvFree = this->pucBuffer + ulOffset - this->ulBlockSize;
+		}
+	}
+
+	//
+	// Add this arena to the list of arenas.
+	//
+	this->pNext = WidgetArena::pFirst;
+	WidgetArena::pFirst = this;
+}
+
+//*****************************************************************************
+//
+//! Allocates a block from this arena.
+//!
+//! \param ulSize is the size of the block, in bytes.
+//!
+//! \return Returns a pointer to the block, or zero if the arena is full or,
+//! for a pool, if the block is larger than the blocks of the pool.
+//
+//*****************************************************************************
+void *
+WidgetArena::Alloc(size_t ulSize)
+{
+	unsigned char *pucBlock;
+
+	//
+	// Take the first block of the free list of a pool.
+	//
+	if(this->ulBlockSize)
+	{
+		ASSERT(ulSize <= this->ulBlockSize);
+
+		if((ulSize > this->ulBlockSize) || !this->pvFree)
+		{
+			return(0);
+		}
+
+		pucBlock = (unsigned char *)this->pvFree;
+		this->pvFree = *(void **)pucBlock;
+
+		this->ulUsed += this->ulBlockSize;
+		this->ulCount++;
+
+		return(pucBlock);
+	}
+
+	ulSize = (ulSize + WIDGET_ARENA_ALIGN - 1) & ~(WIDGET_ARENA_ALIGN - 1);
+
+	if(ulSize > (this->ulSize - this->ulUsed))
+	{
+		return(0);
+	}
+
+	pucBlock = this->pucBuffer + this->ulUsed;
+
+	this->ulUsed += ulSize;
+	this->ulCount++;
+
+	return(pucBlock);
+}
+
+//*****************************************************************************
+//
+//! Frees a block allocated from this arena.
+//!
+//! \param pvBlock is a pointer to the block.
+//!
+//! A block of a pool goes back on its free list at once.  Otherwise, this
+//! function only counts the block as free, and once every block of the arena
+//! is free, the whole arena is emptied at once.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+WidgetArena::Free(void *pvBlock)
+{
+	if(this->ulBlockSize)
+	{
+		*(void **)pvBlock = this->pvFree;
+		this->pvFree = pvBlock;
+
+		this->ulUsed -= this->ulBlockSize;
+		this->ulCount--;
+
+		return;
+	}
+
+	if(this->ulCount && !--this->ulCount)
+	{
+		this->ulUsed = 0;
+	}
+}
+
+//*****************************************************************************
+//
+//! Selects the arena new widgets are allocated from.
+//!
+//! \param pArena is a pointer to the arena, or zero for the default one.
+//!
+//! This function selects the arena used by the widgets created from now on.
+//! The default is the heap or, if the library is built with
+//! \b WIDGET_NO_HEAP defined, an arena of \b WIDGET_HEAP_SIZE bytes.
+//!
+//! \return Returns a pointer to the arena previously selected, so that it can
+//! be selected again.
+//
+//*****************************************************************************
+WidgetArena *
+WidgetArena::Select(WidgetArena *pArena)
+{
+	WidgetArena *pPrevious;
+
+	pPrevious = WidgetArena::pSelected;
+
+#ifdef WIDGET_NO_HEAP
+	WidgetArena::pSelected = pArena ? pArena : HeapArenaGet();
+#else
+	WidgetArena::pSelected = pArena;
+#endif
+
+	return(pPrevious);
+}
+
+//*****************************************************************************
+//
+//! Gets the arena new widgets are allocated from.
+//!
+//! \return Returns a pointer to the selected arena, or zero for the heap.
+//
+//*****************************************************************************
+WidgetArena *
+WidgetArena::SelectedGet(void)
+{
+#ifdef WIDGET_NO_HEAP
+	if(!WidgetArena::pSelected)
+	{
+		WidgetArena::pSelected = HeapArenaGet();
+	}
+#endif
+
+	return(WidgetArena::pSelected);
+}
+
+//*****************************************************************************
+//
+//! Finds the arena a block belongs to.
+//!
+//! \param pvBlock is a pointer to the block.
+//!
+//! \return Returns a pointer to the arena, or zero if the block was allocated
+//! from the heap.
+//
+//*****************************************************************************
+WidgetArena *
+WidgetArena::Find(const void *pvBlock)
+{
+	WidgetArena *pArena;
+
+	for(pArena = WidgetArena::pFirst; pArena; pArena = pArena->pNext)
+	{
+		if(pArena->Contains(pvBlock))
+		{
+			break;
+		}
+	}
+
+	return(pArena);
+}
+
+//*****************************************************************************
+//
+//! Destroys an arena.
+//!
+//! This function removes the arena from the list of arenas.  The widgets
+//! allocated from it must have been destroyed first.
+//!
+//! \return None.
+//
+//*****************************************************************************
+WidgetArena::~WidgetArena(void)
+{
+	WidgetArena **ppArena;
+
+	for(ppArena = &WidgetArena::pFirst; *ppArena;
+	    ppArena = &(*ppArena)->pNext)
+	{
+		if(*ppArena == this)
+		{
+			*ppArena = this->pNext;
+			break;
+		}
+	}
+
+	if(WidgetArena::pSelected == this)
+	{
+		WidgetArena::pSelected = 0;
+	}
+}
+
+//*****************************************************************************
+//
+// Close the Doxygen group.
+//! @}
+//
+//*****************************************************************************
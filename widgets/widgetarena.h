@@ -0,0 +1,204 @@
+//*****************************************************************************
+//
+// widgetarena.h - Prototypes for the widget memory arenas.
+//
+//*****************************************************************************
+
+#ifndef __WIDGETARENA_H__
+#define __WIDGETARENA_H__
+
+#include <stddef.h>
+
+//*****************************************************************************
+//
+//! \addtogroup widget_api
+//! @{
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// If building with a C++ compiler, make all of the definitions in this header
+// have a C binding.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+//! The alignment of the blocks allocated from an arena, in bytes.
+//
+//*****************************************************************************
+#define WIDGET_ARENA_ALIGN      8
+
+//*****************************************************************************
+//
+//! The size of the arena widgets are allocated from when the library is built
+//! with \b WIDGET_NO_HEAP defined and no other arena is selected, in bytes.
+//! In this mode the library never uses the heap.
+//
+//*****************************************************************************
+#ifndef WIDGET_HEAP_SIZE
+#define WIDGET_HEAP_SIZE        4096
+#endif
+
+//*****************************************************************************
+//
+//! The size of the blocks of the arena widgets are allocated from when the
+//! library is built with \b WIDGET_NO_HEAP defined and no other arena is
+//! selected, in bytes.  It must be at least the size of the largest widget
+//! class the application creates.
+//
+//*****************************************************************************
+#ifndef WIDGET_HEAP_BLOCK_SIZE
+#define WIDGET_HEAP_BLOCK_SIZE  128
+#endif
+
+//*****************************************************************************
+//
+//! This class describes a memory arena that widgets are allocated from.
+//!
+//! An arena hands out blocks from a buffer given by the application, one
+//! after the other, and counts the blocks in use.  Blocks are not reused one
+//! by one; once the last one is freed, the whole buffer is free again.  This
+//! suits a screen whose widgets are all created when it is shown and
+//! destroyed together with Widget::Destroy() when it is left: the screen
+//! always gets the same memory back, and leaves no holes behind it, so the
+//! heap does not fragment over time.
+//!
+//! An arena may instead be built as a pool of blocks of a fixed size, which
+//! are kept on a free list and reused one by one.  Such an arena never needs
+//! to be emptied as a whole, so it suits widgets that outlive the screens,
+//! like the root of the tree; the arena used in place of the heap when the
+//! library is built with \b WIDGET_NO_HEAP defined is one.
+//!
+//! Widgets are allocated from the arena selected with WidgetArena::Select()
+//! when they are created.
+//
+//*****************************************************************************
+class WidgetArena
+{
+public:
+	//
+	//! Constructor.
+	//
+	WidgetArena(void *pvBuffer, unsigned long ulSize,
+	            unsigned long ulBlockSize = 0);
+
+	//
+	//! Allocates a block from this arena.
+	//
+	void *Alloc(size_t ulSize);
+
+	//
+	//! Frees a block allocated from this arena.
+	//
+	void Free(void *pvBlock);
+
+	//
+	//! Determines if a block belongs to this arena.
+	//
+	long Contains(const void *pvBlock)
+	{
+		return(((const unsigned char *)pvBlock >= this->pucBuffer) &&
+		       ((const unsigned char *)pvBlock <
+		        (this->pucBuffer + this->ulSize)));
+	}
+
+	//
+	//! Gets the number of bytes in use.
+	//
+	unsigned long UsedGet(void)
+	{
+		return(this->ulUsed);
+	}
+
+	//
+	//! Selects the arena new widgets are allocated from.
+	//
+	static WidgetArena *Select(WidgetArena *pArena);
+
+	//
+	//! Gets the arena new widgets are allocated from.
+	//
+	static WidgetArena *SelectedGet(void);
+
+	//
+	//! Finds the arena a block belongs to.
+	//
+	static WidgetArena *Find(const void *pvBlock);
+
+	//
+	//! Destructor.
+	//
+	~WidgetArena(void);
+
+private:
+	//
+	//! The buffer of this arena.
+	//
+	unsigned char *pucBuffer;
+
+	//
+	//! The size of the buffer.
+	//
+	unsigned long ulSize;
+
+	//
+	//! The number of bytes handed out since the arena was last empty, or the
+	//! number of bytes of the blocks in use in a pool.
+	//
+	unsigned long ulUsed;
+
+	//
+	//! The number of blocks in use.
+	//
+	unsigned long ulCount;
+
+	//
+	//! The size of the blocks of a pool, or zero if blocks are handed out one
+	//! after the other.
+	//
+	unsigned long ulBlockSize;
+
+	//
+	//! The list of free blocks of a pool.
+	//
+	void *pvFree;
+
+	//
+	//! The next arena in the list of arenas.
+	//
+	WidgetArena *pNext;
+
+	//
+	//! The list of arenas.
+	//
+	static WidgetArena *pFirst;
+
+	//
+	//! The arena new widgets are allocated from, or zero for the heap.
+	//
+	static WidgetArena *pSelected;
+};
+
+//*****************************************************************************
+//
+// Mark the end of the C bindings section for C++ compilers.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+}
+#endif
+
+//*****************************************************************************
+//
+// Close the Doxygen group.
+//! @}
+//
+//*****************************************************************************
+
+#endif // __WIDGETARENA_H__
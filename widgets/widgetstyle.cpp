@@ -0,0 +1,168 @@
+//*****************************************************************************
+//
+// widgetstyle.cpp - Shared widget styles.
+//
+//*****************************************************************************
+
+#include "debug.h"
+#include "grlib.h"
+#include "widgetstyle.h"
+
+//*****************************************************************************
+//
+//! \addtogroup widget_api
+//! @{
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// The adjustments, in percent, that give the shades of a fill color.
+//
+//*****************************************************************************
+static const short g_psShadeAdjust[WIDGET_STYLE_SHADES] =
+{
+	0, 30, -15, -50
+};
+
+//*****************************************************************************
+//
+//! Translates the shades of a fill color.
+//!
+//! \param pDisplay is a pointer to the display the shades are translated for.
+//! \param pulShades is a pointer to the array that receives the shades.
+//! \param ulColor is the 24-bit RGB fill color.
+//! \param ulCount is the number of shades to translate, starting with the
+//! base shade.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void
+WidgetStyleShadesSet(const tDisplay *pDisplay, unsigned long *pulShades,
+                     unsigned long ulColor, unsigned long ulCount)
+{
+	unsigned long ulIdx;
+	long lColor;
+
+	for(ulIdx = 0; ulIdx < ulCount; ulIdx++)
+	{
+		lColor = ulColor;
+
+		if(g_psShadeAdjust[ulIdx])
+		{
+			ColorValueAdjust(&lColor, g_psShadeAdjust[ulIdx]);
+		}
+
+		pulShades[ulIdx] = DpyColorTranslate(pDisplay, lColor);
+	}
+}
+
+//*****************************************************************************
+//
+//! Constructs a widget style.
+//!
+//! This function constructs an empty style, whose colors must be set with
+//! WidgetStyle::Set() before any widget is drawn with it.
+//!
+//! \return None.
+//
+//*****************************************************************************
+WidgetStyle::WidgetStyle(void)
+{
+	unsigned long ulIdx;
+
+	this->ulFillColor      = 0;
+	this->ulPressFillColor = 0;
+
+	for(ulIdx = 0; ulIdx < WIDGET_STYLE_SHADES; ulIdx++)
+	{
+		this->pulFill[ulIdx]      = 0;
+		this->pulPressFill[ulIdx] = 0;
+	}
+
+	this->ulOutline      = 0;
+	this->ulText         = 0;
+	this->ulDisabledText = 0;
+	this->pFont          = 0;
+	this->lFontHeight    = 0;
+}
+
+//*****************************************************************************
+//
+//! Sets the colors and the font of this style.
+//!
+//! \param pDisplay is a pointer to the display the colors are translated for.
+//! \param ulFillColor is the 24-bit RGB fill color.
+//! \param ulPressFillColor is the 24-bit RGB fill color of a pressed button.
+//! \param ulOutlineColor is the 24-bit RGB outline color.
+//! \param ulTextColor is the 24-bit RGB text color.
+//! \param pFont is a pointer to the font of the text, or zero if there is no
+//! text.
+//! \param ulUse is the set of colors to translate, as a set of
+//! WIDGET_STYLE_USE_xxx flags; all of them by default.
+//!
+//! This function translates the colors to the format of \e pDisplay, computes
+//! the shades of the fill colors, and reads the metrics of the font.  It must
+//! be called once the display is initialized, and again if the widgets are
+//! drawn onto another display; the widgets drawn with this style must then be
+//! repainted.
+//!
+//! A widget without a style calls this function on each paint, with only the
+//! colors that the paint uses in \e ulUse, so that it does not pay for the
+//! others; the other colors of the style are left as they are.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+WidgetStyle::Set(const tDisplay *pDisplay, unsigned long ulFillColor,
+                 unsigned long ulPressFillColor, unsigned long ulOutlineColor,
+                 unsigned long ulTextColor, const tFont *pFont,
+                 unsigned long ulUse)
+{
+	unsigned long ulShades;
+
+	ASSERT(pDisplay);
+
+	this->ulFillColor      = ulFillColor;
+	this->ulPressFillColor = ulPressFillColor;
+
+	ulShades = (ulUse & WIDGET_STYLE_USE_SHADES) ? WIDGET_STYLE_SHADES : 1;
+
+	if(ulUse & WIDGET_STYLE_USE_FILL)
+	{
+		WidgetStyleShadesSet(pDisplay, this->pulFill, ulFillColor, ulShades);
+	}
+
+	if(ulUse & WIDGET_STYLE_USE_PRESS_FILL)
+	{
+		WidgetStyleShadesSet(pDisplay, this->pulPressFill, ulPressFillColor,
+		                     ulShades);
+	}
+
+	if(ulUse & WIDGET_STYLE_USE_OUTLINE)
+	{
+		this->ulOutline = DpyColorTranslate(pDisplay, ulOutlineColor);
+	}
+
+	if(ulUse & WIDGET_STYLE_USE_TEXT)
+	{
+		this->ulText = DpyColorTranslate(pDisplay, ulTextColor);
+	}
+
+	if(ulUse & WIDGET_STYLE_USE_DISABLED)
+	{
+		this->ulDisabledText = DpyColorTranslate(pDisplay, ClrGray);
+	}
+
+	this->pFont       = pFont;
+	this->lFontHeight = pFont ? GrFontHeightGet(pFont) : 0;
+}
+
+//*****************************************************************************
+//
+// Close the Doxygen group.
+//! @}
+//
+//*****************************************************************************
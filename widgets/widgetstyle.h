@@ -0,0 +1,142 @@
+//*****************************************************************************
+//
+// widgetstyle.h - Prototypes for the shared widget styles.
+//
+//*****************************************************************************
+
+#ifndef __WIDGETSTYLE_H__
+#define __WIDGETSTYLE_H__
+
+#include "grlib.h"
+
+//*****************************************************************************
+//
+//! \addtogroup widget_api
+//! @{
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// If building with a C++ compiler, make all of the definitions in this header
+// have a C binding.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+//! The shades of the fill colors held by a style, used to draw the bevelled
+//! edges of the widgets: the fill color itself, lightened by 30%, darkened by
+//! 15%, and darkened by 50%.
+//
+//*****************************************************************************
+#define WIDGET_STYLE_SHADE_BASE     0
+#define WIDGET_STYLE_SHADE_LIGHT    1
+#define WIDGET_STYLE_SHADE_DARK     2
+#define WIDGET_STYLE_SHADE_DARKER   3
+#define WIDGET_STYLE_SHADES         4
+
+//*****************************************************************************
+//
+//! The colors of a style translated by WidgetStyle::Set(): the base shade of
+//! the fill color and of the pressed fill color, their other shades, the
+//! outline color, the text color, and the text color of a disabled widget.
+//! A widget that has no style translates only the colors a paint uses.
+//
+//*****************************************************************************
+#define WIDGET_STYLE_USE_FILL       0x00000001
+#define WIDGET_STYLE_USE_PRESS_FILL 0x00000002
+#define WIDGET_STYLE_USE_SHADES     0x00000004
+#define WIDGET_STYLE_USE_OUTLINE    0x00000008
+#define WIDGET_STYLE_USE_TEXT       0x00000010
+#define WIDGET_STYLE_USE_DISABLED   0x00000020
+#define WIDGET_STYLE_USE_ALL        0x0000003f
+
+//*****************************************************************************
+//
+//! This class describes a style, which holds the colors and the font that any
+//! number of widgets are drawn with.
+//!
+//! The colors of a style are translated to the format of a display, and the
+//! shades of its fill colors derived, once, when they are set with
+//! WidgetStyle::Set(), rather than on each paint of each widget.  A style
+//! must be set for the display its widgets are drawn onto (see
+//! Widget::DisplaySet()).  A widget
+//! uses a style when its description points to it; the colors and font of the
+//! description are then ignored.
+//
+//*****************************************************************************
+class WidgetStyle
+{
+public:
+	//
+	//! Constructor.
+	//
+	WidgetStyle(void);
+
+	//
+	//! Sets the colors and the font of this style.
+	//
+	void Set(const tDisplay *pDisplay, unsigned long ulFillColor,
+	         unsigned long ulPressFillColor, unsigned long ulOutlineColor,
+	         unsigned long ulTextColor, const tFont *pFont,
+	         unsigned long ulUse = WIDGET_STYLE_USE_ALL);
+
+	//
+	//! The fill color and the pressed fill color, as 24-bit RGB colors, for
+	//! the gradients.
+	//
+	unsigned long ulFillColor;
+	unsigned long ulPressFillColor;
+
+	//
+	//! The shades of the fill color and of the pressed fill color, translated
+	//! to the format of the display, indexed by WIDGET_STYLE_SHADE_xxx.
+	//
+	unsigned long pulFill[WIDGET_STYLE_SHADES];
+	unsigned long pulPressFill[WIDGET_STYLE_SHADES];
+
+	//
+	//! The outline color, translated to the format of the display.
+	//
+	unsigned long ulOutline;
+
+	//
+	//! The text color, and the text color of a disabled widget, translated to
+	//! the format of the display.
+	//
+	unsigned long ulText;
+	unsigned long ulDisabledText;
+
+	//
+	//! The font of the text.
+	//
+	const tFont *pFont;
+
+	//
+	//! The height of the font, in pixels.
+	//
+	long lFontHeight;
+};
+
+//*****************************************************************************
+//
+// Mark the end of the C bindings section for C++ compilers.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+}
+#endif
+
+//*****************************************************************************
+//
+// Close the Doxygen group.
+//! @}
+//
+//*****************************************************************************
+
+#endif // __WIDGETSTYLE_H__
@@ -0,0 +1,420 @@
+//*****************************************************************************
+//
+// widgettimer.cpp - Widget timers.
+//
+//*****************************************************************************
+
+#include "grlib.h"
+#include "widget.h"
+#include "widgettimer.h"
+
+//*****************************************************************************
+//
+//! \addtogroup widget_api
+//! @{
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// The number of slots of each level of the timer wheel, and the mask that
+// gives a slot from a time.
+//
+//*****************************************************************************
+#define WIDGET_TIMER_SLOTS      (1 << WIDGET_TIMER_LEVEL_BITS)
+#define WIDGET_TIMER_SLOT_MASK  (WIDGET_TIMER_SLOTS - 1)
+
+//*****************************************************************************
+//
+// The number of ticks covered by the whole timer wheel.
+//
+//*****************************************************************************
+#define WIDGET_TIMER_SPAN                                                     \
+        (1UL << (WIDGET_TIMER_LEVEL_BITS * WIDGET_TIMER_LEVELS))
+
+//*****************************************************************************
+//
+//! The slots of the timer wheel.
+//
+//*****************************************************************************
+WidgetTimer *WidgetTimer::ppSlots[WIDGET_TIMER_LEVELS][WIDGET_TIMER_SLOTS];
+
+//*****************************************************************************
+//
+//! The time up to which the timers have been run.
+//
+//*****************************************************************************
+unsigned long WidgetTimer::ulNow;
+
+//*****************************************************************************
+//
+//! The number of running timers.
+//
+//*****************************************************************************
+unsigned long WidgetTimer::ulCount;
+
+//*****************************************************************************
+//
+//! Constructs a widget timer.
+//!
+//! This function constructs a stopped widget timer.
+//!
+//! \return None.
+//
+//*****************************************************************************
+WidgetTimer::WidgetTimer(void)
+{
+	this->pNext    = 0;
+	this->ppPrev   = 0;
+	this->pWidget  = 0;
+	this->ulExpiry = 0;
+	this->ulPeriod = 0;
+}
+
+//*****************************************************************************
+//
+//! Files this timer in the slot of its expiry time.
+//!
+//! This function adds this timer to the timer wheel.  A timer due within
+//! 2^WIDGET_TIMER_LEVEL_BITS ticks goes to the first level, whose slots are
+//! one tick long; a timer due later goes to the level whose slots are just
+//! short enough, and moves to the lower levels as its time comes closer.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+WidgetTimer::Insert(void)
+{
+	unsigned long ulDelta, ulTime, ulLevel;
+	WidgetTimer **ppSlot;
+
+	//
+	// Find the level of this timer.
+	//
+	ulDelta = this->ulExpiry - WidgetTimer::ulNow;
+	ulTime = this->ulExpiry;
+
+	for(ulLevel = 0; ulLevel < (WIDGET_TIMER_LEVELS - 1); ulLevel++)
+	{
+		if(ulDelta < (1UL << (WIDGET_TIMER_LEVEL_BITS * (ulLevel + 1))))
+		{
+			break;
+		}
+	}
+
+	//
+	// A timer beyond the span of the wheel goes to the last slot of the top
+	// level, and is filed again when that slot is reached.
+	//
+	if(ulDelta >= WIDGET_TIMER_SPAN)
+	{
+		ulTime = WidgetTimer::ulNow + WIDGET_TIMER_SPAN - 1;
+	}
+
+	ppSlot = &WidgetTimer::ppSlots[ulLevel]
+	                              [(ulTime >> (WIDGET_TIMER_LEVEL_BITS *
+	                                           ulLevel)) &
+	                               WIDGET_TIMER_SLOT_MASK];
+
+	//
+	// Add this timer at the head of the slot.
+	//
+	this->pNext = *ppSlot;
+	if(this->pNext)
+	{
+		this->pNext->ppPrev = &this->pNext;
+	}
+	this->ppPrev = ppSlot;
+	*ppSlot = this;
+
+	WidgetTimer::ulCount++;
+}
+
+//*****************************************************************************
+//
+//! Removes this timer from its slot.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+WidgetTimer::Remove(void)
+{
+	*this->ppPrev = this->pNext;
+	if(this->pNext)
+	{
+		this->pNext->ppPrev = this->ppPrev;
+	}
+
+	this->pNext = 0;
+	this->ppPrev = 0;
+
+	WidgetTimer::ulCount--;
+}
+
+//*****************************************************************************
+//
+//! Starts this timer.
+//!
+//! \param pWidget is a pointer to the widget to which the \b #WIDGET_MSG_TIMER
+//! message is sent.
+//! \param ulDelay is the number of ticks of GrTimerGet() before the first
+//! expiry.
+//! \param ulPeriod is the number of ticks between two expiries after the first
+//! one, or zero for a one-shot timer.
+//!
+//! This function starts this timer, or restarts it if it is running.  When the
+//! timer expires, WidgetTimer::Process() sends \b #WIDGET_MSG_TIMER to
+//! \e pWidget, with a pointer to this timer in \e ulParam1.
+//!
+//! This function must be called from the same context as
+//! Widget::MessageQueueProcess().
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+WidgetTimer::Start(Widget *pWidget, unsigned long ulDelay,
+                   unsigned long ulPeriod)
+{
+	if(this->ppPrev)
+	{
+		this->Remove();
+	}
+
+	//
+	// Bring the wheel up to date if it is empty, since it is not stepped
+	// while no timer is running.
+	//
+	if(!WidgetTimer::ulCount)
+	{
+		WidgetTimer::ulNow = GrTimerGet();
+	}
+
+	this->pWidget  = pWidget;
+	this->ulPeriod = ulPeriod;
+	this->ulExpiry = GrTimerGet() + (ulDelay ? ulDelay : 1);
+
+	this->Insert();
+}
+
+//*****************************************************************************
+//
+//! Stops this timer.
+//!
+//! This function stops this timer, if it is running.  The timer will not send
+//! any more messages.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+WidgetTimer::Stop(void)
+{
+	if(this->ppPrev)
+	{
+		this->Remove();
+	}
+}
+
+//*****************************************************************************
+//
+//! Runs the timers that have expired.
+//!
+//! This function steps the timer wheel up to the current value of
+//! GrTimerGet(), jumping from one slot that holds timers to the next, and
+//! sends a \b #WIDGET_MSG_TIMER message to the widget of
+//! every timer that has expired.  A periodic timer is started again for its
+//! next expiry; expiries missed because this function was not called in time
+//! are skipped rather than sent in a burst.  The message is sent directly
+//! rather than posted, so that a timer that has been stopped, or whose widget
+//! has been destroyed, never sends a late message.
+//!
+//! It is called by Widget::MessageQueueProcess().
+//!
+//! \return None.
+//
+//*****************************************************************************
+void
+WidgetTimer::Process(void)
+{
+	unsigned long ulTarget, ulStep, ulLevel, ulSlot;
+	WidgetTimer *pTimer;
+
+	ulTarget = GrTimerGet();
+
+	while(WidgetTimer::ulNow != ulTarget)
+	{
+		//
+		// Jump straight to the next tick that has a slot to process, or to
+		// the current time if there is none before it.  The ticks in between
+		// have nothing to run or to file again.
+		//
+		ulStep = WidgetTimer::NextEventGet();
+
+		if(ulStep > (ulTarget - WidgetTimer::ulNow))
+		{
+			WidgetTimer::ulNow = ulTarget;
+			break;
+		}
+
+		WidgetTimer::ulNow += ulStep;
+
+		//
+		// Each time a level wraps around, the timers of the next slot of the
+		// level above are filed again, into the lower levels.
+		//
+		for(ulLevel = 1; ulLevel < WIDGET_TIMER_LEVELS; ulLevel++)
+		{
+			if(WidgetTimer::ulNow &
+			   ((1UL << (WIDGET_TIMER_LEVEL_BITS * ulLevel)) - 1))
+			{
+				break;
+			}
+
+			ulSlot = ((WidgetTimer::ulNow >>
+			           (WIDGET_TIMER_LEVEL_BITS * ulLevel)) &
+			          WIDGET_TIMER_SLOT_MASK);
+
+			while((pTimer = WidgetTimer::ppSlots[ulLevel][ulSlot]) != 0)
+			{
+				pTimer->Remove();
+				pTimer->Insert();
+			}
+		}
+
+		//
+		// Run the timers of the current slot of the first level.  The widget
+		// may start or stop any timer, or be destroyed along with its timers,
+		// so the slot is read again after each message.
+		//
+		ulSlot = WidgetTimer::ulNow & WIDGET_TIMER_SLOT_MASK;
+
+		while((pTimer = WidgetTimer::ppSlots[0][ulSlot]) != 0)
+		{
+			pTimer->Remove();
+
+			if(pTimer->ulPeriod)
+			{
+				pTimer->ulExpiry += pTimer->ulPeriod;
+
+				if((long)(pTimer->ulExpiry - ulTarget) <= 0)
+				{
+					pTimer->ulExpiry = ulTarget + pTimer->ulPeriod;
+				}
+
+				pTimer->Insert();
+			}
+
+			pTimer->pWidget->MessageProc(WIDGET_MSG_TIMER,
+			                             (unsigned long)pTimer, 0);
+		}
+	}
+}
+
+//*****************************************************************************
+//
+//! Gets the number of ticks until the wheel has a slot to process.
+//!
+//! This function looks for the first slot of each level of the timer wheel
+//! that holds a timer, after the current one.  For the first level, this is
+//! the time the timer expires; for the other levels, this is the time the
+//! timers of the slot are filed again into the lower levels, which is no later
+//! than their expiry.  No slot needs to be processed before the earliest of
+//! these times.
+//!
+//! \return Returns the number of ticks from WidgetTimer::ulNow to the next slot
+//! to process, or \b #WIDGET_TIMER_NONE if no timer is running.
+//
+//*****************************************************************************
+unsigned long
+WidgetTimer::NextEventGet(void)
+{
+	unsigned long ulLevel, ulTick, ulIdx, ulNext, ulBest;
+
+	//
+	// Find the earliest slot that holds a timer, over all levels.
+	//
+	ulBest = WIDGET_TIMER_NONE;
+
+	for(ulLevel = 0; ulLevel < WIDGET_TIMER_LEVELS; ulLevel++)
+	{
+		ulTick = (WidgetTimer::ulNow >>
+		          (WIDGET_TIMER_LEVEL_BITS * ulLevel)) + 1;
+
+		for(ulIdx = 0; ulIdx < WIDGET_TIMER_SLOTS; ulIdx++)
+		{
+			if(WidgetTimer::ppSlots[ulLevel]
+			                       [(ulTick + ulIdx) & WIDGET_TIMER_SLOT_MASK])
+			{
+				ulNext = ((ulTick + ulIdx) <<
+				          (WIDGET_TIMER_LEVEL_BITS * ulLevel)) -
+				         WidgetTimer::ulNow;
+
+				if(ulNext < ulBest)
+				{
+					ulBest = ulNext;
+				}
+
+				break;
+			}
+		}
+	}
+
+	return(ulBest);
+}
+
+//*****************************************************************************
+//
+//! Gets the time until the next timer expires.
+//!
+//! This function finds the next slot of the timer wheel to process, as
+//! WidgetTimer::Process() does.  Calling WidgetTimer::Process() at the time
+//! returned is thus never late, and rarely early.
+//!
+//! \return Returns the number of ticks of GrTimerGet() until the next timer
+//! expires, zero if a timer has already expired, or \b #WIDGET_TIMER_NONE if
+//! no timer is running.
+//
+//*****************************************************************************
+unsigned long
+WidgetTimer::NextExpiryGet(void)
+{
+	unsigned long ulBest, ulNow;
+
+	ulBest = WidgetTimer::NextEventGet();
+
+	if(ulBest == WIDGET_TIMER_NONE)
+	{
+		return(WIDGET_TIMER_NONE);
+	}
+
+	//
+	// Make the time relative to the clock, which may be ahead of the wheel.
+	//
+	ulNow = GrTimerGet() - WidgetTimer::ulNow;
+
+	return((ulBest > ulNow) ? (ulBest - ulNow) : 0);
+}
+
+//*****************************************************************************
+//
+//! Destroys a widget timer.
+//!
+//! This function stops the timer before it is destroyed.
+//!
+//! \return None.
+//
+//*****************************************************************************
+WidgetTimer::~WidgetTimer(void)
+{
+	this->Stop();
+}
+
+//*****************************************************************************
+//
+// Close the Doxygen group.
+//! @}
+//
+//*****************************************************************************
@@ -0,0 +1,187 @@
+//*****************************************************************************
+//
+// widgettimer.h - Prototypes for the widget timers.
+//
+//*****************************************************************************
+
+#ifndef __WIDGETTIMER_H__
+#define __WIDGETTIMER_H__
+
+//*****************************************************************************
+//
+//! \addtogroup widget_api
+//! @{
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// If building with a C++ compiler, make all of the definitions in this header
+// have a C binding.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+class Widget;
+
+//*****************************************************************************
+//
+//! The number of levels of the timer wheel, and the number of slots of each
+//! level as a power of two.  A timer due within 2^(WIDGET_TIMER_LEVEL_BITS *
+//! WIDGET_TIMER_LEVELS) ticks is filed directly in its slot; a later timer is
+//! filed in the last slot of the top level, and filed again when it is
+//! reached.
+//
+//*****************************************************************************
+#define WIDGET_TIMER_LEVELS     4
+#define WIDGET_TIMER_LEVEL_BITS 6
+
+//*****************************************************************************
+//
+//! The value returned by WidgetTimer::NextExpiryGet() when no timer is
+//! running.
+//
+//*****************************************************************************
+#define WIDGET_TIMER_NONE       0xffffffff
+
+//*****************************************************************************
+//
+//! This class describes a timer that sends a \b #WIDGET_MSG_TIMER message to a
+//! widget when it expires.
+//!
+//! The timers are kept in a hierarchical timing wheel driven by the
+//! GrTimerGet() clock, so that starting and stopping a timer takes constant
+//! time, and the ticks with no slot to process are skipped at once.  Timers
+//! are run by WidgetTimer::Process(), which is called by
+//! Widget::MessageQueueProcess().
+//
+//*****************************************************************************
+class WidgetTimer
+{
+public:
+	//
+	//! Constructor.
+	//
+	WidgetTimer(void);
+
+	//
+	//! Starts this timer.
+	//
+	void Start(Widget *pWidget, unsigned long ulDelay, unsigned long ulPeriod);
+
+	//
+	//! Stops this timer.
+	//
+	void Stop(void);
+
+	//
+	//! Determines if this timer is running.
+	//
+	long IsRunning(void)
+	{
+		return(this->ppPrev != 0);
+	}
+
+	//
+	//! Gets the widget to which this timer sends its messages.
+	//
+	Widget *WidgetGet(void)
+	{
+		return(this->pWidget);
+	}
+
+	//
+	//! Runs the timers that have expired.
+	//
+	static void Process(void);
+
+	//
+	//! Gets the time until the next timer expires.
+	//
+	static unsigned long NextExpiryGet(void);
+
+	//
+	//! Destructor.
+	//
+	~WidgetTimer(void);
+
+private:
+	//
+	//! Files this timer in the slot of its expiry time.
+	//
+	void Insert(void);
+
+	//
+	//! Removes this timer from its slot.
+	//
+	void Remove(void);
+
+	//
+	//! Gets the number of ticks until the wheel has a slot to process.
+	//
+	static unsigned long NextEventGet(void);
+
+	//
+	//! The next timer in the same slot.
+	//
+	WidgetTimer *pNext;
+
+	//
+	//! The pointer that points to this timer, either the slot or the pNext
+	//! member of the previous timer in the slot, or zero if this timer is
+	//! stopped.
+	//
+	WidgetTimer **ppPrev;
+
+	//
+	//! The widget to which the message is sent.
+	//
+	Widget *pWidget;
+
+	//
+	//! The time at which this timer expires.
+	//
+	unsigned long ulExpiry;
+
+	//
+	//! The time between two expiries, or zero for a one-shot timer.
+	//
+	unsigned long ulPeriod;
+
+	//
+	//! The slots of the timer wheel.
+	//
+	static WidgetTimer *ppSlots[WIDGET_TIMER_LEVELS]
+	                           [1 << WIDGET_TIMER_LEVEL_BITS];
+
+	//
+	//! The time up to which the timers have been run.
+	//
+	static unsigned long ulNow;
+
+	//
+	//! The number of running timers.
+	//
+	static unsigned long ulCount;
+};
+
+//*****************************************************************************
+//
+// Mark the end of the C bindings section for C++ compilers.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+}
+#endif
+
+//*****************************************************************************
+//
+// Close the Doxygen group.
+//! @}
+//
+//*****************************************************************************
+
+#endif // __WIDGETTIMER_H__